@@ -0,0 +1,214 @@
+#ifndef SLMATH_AFFINE_H
+#define SLMATH_AFFINE_H
+
+#include <slm/mat4.h>
+
+SLMATH_BEGIN()
+
+class quat;
+
+/** 
+ * 3x4 affine transform, i.e. 4x4 matrix with implicit bottom row (0,0,0,1).
+ * Stored as three row vectors, so it takes 48 bytes instead of 64 of mat4,
+ * and the rows are multiplied with SIMD like mat4 columns.
+ *
+ * Row i holds row i of the upper 3x4 part of the equivalent mat4, translation in the W-components.
+ * Semantics follow mat4: to make combined transform of A, then B:
+ * AB = B * A;
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup mat_util
+ */
+#ifdef SWIG
+class affine
+#else
+SLMATH_ALIGN16 class affine
+#endif
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of floats. */
+		SIZE = 12,
+	};
+
+	/** Constructs undefined transform. In _DEBUG build the transform is initialized to NaN. */
+	affine();
+
+	/** 
+	 * Constructs diagonal transform without translation. 
+	 * @param d All diagonal elements of the 3x3 part are set to this value.
+	 */
+	explicit affine( float d );
+
+	/**
+	 * Constructs transform from upper 3x4 part of matrix. Bottom row of the matrix should be (0,0,0,1).
+	 */
+	explicit affine( const mat4& m );
+
+	/**
+	 * Constructs rotation from quaternion.
+	 */
+	explicit affine( const quat& q );
+
+	/**
+	 * Constructs rotation followed by translation.
+	 * @param q Rotation quaternion.
+	 * @param t Translation.
+	 */
+	affine( const quat& q, const vec3& t );
+
+	/** 
+	 * Constructs transform from 3 row vectors.
+	 */
+	affine( const vec4& r0, const vec4& r1, const vec4& r2 );
+
+	/** Sets ith row. */
+	void			set( size_t i, const vec4& v );
+
+	/** Returns specified row vector (0-based index). */
+	vec4&			operator[]( size_t i );
+
+	/** Sets translation. */
+	void			set_translation( const vec3& t );
+
+	/** Transform multiplication. */
+	affine&			operator*=( const affine& o );
+
+	/** Returns pointer to the first float. */
+	float*			begin()			{return reinterpret_cast<float*>(m_m128);}
+
+	/** Returns pointer to one beyond the last float. */
+	float*			end()			{return reinterpret_cast<float*>(m_m128)+SIZE;}
+
+#ifndef SWIG
+	/** 128-bit 4-vector storage access. */
+	m128_t*			m128()		{return m_m128;}
+#endif
+
+	/** Returns ith row. */
+	const vec4&		get( size_t i ) const;
+
+	/** Returns ith column of the 3x3 part, i.e. transformed ith axis. */
+	vec3			column( size_t i ) const;
+
+	/** Returns translation. */
+	vec3			translation() const;
+
+	/** Component wise equality. */
+	bool			operator==( const affine& o ) const;
+
+	/** Component wise inequality. */
+	bool			operator!=( const affine& o ) const;
+
+	/** Transform multiplication. */
+	affine			operator*( const affine& o ) const;
+
+	/** Returns specified row vector (0-based index). */
+	const vec4&		operator[]( size_t i ) const;
+
+#ifndef SWIG
+	/** 128-bit 4-vector storage access. */
+	const m128_t*	m128() const	{return m_m128;}
+#endif
+
+	/** Returns const pointer to the first float. */
+	const float*	begin() const	{return reinterpret_cast<const float*>(m_m128);}
+
+	/** Returns const pointer to one beyond the last float. */
+	const float*	end() const		{return reinterpret_cast<const float*>(m_m128)+SIZE;}
+
+private:
+	/** Row vectors. */
+	m128_t			m_m128[3];
+
+	vec4*			v4()			{return reinterpret_cast<vec4*>(m_m128);}
+	const vec4*		v4() const		{return reinterpret_cast<const vec4*>(m_m128);}
+};
+
+/** 
+ * Transform column vector by transform, W-component is transformed as by the equivalent mat4.
+ * @ingroup mat_util
+ */
+vec4	operator*( const affine& a, const vec4& v );
+
+/** 
+ * Transforms point, including translation.
+ * @ingroup mat_util
+ */
+vec3	transform_point( const affine& a, const vec3& p );
+
+/** 
+ * Transforms direction, without translation.
+ * @ingroup mat_util
+ */
+vec3	transform_direction( const affine& a, const vec3& d );
+
+/**
+ * Returns transform as 4x4 matrix.
+ * @ingroup mat_util
+ */
+mat4	to_mat4( const affine& a );
+
+/**
+ * Returns combined transform of a, then m.
+ * @ingroup mat_util
+ */
+mat4	operator*( const mat4& m, const affine& a );
+
+/**
+ * Returns combined transform of m, then a.
+ * @ingroup mat_util
+ */
+mat4	operator*( const affine& a, const mat4& m );
+
+/**
+ * Returns combined transform of rotation q, then a.
+ * @ingroup mat_util
+ */
+affine	operator*( const affine& a, const quat& q );
+
+/**
+ * Returns combined transform of a, then rotation q.
+ * @ingroup mat_util
+ */
+affine	operator*( const quat& q, const affine& a );
+
+/** 
+ * Returns inverse of the transform. Much cheaper than inverse of mat4, since only 3x3 part needs general inverse.
+ * @param a Transform to be inverted. Must not be singular.
+ * @return Inverted transform.
+ * @ingroup mat_util
+ */
+affine	inverse( const affine& a );
+
+/** 
+ * Returns inverse of transform consisting only of rotation and translation, by transposing the rotation.
+ * @param a Transform to be inverted. 3x3 part must be orthonormal.
+ * @return Inverted transform.
+ * @ingroup mat_util
+ */
+affine	inverse_orthonormal( const affine& a );
+
+/**
+ * Returns determinant of the transform.
+ * @ingroup mat_util
+ */
+float	det( const affine& a );
+
+/** 
+ * Returns true if all components of the transform are valid numbers. 
+ * @ingroup mat_util
+ */
+bool	check( const affine& a );
+
+#include <slm/affine.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,79 @@
+inline affine::affine()
+{
+#ifdef _DEBUG
+	const int nan = 0x7F800001;
+	float* p = (float*)&m_m128;
+	for ( size_t i = 0 ; i < SIZE ; ++i ) 
+		p[i] = *(const float*)&nan;
+#endif
+}
+
+inline void affine::set( size_t i, const vec4& v )
+{
+	SLMATH_VEC_ASSERT( i < 3 );
+	v4()[i] = v;
+}
+
+inline const vec4& affine::get( size_t i ) const
+{
+	SLMATH_VEC_ASSERT( i < 3 );
+	return v4()[i];
+}
+
+inline vec4& affine::operator[]( size_t i )
+{
+	SLMATH_VEC_ASSERT( i < 3 );
+	return v4()[i];
+}
+
+inline const vec4& affine::operator[]( size_t i ) const
+{
+	SLMATH_VEC_ASSERT( i < 3 );
+	return v4()[i];
+}
+
+inline void affine::set_translation( const vec3& t )
+{
+	vec4* const r = v4();
+	r[0].w = t.x;
+	r[1].w = t.y;
+	r[2].w = t.z;
+}
+
+inline vec3 affine::column( size_t i ) const
+{
+	SLMATH_VEC_ASSERT( i < 3 );
+	const vec4* const r = v4();
+	return vec3( r[0][i], r[1][i], r[2][i] );
+}
+
+inline vec3 affine::translation() const
+{
+	const vec4* const r = v4();
+	return vec3( r[0].w, r[1].w, r[2].w );
+}
+
+inline vec4 operator*( const affine& a, const vec4& v )
+{
+	SLMATH_VEC_ASSERT( check(a) );
+	SLMATH_VEC_ASSERT( check(v) );
+	return vec4( dot(a[0],v), dot(a[1],v), dot(a[2],v), v.w );
+}
+
+inline vec3 transform_point( const affine& a, const vec3& p )
+{
+	const vec4 v( p, 1.f );
+	return vec3( dot(a[0],v), dot(a[1],v), dot(a[2],v) );
+}
+
+inline vec3 transform_direction( const affine& a, const vec3& d )
+{
+	return vec3( dot(a[0].xyz(),d), dot(a[1].xyz(),d), dot(a[2].xyz(),d) );
+}
+
+inline bool check( const affine& a )
+{
+	return check( a.begin(), affine::SIZE );
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,228 @@
+#ifndef SLMATH_BVH_H
+#define SLMATH_BVH_H
+
+#include <slm/intersect_util.h>
+#include <slm/vector_simd.h>
+
+SLMATH_BEGIN()
+
+/**
+ * \defgroup bvh_util Bounding volume hierarchies for ray queries.
+ * @ingroup slm
+ */
+
+/**
+ * Compressed 4-wide bounding volume hierarchy node.
+ *
+ * Bounds of the four children are stored as 8-bit integers on a grid spanning the bounds of the node itself,
+ * so a node takes 64 bytes, compared to 112 bytes with float bounds.
+ * Quantized bounds are rounded outwards, so they always contain the exact child bounds.
+ *
+ * Child references are encoded to 32-bit integers: 0 is an empty slot,
+ * inner nodes have the lowest bit clear and leaves have it set.
+ * A leaf refers to a single triangle4 block.
+ *
+ * @ingroup bvh_util
+ */
+class bvh_node
+{
+public:
+	enum Constants
+	{
+		/** Number of children per node. */
+		SIZE = 4,
+	};
+
+	/** Minimum coordinates of the node bounds. */
+	float			origin[3];
+	/** Size of a quantization step per axis. */
+	float			scale[3];
+	/** Quantized minimum coordinates of the children, [axis][child]. */
+	unsigned char	qmin[3][SIZE];
+	/** Quantized maximum coordinates of the children, [axis][child]. */
+	unsigned char	qmax[3][SIZE];
+	/** Child references. */
+	unsigned int	child[SIZE];
+
+	/** Returns reference to inner node at specified index. */
+	static unsigned int	make_inner( size_t index )						{SLMATH_VEC_ASSERT(index > 0 && index < 0x80000000u); return unsigned(index) << 1;}
+
+	/** Returns reference to leaf of triangle4 block at specified index. */
+	static unsigned int	make_leaf( size_t block )						{SLMATH_VEC_ASSERT(block < 0x80000000u); return (unsigned(block) << 1) | 1u;}
+
+	/** Returns true if reference is a leaf. */
+	static bool			is_leaf( unsigned int ref )						{return 0 != (ref & 1u);}
+
+	/** Returns index of referenced inner node. */
+	static size_t		inner_index( unsigned int ref )				{return ref >> 1;}
+
+	/** Returns index of the triangle4 block of referenced leaf. */
+	static size_t		leaf_block( unsigned int ref )				{return ref >> 1;}
+
+	/** Returns decompressed minimum coordinates of the child i. */
+	vec3				child_min( size_t i ) const;
+
+	/** Returns decompressed maximum coordinates of the child i. */
+	vec3				child_max( size_t i ) const;
+};
+
+/**
+ * Bounding volume hierarchy of triangles, using compressed 4-wide nodes.
+ * Triangles are stored in leaves as triangle4 blocks, so they are tested four at a time.
+ *
+ * Root node is node 0. The tree is built top-down either with binned surface area heuristic,
+ * or as a linear bvh by splitting triangles sorted by Morton code of their centroids.
+ *
+ * A built hierarchy can be saved to a binary image and later attached from it without copying
+ * or deserialization, e.g. straight from a memory mapped file. The image contains only offsets
+ * and indices, so it doesn't depend on the address it is loaded to.
+ *
+ * @ingroup bvh_util
+ * @see intersect_ray_bvh
+ */
+class bvh
+{
+public:
+	enum Constants
+	{
+		/** Maximum depth of the tree, limits traversal stack size. */
+		MAX_DEPTH = 64,
+		/** Traversal stack size needed for tree of MAX_DEPTH. */
+		STACK_SIZE = MAX_DEPTH*(bvh_node::SIZE-1) + 1,
+	};
+
+	/** Constructs empty hierarchy. */
+	bvh();
+
+	/**
+	 * Rebuilds the hierarchy from a triangle mesh. Triangle indices refer to this mesh.
+	 * @param vertices Vertex positions. Positions are copied, so the array doesn't need to be kept.
+	 * @param indices Three vertex indices per triangle. If 0, every three consecutive vertices form a triangle.
+	 * @param n Number of triangles.
+	 */
+	void				build( const vec3* vertices, const unsigned int* indices, size_t n );
+
+	/**
+	 * Rebuilds the hierarchy from a triangle mesh as a linear bvh. Triangles are sorted by 30-bit Morton code
+	 * of their centroids, and each range is split at the highest bit where the codes differ.
+	 * Much faster to build than build(), but ray queries are typically slower, so suited for meshes which change every frame.
+	 * @param vertices Vertex positions. Positions are copied, so the array doesn't need to be kept.
+	 * @param indices Three vertex indices per triangle. If 0, every three consecutive vertices form a triangle.
+	 * @param n Number of triangles.
+	 */
+	void				build_lbvh( const vec3* vertices, const unsigned int* indices, size_t n );
+
+	/**
+	 * Returns size of the binary image of the hierarchy in bytes.
+	 * @see save_image
+	 */
+	size_t				image_size() const;
+
+	/**
+	 * Writes the hierarchy to a binary image.
+	 * @param image [out] Receives the image. Must have room for image_size() bytes.
+	 * @param size Size of the image buffer in bytes.
+	 * @return Number of bytes written, 0 if the buffer is too small.
+	 */
+	size_t				save_image( void* image, size_t size ) const;
+
+	/**
+	 * Attaches the hierarchy to a binary image written by save_image. Data is used in place,
+	 * so the image must stay valid and unchanged as long as it is used by the hierarchy.
+	 * Image written by a different version of the library or a platform with different
+	 * data layout is rejected, as well as an image whose node references or triangle indices
+	 * are out of range. Checking the nodes is a single linear pass over them.
+	 * @param image The image. Must be aligned to 16 bytes.
+	 * @param size Size of the image in bytes.
+	 * @return true if the image was valid. If false, the hierarchy is left empty.
+	 */
+	bool				load_image( const void* image, size_t size );
+
+	/** Returns nodes. Node 0 is the root. */
+	const bvh_node*		nodes() const				{return m_nodeptr;}
+
+	/** Returns number of nodes. */
+	size_t				node_count() const			{return m_nodecount;}
+
+	/** Returns triangle blocks referenced by leaves. */
+	const triangle4*	blocks() const				{return m_blockptr;}
+
+	/** Returns number of triangle blocks. */
+	size_t				block_count() const			{return m_blockcount;}
+
+	/** Returns original triangle index of each block triangle, so array [4*block_count()]. Unused triangles have index 0xFFFFFFFF. */
+	const unsigned int*	triangle_indices() const	{return m_indexptr;}
+
+	/** Returns number of triangles in the hierarchy. */
+	size_t				size() const				{return m_size;}
+
+	/** Returns minimum coordinates of the bounds of all triangles. */
+	const vec3&			bounds_min() const			{return m_boundsmin;}
+
+	/** Returns maximum coordinates of the bounds of all triangles. */
+	const vec3&			bounds_max() const			{return m_boundsmax;}
+
+private:
+	vector_simd<bvh_node>		m_nodes;
+	vector_simd<triangle4>		m_blocks;
+	vector_simd<unsigned int>	m_indices;
+	size_t						m_size;
+	vec3						m_boundsmin;
+	vec3						m_boundsmax;
+	const bvh_node*				m_nodeptr;
+	size_t						m_nodecount;
+	const triangle4*			m_blockptr;
+	size_t						m_blockcount;
+	const unsigned int*			m_indexptr;
+
+	void				set_owned_data();
+	void				clear_tree( size_t n );
+	template <class T> void	build_tree( const vec3* vertices, const unsigned int* indices, const vec3* trimin, const vec3* trimax, unsigned int* order, const T& split );
+
+	bvh( const bvh& );
+	bvh& operator=( const bvh& );
+};
+
+/**
+ * Intersects ray with the children of a compressed node, four children at a time.
+ * Child bounds are decompressed on the fly.
+ * @param r The ray.
+ * @param node The node.
+ * @param tnear [out] Receives ray parameter where the ray enters each child, clipped to ray tmin. Array [4].
+ * @return Bit mask of the intersected children, bit i set if child i intersects.
+ * @ingroup bvh_util
+ */
+int		intersect_ray_bvh_node( const ray& r, const bvh_node& node, float* tnear );
+
+/**
+ * Intersects ray with triangles of a bounding volume hierarchy.
+ * Children are visited nearest first, skipping the ones entered after the closest hit so far.
+ * With RAY_CLOSEST_HIT finds the closest triangle and clips ray tmax to it.
+ * With RAY_ANY_HIT returns at the first triangle intersecting the ray range.
+ * @param r The ray. tmax is updated in RAY_CLOSEST_HIT mode.
+ * @param mode Query mode.
+ * @param tree The hierarchy.
+ * @param hit [out] Receives hit information, index is original triangle index. Can be 0.
+ * @return true if any triangle intersects.
+ * @ingroup bvh_util
+ */
+bool	intersect_ray_bvh( ray& r, ray_query mode, const bvh& tree, ray_hit* hit );
+
+/**
+ * Finds closest point on triangles of a bounding volume hierarchy to a point.
+ * Branch-and-bound search: children are visited nearest first, skipping the ones
+ * with bounds further away than the closest point found so far.
+ * @param p The point.
+ * @param tree The hierarchy.
+ * @param maxdist Maximum distance of accepted points, inclusive. Smaller distance prunes more of the tree.
+ * @param hit [out] Receives the closest point, index is original triangle index. Can be 0.
+ * @return true if any triangle is within maxdist.
+ * @ingroup bvh_util
+ */
+bool	closest_point_bvh( const vec3& p, const bvh& tree, float maxdist, closest_point_hit* hit );
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,210 @@
+#ifndef SLMATH_DMAT4_H
+#define SLMATH_DMAT4_H
+
+#include <slm/dvec4.h>
+#include <slm/mat4.h>
+
+SLMATH_BEGIN()
+
+class dquat;
+
+/** 
+ * Double precision 4x4 matrix. Columns vectors, column-major ordering. Same API as mat4.
+ * Products use 4-wide double SIMD macros, AVX if SLMATH_AVX is enabled.
+ *
+ * For rendering and physics, keep world transforms in double precision and
+ * convert them to float relative to the camera with camera_relative, so that 
+ * float precision is spent near the viewer instead of near the world origin.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup mat_util
+ */
+class dmat4
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of doubles. */
+		SIZE = 16,
+	};
+
+	/** Constructs undefined matrix. In _DEBUG build the matrix is initialized to NaN. */
+	dmat4();
+
+	/** 
+	 * Constructs diagonal matrix. All diagonal elements specified value, rest 0. 
+	 * @param d All diagonal elements are set to this value.
+	 */
+	explicit dmat4( double d );
+
+	/**
+	 * Constructs matrix from single precision matrix.
+	 */
+	explicit dmat4( const mat4& m );
+
+	/**
+	 * Constructs rotation matrix from quaternion.
+	 */
+	explicit dmat4( const dquat& q );
+
+	/** 
+	 * Constructs matrix from 4 column vectors.
+	 */
+	dmat4( const dvec4& c0, const dvec4& c1, const dvec4& c2, const dvec4& c3 );
+
+	/** Sets ith column. */
+	void			set( size_t i, const dvec4& v );
+
+	/** Returns specified column vector (0-based index). */
+	dvec4&			operator[]( size_t i );
+
+	/** Component wise addition. */
+	dmat4&			operator+=( const dmat4& o );
+
+	/** Component wise subtraction. */
+	dmat4&			operator-=( const dmat4& o );
+
+	/** Component wise scalar multiplication. */
+	dmat4&			operator*=( double s );
+
+	/** Matrix multiplication. */
+	dmat4&			operator*=( const dmat4& o );
+
+	/** Returns pointer to the first double. */
+	double*			begin()			{return &m_cols[0].x;}
+
+	/** Returns pointer to one beyond the last double. */
+	double*			end()			{return &m_cols[0].x+SIZE;}
+
+	/** Returns ith column. */
+	const dvec4&	get( size_t i ) const;
+
+	/** Component wise equality. */
+	bool			operator==( const dmat4& o ) const;
+
+	/** Component wise inequality. */
+	bool			operator!=( const dmat4& o ) const;
+
+	/** Component wise addition. */
+	dmat4			operator+( const dmat4& o ) const;
+
+	/** Component wise subtraction. */
+	dmat4			operator-( const dmat4& o ) const;
+
+	/** Component wise scalar multiplication. */
+	dmat4			operator*( double s ) const;
+
+	/** Matrix multiplication. */
+	dmat4			operator*( const dmat4& o ) const;
+
+	/** Returns specified column vector (0-based index). */
+	const dvec4&	operator[]( size_t i ) const;
+
+	/** Returns const pointer to the first double. */
+	const double*	begin() const	{return &m_cols[0].x;}
+
+	/** Returns const pointer to one beyond the last double. */
+	const double*	end() const		{return &m_cols[0].x+SIZE;}
+
+private:
+	/** Column vectors. */
+	dvec4			m_cols[4];
+};
+
+/** 
+ * Transform column vector by matrix. 
+ * @param v Column vector be multiplied by matrix.
+ * @param m Matrix multiplying column vector.
+ * @ingroup mat_util
+ */
+dvec4	operator*( const dmat4& m, const dvec4& v );
+
+/** 
+ * Transform row vector by matrix. 
+ * @param v Row vector be multiplied by matrix.
+ * @param m Matrix multiplying column vector.
+ * @ingroup mat_util
+ */
+dvec4	operator*( const dvec4& v, const dmat4& m );
+
+/** 
+ * Swaps column and row vectors with each other. 
+ * @param m Matrix to be transposed.
+ * @return Transposed matrix.
+ * @ingroup mat_util
+ */
+dmat4	transpose( const dmat4& m );
+
+/** 
+ * Returns inverse of the matrix.
+ * @param m Matrix to be inverted.
+ * @return Inverted matrix.
+ * @ingroup mat_util
+ */
+dmat4	inverse( const dmat4& m );
+
+/**
+ * Returns determinant of the matrix.
+ * @ingroup mat_util
+ */
+double	det( const dmat4& m );
+
+/** 
+ * Returns true if all components of the matrix are valid numbers. 
+ * @ingroup mat_util
+ */
+bool	check( const dmat4& m );
+
+/**
+ * Returns translation matrix.
+ * @ingroup mat_util
+ */
+dmat4	translation( const dvec3& t );
+
+/**
+ * Returns the matrix rounded to single precision.
+ * @ingroup mat_util
+ */
+mat4	to_mat4( const dmat4& m );
+
+/**
+ * Returns transform relative to camera position in single precision, i.e. translation(-camera) * m.
+ * Translation is subtracted in double precision before rounding, so objects near the camera
+ * keep full float precision however far they are from the world origin.
+ * @param m World transform.
+ * @param camera Camera position in world space.
+ * @return Transform to camera-relative world space.
+ * @ingroup mat_util
+ */
+mat4	camera_relative( const dmat4& m, const dvec3& camera );
+
+/**
+ * Converts array of world transforms to camera-relative single precision transforms.
+ * @param m World transforms.
+ * @param n Number of transforms.
+ * @param camera Camera position in world space.
+ * @param out [out] Receives n transforms.
+ * @ingroup mat_util
+ */
+void	camera_relative( const dmat4* m, size_t n, const dvec3& camera, mat4* out );
+
+/**
+ * Converts array of world positions to camera-relative single precision positions, four points at a time.
+ * @param points World positions.
+ * @param n Number of points.
+ * @param camera Camera position in world space.
+ * @param out [out] Receives n positions.
+ * @ingroup vec_util
+ */
+void	camera_relative( const dvec3* points, size_t n, const dvec3& camera, vec3* out );
+
+#include <slm/dmat4.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
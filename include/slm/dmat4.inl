@@ -0,0 +1,49 @@
+inline dmat4::dmat4()
+{
+}
+
+inline void dmat4::set( size_t i, const dvec4& v )
+{
+	SLMATH_VEC_ASSERT( i < 4 );
+	m_cols[i] = v;
+}
+
+inline const dvec4& dmat4::get( size_t i ) const
+{
+	SLMATH_VEC_ASSERT( i < 4 );
+	return m_cols[i];
+}
+
+inline dvec4& dmat4::operator[]( size_t i )
+{
+	SLMATH_VEC_ASSERT( i < 4 );
+	return m_cols[i];
+}
+
+inline const dvec4& dmat4::operator[]( size_t i ) const
+{
+	SLMATH_VEC_ASSERT( i < 4 );
+	return m_cols[i];
+}
+
+inline dvec4 operator*( const dvec4& v, const dmat4& m )
+{
+	return dvec4( dot(v,m[0]), dot(v,m[1]), dot(v,m[2]), dot(v,m[3]) );
+}
+
+inline dvec4 operator*( const dmat4& m, const dvec4& v )
+{
+	SLMATH_VEC_ASSERT( check(v) );
+	SLMATH_VEC_ASSERT( check(m) );
+	const m256d_t r = SLMATH_ADD_PD( 
+		SLMATH_ADD_PD( SLMATH_MUL_PD(m[0].m256d(),SLMATH_LOAD_PD1(&v.x)), SLMATH_MUL_PD(m[1].m256d(),SLMATH_LOAD_PD1(&v.y)) ),
+		SLMATH_ADD_PD( SLMATH_MUL_PD(m[2].m256d(),SLMATH_LOAD_PD1(&v.z)), SLMATH_MUL_PD(m[3].m256d(),SLMATH_LOAD_PD1(&v.w)) ) );
+	return dvec4( r );
+}
+
+inline bool check( const dmat4& m )
+{
+	return check(m[0]) && check(m[1]) && check(m[2]) && check(m[3]);
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,195 @@
+#ifndef SLMATH_DQUAT_H
+#define SLMATH_DQUAT_H
+
+#include <slm/dmat4.h>
+#include <slm/quat.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Double precision quaternion. Same API as quat.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup quat_util
+ */
+class dquat
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of dimensions in quaternion interepreted as doubles. */
+		SIZE = 4,
+	};
+
+	/** The first component of the quaternion. */
+	double x;
+
+	/** The second component of the quaternion. */
+	double y;
+
+	/** The third component of the quaternion. */
+	double z;
+
+	/** The fourth component of the quaternion. */
+	double w;
+
+	/** Constructs undefined quaternion. In _DEBUG build the quaternion is initialized to NaN. */
+	dquat();
+
+	/** 
+	 * Constructs the quaternion from scalars.
+	 * @param x0 The quaternion X-component (0)
+	 * @param y0 The quaternion Y-component (1)
+	 * @param z0 The quaternion Z-component (2)
+	 * @param w0 The quaternion W-component (3)
+	 */
+	dquat( double x0, double y0, double z0, double w0 );
+
+	/** 
+	 * Constructs the quaternion from angle-axis rotation.
+	 * @param a Angle in radians.
+	 * @param v Rotation axis, unit vector.
+	 */
+	dquat( double a, const dvec3& v );
+
+	/**
+	 * Constructs the quaternion from rotation matrix.
+	 */
+	explicit dquat( const dmat4& m );
+
+	/**
+	 * Constructs the quaternion from single precision quaternion.
+	 */
+	explicit dquat( const quat& q );
+
+	/** Component wise addition. */
+	dquat&		operator+=( const dquat& o );
+	
+	/** Component wise subtraction. */
+	dquat&		operator-=( const dquat& o );
+	
+	/** Component wise scalar multiplication. */
+	dquat&		operator*=( double s );
+	
+	/** Quaternion multiplication. */
+	dquat&		operator*=( const dquat& o );
+
+	/** Returns ith component of the quaternion. */
+	double&		operator[]( size_t i )			{SLMATH_VEC_ASSERT( i < 4 ); return (&x)[i];}
+
+	/** Returns pointer to the first component. */
+	double*		begin()			{return &x;}
+
+	/** Returns pointer to one beyond the last component. */
+	double*		end()			{return &x+SIZE;}
+
+	/** Normalizes this quaternion. */
+	void		normalize();
+
+	/** Quaternion multiplication. */
+	dquat		operator*( const dquat& o ) const;
+
+	/** Component wise addition. */
+	dquat		operator+( const dquat& o ) const;
+
+	/** Component wise subtraction. */
+	dquat		operator-( const dquat& o ) const;
+
+	/** Component wise negation. */
+	dquat		operator-() const;
+
+	/** Component wise scalar multiplication. */
+	dquat		operator*( double s ) const;
+
+	/** Returns ith component of the quaternion. */
+	const double& operator[]( size_t i ) const		{SLMATH_VEC_ASSERT( i < 4 ); return (&x)[i];}
+
+	/** Component wise equality. */
+	bool		operator==( const dquat& o ) const;
+
+	/** Component wise inequality. */
+	bool		operator!=( const dquat& o ) const;
+
+	/** Returns the quaternion as 4-vector. */
+	const dvec4&	xyzw() const	{return *(const dvec4*)&x;}
+
+	/** Returns const pointer to the first component. */
+	const double*	begin() const	{return &x;}
+
+	/** Returns const pointer to one beyond the last component. */
+	const double*	end() const		{return &x+SIZE;}
+};
+
+/** 
+ * Returns true if all components of the quaternion are valid numbers. 
+ * @ingroup quat_util
+ */
+bool		check( const dquat& q );
+
+/** 
+ * Returns dot product of two quaternions. 
+ * @ingroup quat_util
+ */
+double		dot( const dquat& a, const dquat& b );
+
+/** 
+ * Returns squared norm of the quaternion. 
+ * @ingroup quat_util
+ */
+double		norm_squared( const dquat& q );
+
+/** 
+ * Returns norm of the quaternion. 
+ * @ingroup quat_util
+ */
+double		norm( const dquat& q );
+
+/** 
+ * Returns the quaternion scaled to unit length. 
+ * @ingroup quat_util
+ */
+dquat		normalize( const dquat& q );
+
+/** 
+ * Returns conjugate of the quaternion. 
+ * @ingroup quat_util
+ */
+dquat		conjugate( const dquat& q );
+
+/** 
+ * Returns inverse of the quaternion. 
+ * @ingroup quat_util
+ */
+dquat		inverse( const dquat& q );
+
+/** 
+ * Returns spherical linear interpolation between two unit quaternions. 
+ * @param a Quaternion at u=0.
+ * @param b Quaternion at u=1.
+ * @param u Interpolation parameter.
+ * @ingroup quat_util
+ */
+dquat		slerp( const dquat& a, const dquat& b, double u );
+
+/** 
+ * Rotates vector by unit quaternion. 
+ * @ingroup quat_util
+ */
+dvec3		rotate( const dquat& q, const dvec3& v );
+
+/** 
+ * Returns the quaternion rounded to single precision. 
+ * @ingroup quat_util
+ */
+quat		to_quat( const dquat& q );
+
+#include <slm/dquat.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,120 @@
+inline dquat::dquat()
+{
+#ifdef _DEBUG
+	const unsigned long long nan = 0x7FF0000000000001ULL;
+	x = y = z = w = *(const double*)&nan;
+#endif
+}
+
+inline dquat::dquat( double x0, double y0, double z0, double w0 ) : 
+	x(x0), y(y0), z(z0), w(w0)
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline dquat::dquat( const quat& q ) : 
+	x(q.x), y(q.y), z(q.z), w(q.w)
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline dquat& dquat::operator+=( const dquat& o )
+{
+	x += o.x;
+	y += o.y;
+	z += o.z;
+	w += o.w;
+	return *this;
+}
+
+inline dquat& dquat::operator-=( const dquat& o )
+{
+	x -= o.x;
+	y -= o.y;
+	z -= o.z;
+	w -= o.w;
+	return *this;
+}
+
+inline dquat& dquat::operator*=( double s )
+{
+	x *= s;
+	y *= s;
+	z *= s;
+	w *= s;
+	return *this;
+}
+
+inline dquat& dquat::operator*=( const dquat& o )
+{
+	*this = *this * o;
+	return *this;
+}
+
+inline dquat dquat::operator+( const dquat& o ) const
+{
+	return dquat( x+o.x, y+o.y, z+o.z, w+o.w );
+}
+
+inline dquat dquat::operator-( const dquat& o ) const
+{
+	return dquat( x-o.x, y-o.y, z-o.z, w-o.w );
+}
+
+inline dquat dquat::operator-() const
+{
+	return dquat( -x, -y, -z, -w );
+}
+
+inline dquat dquat::operator*( double s ) const
+{
+	return dquat( x*s, y*s, z*s, w*s );
+}
+
+inline bool dquat::operator==( const dquat& o ) const
+{
+	return x==o.x && y==o.y && z==o.z && w==o.w;
+}
+
+inline bool dquat::operator!=( const dquat& o ) const
+{
+	return !(*this == o);
+}
+
+inline bool check( const dquat& q )
+{
+	return check(q.x) && check(q.y) && check(q.z) && check(q.w);
+}
+
+inline double dot( const dquat& a, const dquat& b )
+{
+	return a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w;
+}
+
+inline double norm_squared( const dquat& q )
+{
+	return dot( q, q );
+}
+
+inline double norm( const dquat& q )
+{
+	return sqrt( dot(q,q) );
+}
+
+inline dquat conjugate( const dquat& q )
+{
+	return dquat( -q.x, -q.y, -q.z, q.w );
+}
+
+inline dvec3 rotate( const dquat& q, const dvec3& v )
+{
+	const dvec3 qv( q.x, q.y, q.z );
+	return v + cross( qv, cross(qv,v) + v*q.w ) * 2.0;
+}
+
+inline quat to_quat( const dquat& q )
+{
+	return quat( float(q.x), float(q.y), float(q.z), float(q.w) );
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,171 @@
+#ifndef SLMATH_DUALQUAT_H
+#define SLMATH_DUALQUAT_H
+
+#include <slm/quat.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Dual quaternion, rigid transform made of rotation and translation.
+ * Used for skinning: 8 floats per bone instead of 16 of mat4, and blended bone transforms
+ * stay rigid, so joints don't collapse like with linear blending of matrices.
+ *
+ * Semantics follow quat and mat4: to make combined transform of A, then B:
+ * AB = B * A;
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup quat_util
+ */
+class dualquat
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of floats. */
+		SIZE = 8,
+	};
+
+	/** Real part, rotation. */
+	quat	real;
+
+	/** Dual part, translation multiplied by rotation and 1/2. */
+	quat	dual;
+
+	/** Constructs undefined dual quaternion. In _DEBUG build the quaternion is initialized to NaN. */
+	dualquat();
+
+	/** 
+	 * Constructs dual quaternion from real and dual parts.
+	 * @param r Real part.
+	 * @param d Dual part.
+	 */
+	dualquat( const quat& r, const quat& d );
+
+	/** 
+	 * Constructs rotation followed by translation.
+	 * @param q Rotation quaternion. Must be unit length.
+	 * @param t Translation.
+	 */
+	dualquat( const quat& q, const vec3& t );
+
+	/**
+	 * Constructs dual quaternion from rigid transform matrix, i.e. rotation and translation only.
+	 */
+	explicit dualquat( const mat4& m );
+
+	/** Component wise addition. */
+	dualquat&	operator+=( const dualquat& o );
+
+	/** Component wise scalar multiplication. */
+	dualquat&	operator*=( float s );
+
+	/** Transform multiplication. */
+	dualquat&	operator*=( const dualquat& o );
+
+	/** Returns pointer to the first float. */
+	float*		begin()			{return &real.x;}
+
+	/** Returns pointer to one beyond the last float. */
+	float*		end()			{return &real.x+SIZE;}
+
+	/** Transform multiplication. */
+	dualquat	operator*( const dualquat& o ) const;
+
+	/** Component wise addition. */
+	dualquat	operator+( const dualquat& o ) const;
+
+	/** Component wise scalar multiplication. */
+	dualquat	operator*( float s ) const;
+
+	/** Component wise equality. */
+	bool		operator==( const dualquat& o ) const;
+
+	/** Component wise inequality. */
+	bool		operator!=( const dualquat& o ) const;
+
+	/** Returns const pointer to the first float. */
+	const float*	begin() const	{return &real.x;}
+
+	/** Returns const pointer to one beyond the last float. */
+	const float*	end() const		{return &real.x+SIZE;}
+};
+
+/** 
+ * Returns true if all components of the dual quaternion are valid numbers. 
+ * @ingroup quat_util
+ */
+bool		check( const dualquat& q );
+
+/** 
+ * Returns dual quaternion divided by the length of its real part. 
+ * Blended transforms need to be normalized before use.
+ * @ingroup quat_util
+ */
+dualquat	normalize( const dualquat& q );
+
+/** 
+ * Returns inverse transform of unit dual quaternion. 
+ * @ingroup quat_util
+ */
+dualquat	inverse( const dualquat& q );
+
+/** 
+ * Returns translation of unit dual quaternion. 
+ * @ingroup quat_util
+ */
+vec3		translation( const dualquat& q );
+
+/** 
+ * Returns rigid transform matrix of unit dual quaternion. 
+ * @ingroup quat_util
+ */
+mat4		to_mat4( const dualquat& q );
+
+/** 
+ * Transforms point by unit dual quaternion. 
+ * @ingroup quat_util
+ */
+vec3		transform_point( const dualquat& q, const vec3& p );
+
+/** 
+ * Transforms direction by unit dual quaternion, i.e. rotates it only. 
+ * @ingroup quat_util
+ */
+vec3		transform_direction( const dualquat& q, const vec3& v );
+
+/**
+ * Blends dual quaternions linearly (DLB) and normalizes the result.
+ * Quaternions in opposite hemisphere from the first one are negated, so the blend takes the shortest path.
+ * @param q Dual quaternions to blend. Must be unit length.
+ * @param weights Blend weights.
+ * @param n Number of dual quaternions, at least 1.
+ * @return Normalized blend.
+ * @ingroup quat_util
+ */
+dualquat	blend( const dualquat* q, const float* weights, size_t n );
+
+/**
+ * Skins vertices with dual quaternion bone palette, 4 bone influences per vertex.
+ * Bone transforms are blended with SIMD and the blend is normalized once per vertex.
+ * @param bones Bone palette, unit dual quaternions from bind pose to current pose.
+ * @param positions Bind pose vertex positions.
+ * @param normals Bind pose vertex normals. Can be 0.
+ * @param boneindices Bone indices of vertex i in boneindices[i*4..i*4+3].
+ * @param weights Bone weights of vertex i in weights[i*4..i*4+3]. Unused influences have weight 0.
+ * @param n Number of vertices.
+ * @param outpositions [out] Receives skinned positions.
+ * @param outnormals [out] Receives skinned normals. Can be 0 if normals is 0.
+ * @ingroup quat_util
+ */
+void		skin_vertices( const dualquat* bones, const vec3* positions, const vec3* normals, const unsigned int* boneindices, const float* weights, size_t n, vec3* outpositions, vec3* outnormals );
+
+#include <slm/dualquat.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,71 @@
+inline dualquat::dualquat()
+{
+}
+
+inline dualquat::dualquat( const quat& r, const quat& d ) :
+	real(r), dual(d)
+{
+}
+
+inline dualquat& dualquat::operator+=( const dualquat& o )
+{
+	real += o.real;
+	dual += o.dual;
+	return *this;
+}
+
+inline dualquat& dualquat::operator*=( float s )
+{
+	real *= s;
+	dual *= s;
+	return *this;
+}
+
+inline dualquat& dualquat::operator*=( const dualquat& o )
+{
+	*this = *this * o;
+	return *this;
+}
+
+inline dualquat dualquat::operator*( const dualquat& o ) const
+{
+	return dualquat( real*o.real, real*o.dual + dual*o.real );
+}
+
+inline dualquat dualquat::operator+( const dualquat& o ) const
+{
+	return dualquat( real+o.real, dual+o.dual );
+}
+
+inline dualquat dualquat::operator*( float s ) const
+{
+	return dualquat( real*s, dual*s );
+}
+
+inline bool dualquat::operator==( const dualquat& o ) const
+{
+	return real == o.real && dual == o.dual;
+}
+
+inline bool dualquat::operator!=( const dualquat& o ) const
+{
+	return !(*this == o);
+}
+
+inline bool check( const dualquat& q )
+{
+	return check( q.begin(), dualquat::SIZE );
+}
+
+inline dualquat inverse( const dualquat& q )
+{
+	return dualquat( conjugate(q.real), conjugate(q.dual) );
+}
+
+inline vec3 translation( const dualquat& q )
+{
+	const quat t = q.dual * conjugate(q.real);
+	return vec3( t.x, t.y, t.z ) * 2.f;
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,205 @@
+#ifndef SLMATH_DVEC3_H
+#define SLMATH_DVEC3_H
+
+#include <slm/vec3.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Double precision 3-vector, for positions in large worlds where float loses precision.
+ * Same API as vec3. Convert to float with to_vec3, or relative to camera with camera_relative.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup vec_util
+ */
+class dvec3
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of dimensions in this vector. */
+		SIZE = 3,
+	};
+
+	/** The first component of the vector. */
+	double x;
+
+	/** The second component of the vector. */
+	double y;
+
+	/** The third component of the vector. */
+	double z;
+
+	/** 
+	 * Constructs undefined 3-vector. In _DEBUG build the vector is initialized to NaN.
+	 */
+	dvec3();
+
+	/** 
+	 * Constructs vector with all components set to the same value.
+	 * @param v Each of the vector components will be set to this value.
+	 */
+	explicit dvec3( double v );
+
+	/** 
+	 * Constructs the vector from scalars. 
+	 * @param x0 The vector X-component (0)
+	 * @param y0 The vector Y-component (1)
+	 * @param z0 The vector Z-component (2)
+	 */
+	dvec3( double x0, double y0, double z0 );
+
+	/** 
+	 * Constructs the vector from single precision vector. 
+	 */
+	explicit dvec3( const vec3& v );
+
+	/** Sets vector value. */
+	void		set( double x0, double y0, double z0 );
+
+	/** Component wise addition. */
+	dvec3&		operator+=( const dvec3& o );
+
+	/** Component wise subtraction. */
+	dvec3&		operator-=( const dvec3& o );
+
+	/** Component wise scalar multiplication. */
+	dvec3&		operator*=( double s );
+
+	/** Component wise scalar division. */
+	dvec3&		operator/=( double s );
+
+	/** Component wise multiplication. */
+	dvec3&		operator*=( const dvec3& o );
+
+	/** Returns ith component of the vector. */
+	double&		operator[]( size_t i )			{SLMATH_VEC_ASSERT( i < 3 ); return (&x)[i];}
+
+	/** Returns pointer to the first component. */
+	double*		begin()			{return &x;}
+
+	/** Returns pointer to one beyond the last component. */
+	double*		end()			{return &x+SIZE;}
+
+	/** Normalizes this vector. */
+	void		normalize();
+
+	/** Component wise multiplication. */
+	dvec3		operator*( const dvec3& o ) const;
+
+	/** Component wise division. */
+	dvec3		operator/( const dvec3& o ) const;
+
+	/** Component wise addition. */
+	dvec3		operator+( const dvec3& o ) const;
+
+	/** Component wise subtraction. */
+	dvec3		operator-( const dvec3& o ) const;
+
+	/** Component wise negation. */
+	dvec3		operator-() const;
+
+	/** Component wise scalar multiplication. */
+	dvec3		operator*( double s ) const;
+
+	/** Component wise scalar division. */
+	dvec3		operator/( double s ) const;
+
+	/** Returns ith component of the vector. */
+	const double& operator[]( size_t i ) const			{SLMATH_VEC_ASSERT( i < 3 ); return (&x)[i];}
+
+	/** Component wise equality. */
+	bool		operator==( const dvec3& o ) const;
+
+	/** Component wise inequality. */
+	bool		operator!=( const dvec3& o ) const;
+
+	/** Returns const pointer to the first component. */
+	const double*	begin() const	{return &x;}
+
+	/** Returns const pointer to one beyond the last component. */
+	const double*	end() const		{return &x+SIZE;}
+};
+
+/** 
+ * Returns cross product of two vectors.
+ * @ingroup vec_util
+ */
+dvec3	cross( const dvec3& a, const dvec3& b );
+
+/** 
+ * Component wise scalar multiplication.
+ * @ingroup vec_util
+ */
+dvec3	operator*( double s, const dvec3& v );
+
+/** 
+ * Returns length of the vector.
+ * @ingroup vec_util
+ */
+double	length( const dvec3& v );
+
+/** 
+ * Returns dot product of two vectors.
+ * @ingroup vec_util
+ */
+double	dot( const dvec3& a, const dvec3& b );
+
+/** 
+ * Returns the vector scaled to unit length.
+ * @ingroup vec_util
+ */
+dvec3	normalize( const dvec3& v );
+
+/** 
+ * Returns component wise maximum of two vectors.
+ * @ingroup vec_util
+ */
+dvec3	max( const dvec3& a, const dvec3& b );
+
+/** 
+ * Returns component wise minimum of two vectors.
+ * @ingroup vec_util
+ */
+dvec3	min( const dvec3& a, const dvec3& b );
+
+/** 
+ * Returns component wise absolute value of the vector.
+ * @ingroup vec_util
+ */
+dvec3	abs( const dvec3& v );
+
+/** 
+ * Returns linear blend between two vectors. Formula is x*(1-a)+y*a.
+ * @ingroup vec_util
+ */
+dvec3	mix( const dvec3& x, const dvec3& y, double a );
+
+/** 
+ * Returns distance between two points.
+ * @ingroup vec_util
+ */
+double	distance( const dvec3& p0, const dvec3& p1 );
+
+/** 
+ * Returns true if all components of the vector are valid numbers.
+ * @ingroup vec_util
+ */
+bool	check( const dvec3& v );
+
+/** 
+ * Returns the vector rounded to single precision.
+ * @ingroup vec_util
+ */
+vec3	to_vec3( const dvec3& v );
+
+#include <slm/dvec3.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
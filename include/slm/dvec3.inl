@@ -0,0 +1,196 @@
+inline dvec3::dvec3()
+{
+#ifdef _DEBUG
+	const unsigned long long nan = 0x7FF0000000000001ULL;
+	x = y = z = *(const double*)&nan;
+#endif
+}
+
+inline dvec3::dvec3( double v ) :
+	x(v), y(v), z(v)
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline dvec3::dvec3( double x0, double y0, double z0 ) :
+	x(x0), y(y0), z(z0)
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline dvec3::dvec3( const vec3& v ) :
+	x(v.x), y(v.y), z(v.z)
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline void dvec3::set( double x0, double y0, double z0 )
+{
+	x = x0;
+	y = y0;
+	z = z0;
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline dvec3& dvec3::operator+=( const dvec3& o )
+{
+	x += o.x;
+	y += o.y;
+	z += o.z;
+	SLMATH_VEC_ASSERT( check(*this) );
+	return *this;
+}
+
+inline dvec3& dvec3::operator-=( const dvec3& o )
+{
+	x -= o.x;
+	y -= o.y;
+	z -= o.z;
+	SLMATH_VEC_ASSERT( check(*this) );
+	return *this;
+}
+
+inline dvec3& dvec3::operator*=( double s )
+{
+	x *= s;
+	y *= s;
+	z *= s;
+	SLMATH_VEC_ASSERT( check(*this) );
+	return *this;
+}
+
+inline dvec3& dvec3::operator/=( double s )
+{
+	SLMATH_VEC_ASSERT( fabs(s) >= DBL_MIN ); // s must be != 0
+	return *this *= 1.0/s;
+}
+
+inline dvec3& dvec3::operator*=( const dvec3& o )
+{
+	x *= o.x;
+	y *= o.y;
+	z *= o.z;
+	SLMATH_VEC_ASSERT( check(*this) );
+	return *this;
+}
+
+inline void dvec3::normalize()
+{
+	const double len = length( *this );
+	SLMATH_VEC_ASSERT( len >= DBL_MIN );
+	*this *= 1.0/len;
+}
+
+inline dvec3 dvec3::operator*( const dvec3& o ) const
+{
+	return dvec3( x*o.x, y*o.y, z*o.z );
+}
+
+inline dvec3 dvec3::operator/( const dvec3& o ) const
+{
+	SLMATH_VEC_ASSERT( fabs(o.x) > DBL_MIN && fabs(o.y) > DBL_MIN && fabs(o.z) > DBL_MIN );
+	return dvec3( x/o.x, y/o.y, z/o.z );
+}
+
+inline dvec3 dvec3::operator+( const dvec3& o ) const
+{
+	return dvec3( x+o.x, y+o.y, z+o.z );
+}
+
+inline dvec3 dvec3::operator-( const dvec3& o ) const
+{
+	return dvec3( x-o.x, y-o.y, z-o.z );
+}
+
+inline dvec3 dvec3::operator-() const
+{
+	return dvec3( -x, -y, -z );
+}
+
+inline dvec3 dvec3::operator*( double s ) const
+{
+	return dvec3( x*s, y*s, z*s );
+}
+
+inline dvec3 dvec3::operator/( double s ) const
+{
+	SLMATH_VEC_ASSERT( fabs(s) >= DBL_MIN ); // s must be != 0
+	const double sinv = 1.0/s;
+	return dvec3( x*sinv, y*sinv, z*sinv );
+}
+
+inline bool dvec3::operator==( const dvec3& o ) const
+{
+	return x==o.x && y==o.y && z==o.z;
+}
+
+inline bool dvec3::operator!=( const dvec3& o ) const
+{
+	return !(*this == o);
+}
+
+inline dvec3 cross( const dvec3& a, const dvec3& b )
+{
+	return dvec3( a.y*b.z-a.z*b.y, a.z*b.x-a.x*b.z, a.x*b.y-a.y*b.x );
+}
+
+inline dvec3 operator*( double s, const dvec3& v )
+{
+	return v*s;
+}
+
+inline double length( const dvec3& v )
+{
+	return sqrt( dot(v,v) );
+}
+
+inline double dot( const dvec3& a, const dvec3& b )
+{
+	SLMATH_VEC_ASSERT( check(a) );
+	SLMATH_VEC_ASSERT( check(b) );
+	return a.x*b.x + a.y*b.y + a.z*b.z;
+}
+
+inline dvec3 normalize( const dvec3& v )
+{
+	const double len = length( v );
+	SLMATH_VEC_ASSERT( len >= DBL_MIN );
+	return v * (1.0/len);
+}
+
+inline dvec3 max( const dvec3& a, const dvec3& b )
+{
+	return dvec3( a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z );
+}
+
+inline dvec3 min( const dvec3& a, const dvec3& b )
+{
+	return dvec3( a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z );
+}
+
+inline dvec3 abs( const dvec3& v )
+{
+	return dvec3( fabs(v.x), fabs(v.y), fabs(v.z) );
+}
+
+inline dvec3 mix( const dvec3& x, const dvec3& y, double a )
+{
+	return x*(1.0-a) + y*a;
+}
+
+inline double distance( const dvec3& p0, const dvec3& p1 )
+{
+	return length( p0 - p1 );
+}
+
+inline bool check( const dvec3& v )
+{
+	return check(v.x) && check(v.y) && check(v.z);
+}
+
+inline vec3 to_vec3( const dvec3& v )
+{
+	return vec3( float(v.x), float(v.y), float(v.z) );
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,212 @@
+#ifndef SLMATH_DVEC4_H
+#define SLMATH_DVEC4_H
+
+#include <slm/dvec3.h>
+#include <slm/vec4.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Double precision 4-vector. Same API as vec4.
+ * Arithmetic uses 4-wide double SIMD macros, AVX if SLMATH_AVX is enabled.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup vec_util
+ */
+class dvec4
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of dimensions in this vector. */
+		SIZE = 4,
+	};
+
+	/** The first component of the vector. */
+	double x;
+
+	/** The second component of the vector. */
+	double y;
+
+	/** The third component of the vector. */
+	double z;
+
+	/** The fourth component of the vector. */
+	double w;
+
+	/** 
+	 * Constructs undefined 4-vector. In _DEBUG build the vector is initialized to NaN.
+	 */
+	dvec4();
+
+	/** 
+	 * Constructs vector with all components set to the same value.
+	 * @param v Each of the vector components will be set to this value.
+	 */
+	explicit dvec4( double v );
+
+	/** 
+	 * Constructs the vector from scalars. 
+	 * @param x0 The vector X-component (0)
+	 * @param y0 The vector Y-component (1)
+	 * @param z0 The vector Z-component (2)
+	 * @param w0 The vector W-component (3)
+	 */
+	dvec4( double x0, double y0, double z0, double w0 );
+
+	/** 
+	 * Constructs the vector from 3-vector and scalar. 
+	 * @param v0 The vector XYZ-components (0-2)
+	 * @param w0 The vector W-component (3)
+	 */
+	dvec4( const dvec3& v0, double w0 );
+
+	/** 
+	 * Constructs the vector from single precision vector. 
+	 */
+	explicit dvec4( const vec4& v );
+
+#ifndef SWIG
+	/** Constructs the vector from 256-bit 4-vector. */
+	dvec4( const m256d_t& xyzw )	{SLMATH_STOREU_PD(&x,xyzw);}
+#endif
+
+	/** Sets vector value. */
+	void		set( double x0, double y0, double z0, double w0 );
+
+	/** Component wise addition. */
+	dvec4&		operator+=( const dvec4& o );
+
+	/** Component wise subtraction. */
+	dvec4&		operator-=( const dvec4& o );
+
+	/** Component wise scalar multiplication. */
+	dvec4&		operator*=( double s );
+
+	/** Component wise scalar division. */
+	dvec4&		operator/=( double s );
+
+	/** Component wise multiplication. */
+	dvec4&		operator*=( const dvec4& o );
+
+	/** Returns ith component of the vector. */
+	double&		operator[]( size_t i )				{SLMATH_VEC_ASSERT( i < 4 ); return (&x)[i];}
+
+	/** Returns XYZ-components as 3-vector. */
+	dvec3&		xyz()			{return *(dvec3*)&x;}
+
+	/** Returns pointer to the first component. */
+	double*		begin()			{return &x;}
+
+	/** Returns pointer to one beyond the last component. */
+	double*		end()			{return &x+SIZE;}
+
+	/** Normalizes this vector. */
+	void		normalize();
+
+#ifndef SWIG
+	/** Returns the vector as 256-bit 4-vector. */
+	m256d_t		m256d() const	{return SLMATH_LOADU_PD(&x);}
+#endif
+
+	/** Component wise multiplication. */
+	dvec4		operator*( const dvec4& o ) const;
+
+	/** Component wise addition. */
+	dvec4		operator+( const dvec4& o ) const;
+
+	/** Component wise subtraction. */
+	dvec4		operator-( const dvec4& o ) const;
+
+	/** Component wise negation. */
+	dvec4		operator-() const;
+
+	/** Component wise scalar multiplication. */
+	dvec4		operator*( double s ) const;
+
+	/** Component wise scalar division. */
+	dvec4		operator/( double s ) const;
+
+	/** Returns ith component of the vector. */
+	const double& operator[]( size_t i ) const			{SLMATH_VEC_ASSERT( i < 4 ); return (&x)[i];}
+
+	/** Component wise equality. */
+	bool		operator==( const dvec4& o ) const;
+
+	/** Component wise inequality. */
+	bool		operator!=( const dvec4& o ) const;
+
+	/** Returns XYZ-components as 3-vector. */
+	const dvec3&	xyz() const		{return *(const dvec3*)&x;}
+
+	/** Returns const pointer to the first component. */
+	const double*	begin() const	{return &x;}
+
+	/** Returns const pointer to one beyond the last component. */
+	const double*	end() const		{return &x+SIZE;}
+};
+
+/** 
+ * Component wise scalar multiplication.
+ * @ingroup vec_util
+ */
+dvec4	operator*( double s, const dvec4& v );
+
+/** 
+ * Returns length of the vector.
+ * @ingroup vec_util
+ */
+double	length( const dvec4& v );
+
+/** 
+ * Returns dot product of two vectors.
+ * @ingroup vec_util
+ */
+double	dot( const dvec4& a, const dvec4& b );
+
+/** 
+ * Returns the vector scaled to unit length.
+ * @ingroup vec_util
+ */
+dvec4	normalize( const dvec4& v );
+
+/** 
+ * Returns component wise maximum of two vectors.
+ * @ingroup vec_util
+ */
+dvec4	max( const dvec4& a, const dvec4& b );
+
+/** 
+ * Returns component wise minimum of two vectors.
+ * @ingroup vec_util
+ */
+dvec4	min( const dvec4& a, const dvec4& b );
+
+/** 
+ * Returns linear blend between two vectors. Formula is x*(1-a)+y*a.
+ * @ingroup vec_util
+ */
+dvec4	mix( const dvec4& x, const dvec4& y, double a );
+
+/** 
+ * Returns true if all components of the vector are valid numbers.
+ * @ingroup vec_util
+ */
+bool	check( const dvec4& v );
+
+/** 
+ * Returns the vector rounded to single precision.
+ * @ingroup vec_util
+ */
+vec4	to_vec4( const dvec4& v );
+
+#include <slm/dvec4.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
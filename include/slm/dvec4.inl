@@ -0,0 +1,173 @@
+inline dvec4::dvec4()
+{
+#ifdef _DEBUG
+	const unsigned long long nan = 0x7FF0000000000001ULL;
+	x = y = z = w = *(const double*)&nan;
+#endif
+}
+
+inline dvec4::dvec4( double v ) :
+	x(v), y(v), z(v), w(v)
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline dvec4::dvec4( double x0, double y0, double z0, double w0 ) :
+	x(x0), y(y0), z(z0), w(w0)
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline dvec4::dvec4( const dvec3& v0, double w0 ) :
+	x(v0.x), y(v0.y), z(v0.z), w(w0)
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline dvec4::dvec4( const vec4& v ) :
+	x(v.x), y(v.y), z(v.z), w(v.w)
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline void dvec4::set( double x0, double y0, double z0, double w0 )
+{
+	x = x0;
+	y = y0;
+	z = z0;
+	w = w0;
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+inline dvec4& dvec4::operator+=( const dvec4& o )
+{
+	SLMATH_STOREU_PD( &x, SLMATH_ADD_PD(m256d(),o.m256d()) );
+	SLMATH_VEC_ASSERT( check(*this) );
+	return *this;
+}
+
+inline dvec4& dvec4::operator-=( const dvec4& o )
+{
+	SLMATH_STOREU_PD( &x, SLMATH_SUB_PD(m256d(),o.m256d()) );
+	SLMATH_VEC_ASSERT( check(*this) );
+	return *this;
+}
+
+inline dvec4& dvec4::operator*=( double s )
+{
+	SLMATH_STOREU_PD( &x, SLMATH_MUL_PD(m256d(),SLMATH_LOAD_PD1(&s)) );
+	SLMATH_VEC_ASSERT( check(*this) );
+	return *this;
+}
+
+inline dvec4& dvec4::operator/=( double s )
+{
+	SLMATH_VEC_ASSERT( fabs(s) >= DBL_MIN ); // s must be != 0
+	return *this *= 1.0/s;
+}
+
+inline dvec4& dvec4::operator*=( const dvec4& o )
+{
+	SLMATH_STOREU_PD( &x, SLMATH_MUL_PD(m256d(),o.m256d()) );
+	SLMATH_VEC_ASSERT( check(*this) );
+	return *this;
+}
+
+inline void dvec4::normalize()
+{
+	const double len = length( *this );
+	SLMATH_VEC_ASSERT( len >= DBL_MIN );
+	*this *= 1.0/len;
+}
+
+inline dvec4 dvec4::operator*( const dvec4& o ) const
+{
+	return dvec4( SLMATH_MUL_PD(m256d(),o.m256d()) );
+}
+
+inline dvec4 dvec4::operator+( const dvec4& o ) const
+{
+	return dvec4( SLMATH_ADD_PD(m256d(),o.m256d()) );
+}
+
+inline dvec4 dvec4::operator-( const dvec4& o ) const
+{
+	return dvec4( SLMATH_SUB_PD(m256d(),o.m256d()) );
+}
+
+inline dvec4 dvec4::operator-() const
+{
+	return dvec4( SLMATH_SUB_PD(SLMATH_SETZERO_PD(),m256d()) );
+}
+
+inline dvec4 dvec4::operator*( double s ) const
+{
+	return dvec4( SLMATH_MUL_PD(m256d(),SLMATH_LOAD_PD1(&s)) );
+}
+
+inline dvec4 dvec4::operator/( double s ) const
+{
+	SLMATH_VEC_ASSERT( fabs(s) >= DBL_MIN ); // s must be != 0
+	return *this * (1.0/s);
+}
+
+inline bool dvec4::operator==( const dvec4& o ) const
+{
+	return x==o.x && y==o.y && z==o.z && w==o.w;
+}
+
+inline bool dvec4::operator!=( const dvec4& o ) const
+{
+	return !(*this == o);
+}
+
+inline dvec4 operator*( double s, const dvec4& v )
+{
+	return v*s;
+}
+
+inline double length( const dvec4& v )
+{
+	return sqrt( dot(v,v) );
+}
+
+inline double dot( const dvec4& a, const dvec4& b )
+{
+	SLMATH_VEC_ASSERT( check(a) );
+	SLMATH_VEC_ASSERT( check(b) );
+	return a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w;
+}
+
+inline dvec4 normalize( const dvec4& v )
+{
+	const double len = length( v );
+	SLMATH_VEC_ASSERT( len >= DBL_MIN );
+	return v * (1.0/len);
+}
+
+inline dvec4 max( const dvec4& a, const dvec4& b )
+{
+	return dvec4( a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z, a.w > b.w ? a.w : b.w );
+}
+
+inline dvec4 min( const dvec4& a, const dvec4& b )
+{
+	return dvec4( a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z, a.w < b.w ? a.w : b.w );
+}
+
+inline dvec4 mix( const dvec4& x, const dvec4& y, double a )
+{
+	return x*(1.0-a) + y*a;
+}
+
+inline bool check( const dvec4& v )
+{
+	return check(v.x) && check(v.y) && check(v.z) && check(v.w);
+}
+
+inline vec4 to_vec4( const dvec4& v )
+{
+	return vec4( SLMATH_CVTPD_PS(v.m256d()) );
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
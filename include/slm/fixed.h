@@ -0,0 +1,182 @@
+#ifndef SLMATH_FIXED_H
+#define SLMATH_FIXED_H
+
+#include <slm/slmath_pp.h>
+
+SLMATH_BEGIN()
+
+/**
+ * \defgroup fixed_util Deterministic fixed point math.
+ * @ingroup slm
+ */
+
+/**
+ * Signed 16.16 fixed point number, for lockstep simulations which need bit identical results on every machine.
+ * All operations are integer only, so results don't depend on compiler, floating point settings or instruction set.
+ * Range is -32768 to 32768 with precision 1/65536. Products are rounded to nearest, quotients towards zero.
+ *
+ * Fixed point types are meant for simulation state; convert to float with to_float, to_vec3, etc. for rendering.
+ * Conversions from float are deterministic only if the floats are, so initial state should come from integers or raw values.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup fixed_util
+ */
+class fixed
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of fraction bits. */
+		FRACTION_BITS = 16,
+		/** Raw value of 1. */
+		ONE = 1<<FRACTION_BITS,
+		/** Raw value of pi. */
+		PI = 205887,
+		/** Raw value of pi/2. */
+		HALF_PI = 102944,
+		/** Raw value of 2pi. */
+		TWO_PI = 411775,
+	};
+
+	/** Raw value, number multiplied by 2^16. */
+	int raw;
+
+	/** Constructs undefined number. */
+	fixed()																	{}
+
+	/** 
+	 * Constructs number from integer.
+	 * @param i Integer in range -32768..32767.
+	 */
+	explicit fixed( int i );
+
+	/** 
+	 * Constructs number from float, rounded to nearest.
+	 * @param f Float in range -32768..32767.
+	 */
+	explicit fixed( float f );
+
+	/** 
+	 * Constructs number from double, rounded to nearest.
+	 * @param f Double in range -32768..32767.
+	 */
+	explicit fixed( double f );
+
+	/** Returns number with specified raw value. */
+	static fixed	from_raw( int raw );
+
+	/** 
+	 * Returns number from 64-bit value with 32 fraction bits, rounded to nearest.
+	 * Sums of raw products can be rounded once with this instead of rounding each product.
+	 */
+	static fixed	from_wide( long long v );
+
+	/** 
+	 * Returns square root of a 64-bit value with 32 fraction bits, rounded down.
+	 * Sums of raw products, as in dot products, can be passed without rounding or overflow.
+	 * @param v Value multiplied by 2^32.
+	 */
+	static fixed	sqrt_wide( unsigned long long v );
+
+	/** Addition. */
+	fixed&		operator+=( fixed o );
+
+	/** Subtraction. */
+	fixed&		operator-=( fixed o );
+
+	/** Multiplication, rounded to nearest. */
+	fixed&		operator*=( fixed o );
+
+	/** Division, rounded towards zero. */
+	fixed&		operator/=( fixed o );
+
+	/** Addition. */
+	fixed		operator+( fixed o ) const;
+
+	/** Subtraction. */
+	fixed		operator-( fixed o ) const;
+
+	/** Multiplication, rounded to nearest. */
+	fixed		operator*( fixed o ) const;
+
+	/** Division, rounded towards zero. */
+	fixed		operator/( fixed o ) const;
+
+	/** Negation. */
+	fixed		operator-() const;
+
+	/** Equality. */
+	bool		operator==( fixed o ) const									{return raw == o.raw;}
+
+	/** Inequality. */
+	bool		operator!=( fixed o ) const									{return raw != o.raw;}
+
+	/** Less than. */
+	bool		operator<( fixed o ) const									{return raw < o.raw;}
+
+	/** Less than or equal. */
+	bool		operator<=( fixed o ) const									{return raw <= o.raw;}
+
+	/** Greater than. */
+	bool		operator>( fixed o ) const									{return raw > o.raw;}
+
+	/** Greater than or equal. */
+	bool		operator>=( fixed o ) const									{return raw >= o.raw;}
+
+	// sqrt, sin and cos are found by argument dependent lookup only, so they don't hide the float versions inside the namespace
+
+	/** 
+	 * Returns square root of the number, rounded down. Computed bit by bit with integers.
+	 * @param a Non-negative number.
+	 */
+	friend fixed	sqrt( fixed a );
+
+	/** 
+	 * Returns sine of the angle. Angle is reduced to [-pi/2,pi/2] and sine evaluated with
+	 * 9th order polynomial in 64-bit integers. Reduction uses 2*pi with 48 fraction bits,
+	 * so maximum error is about 0.00003 over the whole range of fixed.
+	 * @param a Angle in radians.
+	 */
+	friend fixed	sin( fixed a );
+
+	/** 
+	 * Returns cosine of the angle, computed as sin(a+pi/2) after range reduction.
+	 * @param a Angle in radians.
+	 */
+	friend fixed	cos( fixed a );
+};
+
+/** 
+ * Returns absolute value of the number.
+ * @ingroup fixed_util
+ */
+fixed	abs( fixed a );
+
+/** 
+ * Returns minimum of two numbers.
+ * @ingroup fixed_util
+ */
+fixed	min( fixed a, fixed b );
+
+/** 
+ * Returns maximum of two numbers.
+ * @ingroup fixed_util
+ */
+fixed	max( fixed a, fixed b );
+
+/** 
+ * Returns the number converted to float.
+ * @ingroup fixed_util
+ */
+float	to_float( fixed a );
+
+#include <slm/fixed.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
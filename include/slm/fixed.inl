@@ -0,0 +1,102 @@
+inline fixed::fixed( int i ) :
+	raw(i * ONE)
+{
+	SLMATH_VEC_ASSERT( i >= -32768 && i <= 32767 );
+}
+
+inline fixed::fixed( float f ) :
+	raw(int( floorf(f*65536.f + .5f) ))
+{
+	SLMATH_VEC_ASSERT( f >= -32768.f && f < 32768.f );
+}
+
+inline fixed::fixed( double f ) :
+	raw(int( floor(f*65536.0 + .5) ))
+{
+	SLMATH_VEC_ASSERT( f >= -32768.0 && f < 32768.0 );
+}
+
+inline fixed fixed::from_raw( int raw )
+{
+	fixed a;
+	a.raw = raw;
+	return a;
+}
+
+inline fixed fixed::from_wide( long long v )
+{
+	return from_raw( int( (v + (ONE>>1)) >> FRACTION_BITS ) );
+}
+
+inline fixed& fixed::operator+=( fixed o )
+{
+	raw += o.raw;
+	return *this;
+}
+
+inline fixed& fixed::operator-=( fixed o )
+{
+	raw -= o.raw;
+	return *this;
+}
+
+inline fixed& fixed::operator*=( fixed o )
+{
+	raw = from_wide( (long long)raw * o.raw ).raw;
+	return *this;
+}
+
+inline fixed& fixed::operator/=( fixed o )
+{
+	SLMATH_VEC_ASSERT( o.raw != 0 );
+	raw = int( (long long)raw * ONE / o.raw );
+	return *this;
+}
+
+inline fixed fixed::operator+( fixed o ) const
+{
+	return from_raw( raw + o.raw );
+}
+
+inline fixed fixed::operator-( fixed o ) const
+{
+	return from_raw( raw - o.raw );
+}
+
+inline fixed fixed::operator*( fixed o ) const
+{
+	return from_wide( (long long)raw * o.raw );
+}
+
+inline fixed fixed::operator/( fixed o ) const
+{
+	SLMATH_VEC_ASSERT( o.raw != 0 );
+	return from_raw( int( (long long)raw * ONE / o.raw ) );
+}
+
+inline fixed fixed::operator-() const
+{
+	return from_raw( -raw );
+}
+
+inline fixed abs( fixed a )
+{
+	return fixed::from_raw( a.raw < 0 ? -a.raw : a.raw );
+}
+
+inline fixed min( fixed a, fixed b )
+{
+	return ( a.raw < b.raw ? a : b );
+}
+
+inline fixed max( fixed a, fixed b )
+{
+	return ( a.raw > b.raw ? a : b );
+}
+
+inline float to_float( fixed a )
+{
+	return float(a.raw) * (1.f/65536.f);
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
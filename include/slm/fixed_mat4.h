@@ -0,0 +1,116 @@
+#ifndef SLMATH_FIXED_MAT4_H
+#define SLMATH_FIXED_MAT4_H
+
+#include <slm/fixed_quat.h>
+#include <slm/mat4.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Fixed point 4x4 matrix with deterministic operations, see fixed.
+ * Layout and semantics follow mat4: columns are stored one after another, m[i][j] is row j of column i,
+ * and vectors are column vectors, so to make combined transform of A, then B: AB = B * A;
+ * Matrix products accumulate raw products in 64 bits and round once per element.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup fixed_util
+ */
+class fixed_mat4
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of columns. */
+		COLUMNS = 4,
+		/** Number of rows. */
+		ROWS = 4,
+	};
+
+	/** Elements, m[i][j] is row j of column i. */
+	fixed m[4][4];
+
+	/** Constructs undefined matrix. */
+	fixed_mat4()															{}
+
+	/** 
+	 * Constructs diagonal matrix.
+	 * @param d Value of the diagonal elements.
+	 */
+	explicit fixed_mat4( fixed d );
+
+	/** 
+	 * Constructs rigid transform: rotation followed by translation.
+	 * @param q Rotation, unit quaternion.
+	 * @param t Translation.
+	 */
+	fixed_mat4( const fixed_quat& q, const fixed_vec3& t );
+
+	/**
+	 * Constructs the matrix from float matrix, rounding each element to nearest.
+	 */
+	explicit fixed_mat4( const mat4& a );
+
+	/** Returns ith column of the matrix. */
+	fixed*		operator[]( size_t i )						{SLMATH_VEC_ASSERT( i < 4 ); return m[i];}
+
+	/** Returns ith column of the matrix. */
+	const fixed* operator[]( size_t i ) const				{SLMATH_VEC_ASSERT( i < 4 ); return m[i];}
+
+	/** Matrix multiplication. */
+	fixed_mat4	operator*( const fixed_mat4& o ) const;
+
+	/** Element wise equality. */
+	bool		operator==( const fixed_mat4& o ) const;
+
+	/** Element wise inequality. */
+	bool		operator!=( const fixed_mat4& o ) const;
+};
+
+/** 
+ * Transforms point by the matrix, i.e. with W-component 1 and without projection.
+ * @ingroup fixed_util
+ */
+fixed_vec3	transform_point( const fixed_mat4& m, const fixed_vec3& p );
+
+/** 
+ * Transforms direction by the matrix, i.e. with W-component 0.
+ * @ingroup fixed_util
+ */
+fixed_vec3	transform_direction( const fixed_mat4& m, const fixed_vec3& d );
+
+/** 
+ * Transforms array of points by the matrix.
+ * @param m Transform matrix.
+ * @param p Points to transform.
+ * @param n Number of points.
+ * @param out [out] Receives n transformed points. Can be the same as p.
+ * @ingroup fixed_util
+ */
+void		transform_points( const fixed_mat4& m, const fixed_vec3* p, size_t n, fixed_vec3* out );
+
+/** 
+ * Returns transpose of the matrix.
+ * @ingroup fixed_util
+ */
+fixed_mat4	transpose( const fixed_mat4& m );
+
+/** 
+ * Returns translation matrix.
+ * @ingroup fixed_util
+ */
+fixed_mat4	translation( const fixed_vec3& t );
+
+/** 
+ * Returns the matrix converted to float.
+ * @ingroup fixed_util
+ */
+mat4		to_mat4( const fixed_mat4& m );
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
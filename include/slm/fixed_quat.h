@@ -0,0 +1,117 @@
+#ifndef SLMATH_FIXED_QUAT_H
+#define SLMATH_FIXED_QUAT_H
+
+#include <slm/fixed_vec3.h>
+#include <slm/quat.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Fixed point quaternion with deterministic operations, see fixed.
+ * Quaternion products accumulate raw products in 64 bits and round once per component.
+ * Repeated products slowly drift from unit length, so normalize rotations kept in simulation state now and then.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup fixed_util
+ */
+class fixed_quat
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of components. */
+		SIZE = 4,
+	};
+
+	/** The first component of the quaternion. */
+	fixed x;
+
+	/** The second component of the quaternion. */
+	fixed y;
+
+	/** The third component of the quaternion. */
+	fixed z;
+
+	/** The fourth component of the quaternion. */
+	fixed w;
+
+	/** Constructs undefined quaternion. */
+	fixed_quat()															{}
+
+	/** 
+	 * Constructs the quaternion from scalars.
+	 * @param x0 The quaternion X-component (0)
+	 * @param y0 The quaternion Y-component (1)
+	 * @param z0 The quaternion Z-component (2)
+	 * @param w0 The quaternion W-component (3)
+	 */
+	fixed_quat( fixed x0, fixed y0, fixed z0, fixed w0 );
+
+	/** 
+	 * Constructs the quaternion from angle-axis rotation.
+	 * @param a Angle in radians.
+	 * @param v Rotation axis, unit vector.
+	 */
+	fixed_quat( fixed a, const fixed_vec3& v );
+
+	/**
+	 * Constructs the quaternion from float quaternion, rounding each component to nearest.
+	 */
+	explicit fixed_quat( const quat& q );
+
+	/** Quaternion multiplication. */
+	fixed_quat&	operator*=( const fixed_quat& o );
+
+	/** Quaternion multiplication. */
+	fixed_quat	operator*( const fixed_quat& o ) const;
+
+	/** Component wise negation. */
+	fixed_quat	operator-() const;
+
+	/** Component wise equality. */
+	bool		operator==( const fixed_quat& o ) const;
+
+	/** Component wise inequality. */
+	bool		operator!=( const fixed_quat& o ) const;
+};
+
+/**
+ * Returns dot product of two quaternions.
+ * @ingroup fixed_util
+ */
+fixed		dot( const fixed_quat& a, const fixed_quat& b );
+
+/**
+ * Returns the quaternion scaled to unit length.
+ * @ingroup fixed_util
+ */
+fixed_quat	normalize( const fixed_quat& q );
+
+/**
+ * Returns conjugate of the quaternion, which is the inverse for unit quaternions.
+ * @ingroup fixed_util
+ */
+fixed_quat	conjugate( const fixed_quat& q );
+
+/**
+ * Rotates vector by unit quaternion.
+ * @ingroup fixed_util
+ */
+fixed_vec3	rotate( const fixed_quat& q, const fixed_vec3& v );
+
+/**
+ * Returns the quaternion converted to float.
+ * @ingroup fixed_util
+ */
+quat		to_quat( const fixed_quat& q );
+
+#include <slm/fixed_quat.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
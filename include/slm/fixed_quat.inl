@@ -0,0 +1,47 @@
+inline fixed_quat::fixed_quat( fixed x0, fixed y0, fixed z0, fixed w0 ) :
+	x(x0), y(y0), z(z0), w(w0)
+{
+}
+
+inline fixed_quat::fixed_quat( const quat& q ) :
+	x(q.x), y(q.y), z(q.z), w(q.w)
+{
+}
+
+inline fixed_quat& fixed_quat::operator*=( const fixed_quat& o )
+{
+	*this = *this * o;
+	return *this;
+}
+
+inline fixed_quat fixed_quat::operator-() const
+{
+	return fixed_quat( -x, -y, -z, -w );
+}
+
+inline bool fixed_quat::operator==( const fixed_quat& o ) const
+{
+	return x == o.x && y == o.y && z == o.z && w == o.w;
+}
+
+inline bool fixed_quat::operator!=( const fixed_quat& o ) const
+{
+	return !(*this == o);
+}
+
+inline fixed dot( const fixed_quat& a, const fixed_quat& b )
+{
+	return fixed::from_wide( (long long)a.x.raw*b.x.raw + (long long)a.y.raw*b.y.raw + (long long)a.z.raw*b.z.raw + (long long)a.w.raw*b.w.raw );
+}
+
+inline fixed_quat conjugate( const fixed_quat& q )
+{
+	return fixed_quat( -q.x, -q.y, -q.z, q.w );
+}
+
+inline quat to_quat( const fixed_quat& q )
+{
+	return quat( to_float(q.x), to_float(q.y), to_float(q.z), to_float(q.w) );
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,123 @@
+#ifndef SLMATH_FIXED_VEC2_H
+#define SLMATH_FIXED_VEC2_H
+
+#include <slm/fixed.h>
+#include <slm/vec2.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Fixed point 2-vector with deterministic operations, see fixed.
+ * Dot products and lengths accumulate raw products in 64 bits before rounding, like in fixed_vec2.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup fixed_util
+ */
+class fixed_vec2
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of dimensions in this vector. */
+		SIZE = 2,
+	};
+
+	/** The first component of the vector. */
+	fixed x;
+
+	/** The second component of the vector. */
+	fixed y;
+
+	/** Constructs undefined 2-vector. */
+	fixed_vec2()															{}
+
+	/** 
+	 * Constructs the vector from scalars. 
+	 * @param x0 The vector X-component (0)
+	 * @param y0 The vector Y-component (1)
+	 */
+	fixed_vec2( fixed x0, fixed y0 );
+
+	/** 
+	 * Constructs the vector from float vector, rounding each component to nearest. 
+	 */
+	explicit fixed_vec2( const vec2& v );
+
+	/** Component wise addition. */
+	fixed_vec2&	operator+=( const fixed_vec2& o );
+
+	/** Component wise subtraction. */
+	fixed_vec2&	operator-=( const fixed_vec2& o );
+
+	/** Component wise scalar multiplication. */
+	fixed_vec2&	operator*=( fixed s );
+
+	/** Returns ith component of the vector. */
+	fixed&		operator[]( size_t i )						{SLMATH_VEC_ASSERT( i < 2 ); return (&x)[i];}
+
+	/** Component wise addition. */
+	fixed_vec2	operator+( const fixed_vec2& o ) const;
+
+	/** Component wise subtraction. */
+	fixed_vec2	operator-( const fixed_vec2& o ) const;
+
+	/** Component wise negation. */
+	fixed_vec2	operator-() const;
+
+	/** Component wise scalar multiplication. */
+	fixed_vec2	operator*( fixed s ) const;
+
+	/** Component wise scalar division. */
+	fixed_vec2	operator/( fixed s ) const;
+
+	/** Returns ith component of the vector. */
+	const fixed& operator[]( size_t i ) const				{SLMATH_VEC_ASSERT( i < 2 ); return (&x)[i];}
+
+	/** Component wise equality. */
+	bool		operator==( const fixed_vec2& o ) const;
+
+	/** Component wise inequality. */
+	bool		operator!=( const fixed_vec2& o ) const;
+};
+
+/** 
+ * Component wise scalar multiplication.
+ * @ingroup fixed_util
+ */
+fixed_vec2	operator*( fixed s, const fixed_vec2& v );
+
+/** 
+ * Returns dot product of two vectors, rounded once from the 64-bit sum.
+ * @ingroup fixed_util
+ */
+fixed		dot( const fixed_vec2& a, const fixed_vec2& b );
+
+/** 
+ * Returns length of the vector.
+ * @ingroup fixed_util
+ */
+fixed		length( const fixed_vec2& v );
+
+/** 
+ * Returns the vector scaled to unit length. 
+ * @param v Non-zero vector.
+ * @ingroup fixed_util
+ */
+fixed_vec2	normalize( const fixed_vec2& v );
+
+/** 
+ * Returns the vector converted to float.
+ * @ingroup fixed_util
+ */
+vec2		to_vec2( const fixed_vec2& v );
+
+#include <slm/fixed_vec2.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,92 @@
+inline fixed_vec2::fixed_vec2( fixed x0, fixed y0 ) :
+	x(x0), y(y0)
+{
+}
+
+inline fixed_vec2::fixed_vec2( const vec2& v ) :
+	x(v.x), y(v.y)
+{
+}
+
+inline fixed_vec2& fixed_vec2::operator+=( const fixed_vec2& o )
+{
+	x += o.x;
+	y += o.y;
+	return *this;
+}
+
+inline fixed_vec2& fixed_vec2::operator-=( const fixed_vec2& o )
+{
+	x -= o.x;
+	y -= o.y;
+	return *this;
+}
+
+inline fixed_vec2& fixed_vec2::operator*=( fixed s )
+{
+	x *= s;
+	y *= s;
+	return *this;
+}
+
+inline fixed_vec2 fixed_vec2::operator+( const fixed_vec2& o ) const
+{
+	return fixed_vec2( x+o.x, y+o.y );
+}
+
+inline fixed_vec2 fixed_vec2::operator-( const fixed_vec2& o ) const
+{
+	return fixed_vec2( x-o.x, y-o.y );
+}
+
+inline fixed_vec2 fixed_vec2::operator-() const
+{
+	return fixed_vec2( -x, -y );
+}
+
+inline fixed_vec2 fixed_vec2::operator*( fixed s ) const
+{
+	return fixed_vec2( x*s, y*s );
+}
+
+inline fixed_vec2 fixed_vec2::operator/( fixed s ) const
+{
+	return fixed_vec2( x/s, y/s );
+}
+
+inline bool fixed_vec2::operator==( const fixed_vec2& o ) const
+{
+	return x == o.x && y == o.y;
+}
+
+inline bool fixed_vec2::operator!=( const fixed_vec2& o ) const
+{
+	return !(*this == o);
+}
+
+inline fixed_vec2 operator*( fixed s, const fixed_vec2& v )
+{
+	return v * s;
+}
+
+inline fixed dot( const fixed_vec2& a, const fixed_vec2& b )
+{
+	return fixed::from_wide( (long long)a.x.raw*b.x.raw + (long long)a.y.raw*b.y.raw );
+}
+
+inline fixed length( const fixed_vec2& v )
+{
+	return fixed::sqrt_wide( (unsigned long long)( (long long)v.x.raw*v.x.raw + (long long)v.y.raw*v.y.raw ) );
+}
+
+inline fixed_vec2 normalize( const fixed_vec2& v )
+{
+	return v / length(v);
+}
+
+inline vec2 to_vec2( const fixed_vec2& v )
+{
+	return vec2( to_float(v.x), to_float(v.y) );
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,143 @@
+#ifndef SLMATH_FIXED_VEC3_H
+#define SLMATH_FIXED_VEC3_H
+
+#include <slm/fixed_vec2.h>
+#include <slm/vec3.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Fixed point 3-vector with deterministic operations, see fixed.
+ * Dot products and lengths accumulate raw products in 64 bits before rounding,
+ * so they don't overflow for vectors with components up to about 32767.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup fixed_util
+ */
+class fixed_vec3
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of dimensions in this vector. */
+		SIZE = 3,
+	};
+
+	/** The first component of the vector. */
+	fixed x;
+
+	/** The second component of the vector. */
+	fixed y;
+
+	/** The third component of the vector. */
+	fixed z;
+
+	/** Constructs undefined 3-vector. */
+	fixed_vec3()															{}
+
+	/** 
+	 * Constructs the vector from scalars. 
+	 * @param x0 The vector X-component (0)
+	 * @param y0 The vector Y-component (1)
+	 * @param z0 The vector Z-component (2)
+	 */
+	fixed_vec3( fixed x0, fixed y0, fixed z0 );
+
+	/** 
+	 * Constructs the vector from float vector, rounding each component to nearest. 
+	 */
+	explicit fixed_vec3( const vec3& v );
+
+	/** Component wise addition. */
+	fixed_vec3&	operator+=( const fixed_vec3& o );
+
+	/** Component wise subtraction. */
+	fixed_vec3&	operator-=( const fixed_vec3& o );
+
+	/** Component wise scalar multiplication. */
+	fixed_vec3&	operator*=( fixed s );
+
+	/** Returns ith component of the vector. */
+	fixed&		operator[]( size_t i )						{SLMATH_VEC_ASSERT( i < 3 ); return (&x)[i];}
+
+	/** Component wise addition. */
+	fixed_vec3	operator+( const fixed_vec3& o ) const;
+
+	/** Component wise subtraction. */
+	fixed_vec3	operator-( const fixed_vec3& o ) const;
+
+	/** Component wise negation. */
+	fixed_vec3	operator-() const;
+
+	/** Component wise scalar multiplication. */
+	fixed_vec3	operator*( fixed s ) const;
+
+	/** Component wise scalar division. */
+	fixed_vec3	operator/( fixed s ) const;
+
+	/** Returns ith component of the vector. */
+	const fixed& operator[]( size_t i ) const				{SLMATH_VEC_ASSERT( i < 3 ); return (&x)[i];}
+
+	/** Component wise equality. */
+	bool		operator==( const fixed_vec3& o ) const;
+
+	/** Component wise inequality. */
+	bool		operator!=( const fixed_vec3& o ) const;
+};
+
+/** 
+ * Returns cross product of two vectors.
+ * @ingroup fixed_util
+ */
+fixed_vec3	cross( const fixed_vec3& a, const fixed_vec3& b );
+
+/** 
+ * Component wise scalar multiplication.
+ * @ingroup fixed_util
+ */
+fixed_vec3	operator*( fixed s, const fixed_vec3& v );
+
+/** 
+ * Returns dot product of two vectors, rounded once from the 64-bit sum.
+ * @ingroup fixed_util
+ */
+fixed		dot( const fixed_vec3& a, const fixed_vec3& b );
+
+/** 
+ * Returns length of the vector.
+ * @ingroup fixed_util
+ */
+fixed		length( const fixed_vec3& v );
+
+/** 
+ * Returns the vector scaled to unit length. 
+ * @param v Non-zero vector.
+ * @ingroup fixed_util
+ */
+fixed_vec3	normalize( const fixed_vec3& v );
+
+/** 
+ * Returns the vector converted to float.
+ * @ingroup fixed_util
+ */
+vec3		to_vec3( const fixed_vec3& v );
+
+/** 
+ * Converts array of fixed point vectors to float, e.g. simulation state to rendering.
+ * @param v Fixed point vectors.
+ * @param n Number of vectors.
+ * @param out [out] Receives n float vectors.
+ * @ingroup fixed_util
+ */
+void		to_vec3( const fixed_vec3* v, size_t n, vec3* out );
+
+#include <slm/fixed_vec3.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
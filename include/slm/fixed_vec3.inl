@@ -0,0 +1,103 @@
+inline fixed_vec3::fixed_vec3( fixed x0, fixed y0, fixed z0 ) :
+	x(x0), y(y0), z(z0)
+{
+}
+
+inline fixed_vec3::fixed_vec3( const vec3& v ) :
+	x(v.x), y(v.y), z(v.z)
+{
+}
+
+inline fixed_vec3& fixed_vec3::operator+=( const fixed_vec3& o )
+{
+	x += o.x;
+	y += o.y;
+	z += o.z;
+	return *this;
+}
+
+inline fixed_vec3& fixed_vec3::operator-=( const fixed_vec3& o )
+{
+	x -= o.x;
+	y -= o.y;
+	z -= o.z;
+	return *this;
+}
+
+inline fixed_vec3& fixed_vec3::operator*=( fixed s )
+{
+	x *= s;
+	y *= s;
+	z *= s;
+	return *this;
+}
+
+inline fixed_vec3 fixed_vec3::operator+( const fixed_vec3& o ) const
+{
+	return fixed_vec3( x+o.x, y+o.y, z+o.z );
+}
+
+inline fixed_vec3 fixed_vec3::operator-( const fixed_vec3& o ) const
+{
+	return fixed_vec3( x-o.x, y-o.y, z-o.z );
+}
+
+inline fixed_vec3 fixed_vec3::operator-() const
+{
+	return fixed_vec3( -x, -y, -z );
+}
+
+inline fixed_vec3 fixed_vec3::operator*( fixed s ) const
+{
+	return fixed_vec3( x*s, y*s, z*s );
+}
+
+inline fixed_vec3 fixed_vec3::operator/( fixed s ) const
+{
+	return fixed_vec3( x/s, y/s, z/s );
+}
+
+inline bool fixed_vec3::operator==( const fixed_vec3& o ) const
+{
+	return x == o.x && y == o.y && z == o.z;
+}
+
+inline bool fixed_vec3::operator!=( const fixed_vec3& o ) const
+{
+	return !(*this == o);
+}
+
+inline fixed_vec3 cross( const fixed_vec3& a, const fixed_vec3& b )
+{
+	return fixed_vec3( 
+		fixed::from_wide( (long long)a.y.raw*b.z.raw - (long long)a.z.raw*b.y.raw ),
+		fixed::from_wide( (long long)a.z.raw*b.x.raw - (long long)a.x.raw*b.z.raw ),
+		fixed::from_wide( (long long)a.x.raw*b.y.raw - (long long)a.y.raw*b.x.raw ) );
+}
+
+inline fixed_vec3 operator*( fixed s, const fixed_vec3& v )
+{
+	return v * s;
+}
+
+inline fixed dot( const fixed_vec3& a, const fixed_vec3& b )
+{
+	return fixed::from_wide( (long long)a.x.raw*b.x.raw + (long long)a.y.raw*b.y.raw + (long long)a.z.raw*b.z.raw );
+}
+
+inline fixed length( const fixed_vec3& v )
+{
+	return fixed::sqrt_wide( (unsigned long long)( (long long)v.x.raw*v.x.raw + (long long)v.y.raw*v.y.raw + (long long)v.z.raw*v.z.raw ) );
+}
+
+inline fixed_vec3 normalize( const fixed_vec3& v )
+{
+	return v / length(v);
+}
+
+inline vec3 to_vec3( const fixed_vec3& v )
+{
+	return vec3( to_float(v.x), to_float(v.y), to_float(v.z) );
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
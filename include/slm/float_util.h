@@ -82,6 +82,13 @@ bool	check( float v );
  */
 bool	check( const float* v, size_t n );
 
+/**
+ * Returns true if the double precision value is in valid range.
+ * @param v Value to check.
+ * @return true if -DBL_MAX <= v <= DBL_MAX
+ */
+bool	check( double v );
+
 /**
  * Returns minimum of two values.
  */
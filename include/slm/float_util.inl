@@ -62,6 +62,11 @@ inline bool check( const float* v, size_t n )
 	return true;
 }
 
+inline bool check( double v )
+{
+	return v <= DBL_MAX && v >= -DBL_MAX;
+}
+
 inline float length( float v )
 {
 	return v < 0.f ? -v : v;
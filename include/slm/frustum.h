@@ -0,0 +1,147 @@
+#ifndef SLMATH_FRUSTUM_H
+#define SLMATH_FRUSTUM_H
+
+#include <slm/mat4.h>
+
+SLMATH_BEGIN()
+
+/**
+ * \defgroup frustum_util View frustum and visibility culling helper functions.
+ * @ingroup slm
+ */
+/*@{*/
+
+/**
+ * View frustum defined by six planes.
+ * Each plane is stored as vec4 (normal.x,normal.y,normal.z,d) with unit length normal
+ * pointing inside the frustum, so point p is inside a plane if dot(normal,p)+d >= 0.
+ *
+ * Note naming convention: This class is starting with small letter since
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ */
+class frustum
+{
+public:
+	/** Plane indices. */
+	enum Plane
+	{
+		/** Left clip plane. */
+		PLANE_LEFT,
+		/** Right clip plane. */
+		PLANE_RIGHT,
+		/** Bottom clip plane. */
+		PLANE_BOTTOM,
+		/** Top clip plane. */
+		PLANE_TOP,
+		/** Near clip plane. */
+		PLANE_NEAR,
+		/** Far clip plane. */
+		PLANE_FAR,
+		/** Number of planes. */
+		PLANE_COUNT
+	};
+
+	/** Frustum planes, indexed by Plane enumeration. */
+	vec4	planes[PLANE_COUNT];
+
+	/** Constructs undefined frustum. */
+	frustum();
+
+	/**
+	 * Extracts frustum planes from (view-)projection transform.
+	 * Clip space is assumed to be -w<=x<=w, -w<=y<=w, 0<=z<=w,
+	 * which is the convention of perspective_fov_rh, perspective_fov_lh, ortho_rh and ortho_lh.
+	 * With world-view-projection transform the planes are in world space.
+	 *
+	 * See: Gil Gribb, Klaus Hartmann "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix", 2001.
+	 *
+	 * @param viewproj Transform from frustum space to clip space, e.g. proj*view.
+	 */
+	explicit frustum( const mat4& viewproj );
+};
+
+/**
+ * Returns true if sphere is inside or intersects the frustum.
+ * Conservative: Spheres near frustum corners can be reported visible even if they are outside.
+ * @param f The frustum.
+ * @param center Center of the sphere.
+ * @param radius Radius of the sphere.
+ */
+bool	intersect_frustum_sphere( const frustum& f, const vec3& center, float radius );
+
+/**
+ * Returns true if axis aligned box is inside or intersects the frustum.
+ * Conservative: Boxes near frustum corners can be reported visible even if they are outside.
+ * @param f The frustum.
+ * @param boxmin Minimum coordinates of the box.
+ * @param boxmax Maximum coordinates of the box.
+ */
+bool	intersect_frustum_box( const frustum& f, const vec3& boxmin, const vec3& boxmax );
+
+/**
+ * Culls array of spheres against the frustum, stored in structure-of-arrays form.
+ * Four spheres are tested at a time using SIMD instructions.
+ * @param f The frustum.
+ * @param x Sphere center X-coordinates.
+ * @param y Sphere center Y-coordinates.
+ * @param z Sphere center Z-coordinates.
+ * @param r Sphere radii.
+ * @param n Number of spheres.
+ * @param visible [out] Receives indices of visible spheres in ascending order. Must have room for n indices.
+ * @return Number of visible spheres.
+ */
+size_t	cull_spheres( const frustum& f, const float* x, const float* y, const float* z, const float* r, size_t n, size_t* visible );
+
+/**
+ * Culls array of spheres against the frustum, stored in structure-of-arrays form.
+ * Four spheres are tested at a time using SIMD instructions.
+ * @param f The frustum.
+ * @param x Sphere center X-coordinates.
+ * @param y Sphere center Y-coordinates.
+ * @param z Sphere center Z-coordinates.
+ * @param r Sphere radii.
+ * @param n Number of spheres.
+ * @param mask [out] Receives visibility bits, bit (i&31) of mask[i>>5] set if sphere i is visible. Must have room for (n+31)/32 words.
+ */
+void	cull_spheres_mask( const frustum& f, const float* x, const float* y, const float* z, const float* r, size_t n, unsigned int* mask );
+
+/**
+ * Culls array of axis aligned boxes against the frustum, stored in structure-of-arrays form.
+ * Four boxes are tested at a time using SIMD instructions.
+ * @param f The frustum.
+ * @param minx Box minimum X-coordinates.
+ * @param miny Box minimum Y-coordinates.
+ * @param minz Box minimum Z-coordinates.
+ * @param maxx Box maximum X-coordinates.
+ * @param maxy Box maximum Y-coordinates.
+ * @param maxz Box maximum Z-coordinates.
+ * @param n Number of boxes.
+ * @param visible [out] Receives indices of visible boxes in ascending order. Must have room for n indices.
+ * @return Number of visible boxes.
+ */
+size_t	cull_boxes( const frustum& f, const float* minx, const float* miny, const float* minz, const float* maxx, const float* maxy, const float* maxz, size_t n, size_t* visible );
+
+/**
+ * Culls array of axis aligned boxes against the frustum, stored in structure-of-arrays form.
+ * Four boxes are tested at a time using SIMD instructions.
+ * @param f The frustum.
+ * @param minx Box minimum X-coordinates.
+ * @param miny Box minimum Y-coordinates.
+ * @param minz Box minimum Z-coordinates.
+ * @param maxx Box maximum X-coordinates.
+ * @param maxy Box maximum Y-coordinates.
+ * @param maxz Box maximum Z-coordinates.
+ * @param n Number of boxes.
+ * @param mask [out] Receives visibility bits, bit (i&31) of mask[i>>5] set if box i is visible. Must have room for (n+31)/32 words.
+ */
+void	cull_boxes_mask( const frustum& f, const float* minx, const float* miny, const float* minz, const float* maxx, const float* maxy, const float* maxz, size_t n, unsigned int* mask );
+
+/*@}*/
+
+#include <slm/frustum.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,29 @@
+inline frustum::frustum()
+{
+}
+
+inline bool intersect_frustum_sphere( const frustum& f, const vec3& center, float radius )
+{
+	for ( size_t i = 0 ; i < frustum::PLANE_COUNT ; ++i )
+	{
+		const vec4& p = f.planes[i];
+		if ( dot(p.xyz(),center) + p.w < -radius )
+			return false;
+	}
+	return true;
+}
+
+inline bool intersect_frustum_box( const frustum& f, const vec3& boxmin, const vec3& boxmax )
+{
+	for ( size_t i = 0 ; i < frustum::PLANE_COUNT ; ++i )
+	{
+		// test the box corner furthest along plane normal
+		const vec4& p = f.planes[i];
+		const vec3 c( p.x < 0.f ? boxmin.x : boxmax.x, p.y < 0.f ? boxmin.y : boxmax.y, p.z < 0.f ? boxmin.z : boxmax.z );
+		if ( dot(p.xyz(),c) + p.w < 0.f )
+			return false;
+	}
+	return true;
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,176 @@
+#ifndef SLMATH_GJK_H
+#define SLMATH_GJK_H
+
+#include <slm/vec3.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Support function of a convex shape.
+ * @param data Shape data given in gjk_shape.
+ * @param dir Search direction, not necessarily normalized.
+ * @return Point of the shape furthest in the direction.
+ * @ingroup intersect_util
+ */
+typedef vec3 (*gjk_support_function)( const void* data, const vec3& dir );
+
+/**
+ * Convex shape for GJK and EPA queries: core shape given by a support function, swept by a sphere of specified radius.
+ * Spheres and capsules are a point and a segment with radius, which keeps their queries as fast and exact as polytopes.
+ * Shapes are in world space, so shapes with their own transforms are handled in the support function.
+ * @ingroup intersect_util
+ */
+class gjk_shape
+{
+public:
+	/** Support function of the core shape. */
+	gjk_support_function	support;
+	/** Shape data passed to the support function. */
+	const void*				data;
+	/** Radius of the sphere sweeping the core shape. */
+	float					radius;
+
+	/**
+	 * Constructs shape from support function.
+	 * @param support Support function of the core shape.
+	 * @param data Shape data passed to the support function. Must stay valid while the shape is used.
+	 * @param radius Radius of the sphere sweeping the core shape.
+	 */
+	gjk_shape( gjk_support_function support, const void* data, float radius=0.f );
+};
+
+/**
+ * Oriented box for gjk_support_box.
+ * @ingroup intersect_util
+ */
+class gjk_box
+{
+public:
+	/** Center of the box. */
+	vec3	center;
+	/** Box axes scaled by half of the box size along each axis. */
+	vec3	axis[3];
+};
+
+/**
+ * Convex hull of points in SoA form for gjk_support_point_hull. Points inside the hull are allowed.
+ * @ingroup intersect_util
+ */
+class gjk_point_hull
+{
+public:
+	/** X-coordinates of the points. */
+	const float*	x;
+	/** Y-coordinates of the points. */
+	const float*	y;
+	/** Z-coordinates of the points. */
+	const float*	z;
+	/** Number of points, at least 1 and less than 2^24. */
+	size_t			n;
+};
+
+/**
+ * Warm start data of GJK: search directions which produced the vertices of the last simplex.
+ * When the same pair of shapes is queried again after a small movement, support points of the cached
+ * directions form a simplex close to the answer, so the query takes only an iteration or two.
+ * @ingroup intersect_util
+ */
+class gjk_simplex
+{
+public:
+	enum Constants
+	{
+		/** Maximum number of simplex vertices. */
+		SIZE = 4,
+	};
+
+	/** Search directions of the simplex vertices. */
+	vec3	dir[SIZE];
+	/** Number of simplex vertices, 0 if not warm started. */
+	size_t	count;
+
+	/** Constructs empty simplex. */
+	gjk_simplex()						: count(0) {}
+};
+
+/**
+ * Result of GJK distance and EPA penetration queries.
+ * @ingroup intersect_util
+ */
+class gjk_result
+{
+public:
+	/** Point on shape A closest to B, or deepest in B if the shapes overlap. */
+	vec3	pointa;
+	/** Point on shape B closest to A, or deepest in A if the shapes overlap. */
+	vec3	pointb;
+	/** Unit direction from A to B. Moving B by -distance*normal makes the shapes touch. */
+	vec3	normal;
+	/** Distance between the shapes, negative penetration depth if the shapes overlap. */
+	float	distance;
+	/** Number of GJK iterations used. */
+	size_t	iterations;
+};
+
+/**
+ * Returns point itself as support of a point, core shape of a sphere.
+ * @param data Pointer to vec3.
+ * @param dir Search direction.
+ * @ingroup intersect_util
+ */
+vec3	gjk_support_point( const void* data, const vec3& dir );
+
+/**
+ * Returns support point of a line segment, core shape of a capsule.
+ * @param data Pointer to array of two vec3 end points.
+ * @param dir Search direction.
+ * @ingroup intersect_util
+ */
+vec3	gjk_support_segment( const void* data, const vec3& dir );
+
+/**
+ * Returns support point of an oriented box.
+ * @param data Pointer to gjk_box.
+ * @param dir Search direction.
+ * @ingroup intersect_util
+ */
+vec3	gjk_support_box( const void* data, const vec3& dir );
+
+/**
+ * Returns support point of a convex hull of points, testing four points at a time with SIMD.
+ * @param data Pointer to gjk_point_hull.
+ * @param dir Search direction.
+ * @ingroup intersect_util
+ */
+vec3	gjk_support_point_hull( const void* data, const vec3& dir );
+
+/**
+ * Computes distance and closest points of two convex shapes with GJK algorithm.
+ * @param a Shape A.
+ * @param b Shape B.
+ * @param simplex [in/out] Warm start simplex, updated to the final simplex. Can be 0.
+ * @param result [out] Receives distance, closest points and normal. If the core shapes overlap, only distance (0) and iterations are set.
+ * @return true if the shapes are separated.
+ * @ingroup intersect_util
+ */
+bool	gjk_distance( const gjk_shape& a, const gjk_shape& b, gjk_simplex* simplex, gjk_result* result );
+
+/**
+ * Computes penetration depth, direction and deepest points of two convex shapes.
+ * Runs GJK first, so separated shapes cost the same as gjk_distance and get the same result.
+ * If only radii overlap, penetration is found from the core distance, otherwise with EPA algorithm
+ * expanding the GJK simplex towards the boundary of the Minkowski difference of the core shapes.
+ * @param a Shape A.
+ * @param b Shape B.
+ * @param simplex [in/out] Warm start simplex, updated to the final GJK simplex. Can be 0.
+ * @param result [out] Receives signed distance, points and normal.
+ * @return true if the shapes overlap.
+ * @ingroup intersect_util
+ */
+bool	epa_penetration( const gjk_shape& a, const gjk_shape& b, gjk_simplex* simplex, gjk_result* result );
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
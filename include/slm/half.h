@@ -0,0 +1,136 @@
+#ifndef SLMATH_HALF_H
+#define SLMATH_HALF_H
+
+#include <slm/vec4.h>
+
+SLMATH_BEGIN()
+
+/**
+ * \defgroup half_util Half precision storage and conversion.
+ * @ingroup slm
+ */
+
+/**
+ * Converts float to IEEE 754 half precision bits, rounding to nearest even.
+ * Values too large for half become infinity, NaNs stay NaNs.
+ * @param f Value to convert.
+ * @return Half precision bits.
+ * @ingroup half_util
+ */
+unsigned short	float_to_half( float f );
+
+/**
+ * Converts IEEE 754 half precision bits to float. Conversion is exact.
+ * @param h Half precision bits.
+ * @return Converted value.
+ * @ingroup half_util
+ */
+float			half_to_float( unsigned short h );
+
+/**
+ * 2-vector stored as half precision, for memory-bound arrays like texture coordinates.
+ * No arithmetic, convert to vec2 for computation.
+ * @ingroup half_util
+ */
+class vec2h
+{
+public:
+	/** Half precision bits of the first component. */
+	unsigned short	x;
+
+	/** Half precision bits of the second component. */
+	unsigned short	y;
+
+	/** Constructs undefined vector. */
+	vec2h()									{}
+
+	/** Constructs vector by converting float vector. */
+	explicit vec2h( const vec2& v )			: x(float_to_half(v.x)), y(float_to_half(v.y)) {}
+
+	/** Returns the vector converted to float. */
+	vec2			to_vec2() const			{return vec2( half_to_float(x), half_to_float(y) );}
+};
+
+/**
+ * 4-vector stored as half precision, for memory-bound arrays like normals, colors and animation data.
+ * No arithmetic, convert to vec4 for computation.
+ * @ingroup half_util
+ */
+class vec4h
+{
+public:
+	/** Half precision bits of the first component. */
+	unsigned short	x;
+
+	/** Half precision bits of the second component. */
+	unsigned short	y;
+
+	/** Half precision bits of the third component. */
+	unsigned short	z;
+
+	/** Half precision bits of the fourth component. */
+	unsigned short	w;
+
+	/** Constructs undefined vector. */
+	vec4h()									{}
+
+	/** Constructs vector by converting float vector. */
+	explicit vec4h( const vec4& v )			: x(float_to_half(v.x)), y(float_to_half(v.y)), z(float_to_half(v.z)), w(float_to_half(v.w)) {}
+
+	/** Returns the vector converted to float. */
+	vec4			to_vec4() const			{return vec4( half_to_float(x), half_to_float(y), half_to_float(z), half_to_float(w) );}
+};
+
+/**
+ * Converts array of floats to half precision.
+ * Uses F16C instructions on x86 with MSVC, GCC or clang if they were found at runtime, see isF16CCPU,
+ * otherwise same conversion as float_to_half.
+ * @param in Values to convert.
+ * @param n Number of values.
+ * @param out [out] Receives n half precision values.
+ * @ingroup half_util
+ */
+void	float_to_half( const float* in, size_t n, unsigned short* out );
+
+/**
+ * Converts array of half precision values to floats.
+ * Uses F16C instructions on x86 with MSVC, GCC or clang if they were found at runtime, see isF16CCPU,
+ * otherwise same conversion as half_to_float.
+ * @param in Half precision values to convert.
+ * @param n Number of values.
+ * @param out [out] Receives n floats.
+ * @ingroup half_util
+ */
+void	half_to_float( const unsigned short* in, size_t n, float* out );
+
+/**
+ * Converts array of vectors to half precision.
+ * @ingroup half_util
+ */
+void	to_half( const vec2* in, size_t n, vec2h* out );
+
+/**
+ * Converts array of vectors to half precision.
+ * @ingroup half_util
+ */
+void	to_half( const vec4* in, size_t n, vec4h* out );
+
+/**
+ * Converts array of half precision vectors to float.
+ * @ingroup half_util
+ */
+void	to_float( const vec2h* in, size_t n, vec2* out );
+
+/**
+ * Converts array of half precision vectors to float.
+ * @ingroup half_util
+ */
+void	to_float( const vec4h* in, size_t n, vec4* out );
+
+#include <slm/half.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,67 @@
+/** Float and its bit pattern for half precision conversion. */
+union half_float_bits
+{
+	float			f;
+	unsigned int	u;
+};
+
+inline unsigned short float_to_half( float v )
+{
+	// based on float_to_half_fast3_rtne by Fabian Giesen
+	half_float_bits f;
+	f.f = v;
+	const unsigned int sign = f.u & 0x80000000u;
+	f.u ^= sign;
+
+	unsigned int h;
+	if ( f.u >= (127u+16u) << 23 )
+	{
+		// too large for half: infinity, or quiet NaN
+		h = ( f.u > 255u << 23 ? 0x7E00u : 0x7C00u );
+	}
+	else if ( f.u < 113u << 23 )
+	{
+		// denormal or zero: adding magic value aligns mantissa bits at the bottom with hardware rounding
+		half_float_bits magic;
+		magic.u = ((127-15) + (23-10) + 1) << 23;
+		f.f += magic.f;
+		h = f.u - magic.u;
+	}
+	else
+	{
+		// normal: rebias exponent and round to nearest even
+		const unsigned int mantodd = (f.u >> 13) & 1u;
+		f.u += ((unsigned int)(15-127) << 23) + 0xFFFu + mantodd;
+		h = f.u >> 13;
+	}
+	return (unsigned short)( h | (sign >> 16) );
+}
+
+inline float half_to_float( unsigned short h )
+{
+	// based on half_to_float by Fabian Giesen
+	const unsigned int shiftedexp = 0x7C00u << 13;
+	half_float_bits o;
+	o.u = (h & 0x7FFFu) << 13;
+	const unsigned int exp = shiftedexp & o.u;
+	o.u += (127-15) << 23;
+
+	if ( exp == shiftedexp )
+	{
+		// infinity or NaN
+		o.u += (128-16) << 23;
+	}
+	else if ( 0 == exp )
+	{
+		// zero or denormal, renormalized with float subtraction
+		half_float_bits magic;
+		magic.u = 113u << 23;
+		o.u += 1u << 23;
+		o.f -= magic.f;
+	}
+
+	o.u |= (unsigned int)(h & 0x8000u) << 16;
+	return o.f;
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
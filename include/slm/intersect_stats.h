@@ -0,0 +1,75 @@
+#ifndef SLMATH_INTERSECT_STATS_H
+#define SLMATH_INTERSECT_STATS_H
+
+#include <slm/slmath_pp.h>
+#include <stdio.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Counters of work done by intersection and traversal queries: bvh queries,
+ * loose_octree queries and the brute force ray functions over arrays.
+ *
+ * Counting is compiled in only if SLMATH_STATS is defined in slmath_configure.h.
+ * Otherwise the counters stay zero and the queries have no overhead.
+ *
+ * Each thread counts to its own thread local counters, so counting doesn't need synchronization.
+ * To get statistics of a single query, copy the counters of the thread before the query
+ * and subtract the copy from the counters after the query. To aggregate over threads,
+ * let each thread add its counters to a total under the application's own lock.
+ *
+ * @ingroup intersect_util
+ */
+class intersect_stats
+{
+public:
+	/** Number of queries. */
+	size_t	queries;
+	/** Number of visited tree nodes and cells, both inner and leaf. */
+	size_t	node_visits;
+	/** Number of tested bounding boxes, four per compressed bvh node. */
+	size_t	box_tests;
+	/** Number of tested triangles, four per triangle4 block. */
+	size_t	triangle_tests;
+	/** Number of subtrees culled after they were found, and any hit queries which returned before the end. */
+	size_t	early_outs;
+
+	/** Sets all counters to zero. */
+	void				clear();
+
+	/** Adds counters of other stats. */
+	intersect_stats&	operator+=( const intersect_stats& other );
+
+	/** Subtracts counters of other stats, e.g. a copy taken before a query. */
+	intersect_stats&	operator-=( const intersect_stats& other );
+};
+
+/** 
+ * Returns counters of the calling thread.
+ * @ingroup intersect_util
+ */
+intersect_stats&	thread_intersect_stats();
+
+/**
+ * Prints counters and their averages per query, one line per counter.
+ * @param stats The counters.
+ * @param fp File to print to, e.g. stdout.
+ * @ingroup intersect_util
+ */
+void				print_intersect_stats( const intersect_stats& stats, FILE* fp );
+
+/** Counters of the calling thread, used by SLMATH_STATS_ADD. Use thread_intersect_stats() instead. */
+extern SLMATH_THREAD_LOCAL intersect_stats	g_thread_intersect_stats;
+
+SLMATH_END()
+
+// Adds N to counter of the calling thread if statistics are enabled
+#ifdef SLMATH_STATS
+	#define SLMATH_STATS_ADD(COUNTER,N) (SLMATH_NS(g_thread_intersect_stats).COUNTER += (N))
+#else
+	#define SLMATH_STATS_ADD(COUNTER,N)
+#endif
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -1,6 +1,7 @@
 #ifndef SLMATH_INTERSECT_UTIL_H
 #define SLMATH_INTERSECT_UTIL_H
 
+#include <slm/mat4.h>
 #include <slm/vec3.h>
 
 SLMATH_BEGIN()
@@ -57,6 +58,132 @@ private:
  */
 bool	intersect_line_triangle( const vec3& o, const vec3& d, const vec3& v0, const vec3& v1, const vec3& v2, float* t );
 
+/**
+ * Line segment parameters for the watertight line segment vs triangle tests.
+ * Holds axis permutation and shear constants which depend only on the line segment,
+ * so they can be calculated once and reused for every tested triangle.
+ *
+ * See: Sven Woop, Carsten Benthin, Ingo Wald "Watertight Ray/Triangle Intersection",
+ * Journal of Computer Graphics Techniques, 2(1):65-82, 2013.
+ *
+ * @see intersect_line_triangle_watertight
+ * @see intersect_line_triangle4
+ */
+class intersect_line_triangle_line
+{
+public:
+	/** Line segment start point. */
+	const vec3	o;
+	/** Vector from start point of the line segment to the end point. */
+	const vec3	d;
+	/** Index of the dominant axis of the direction. */
+	const int	kz;
+	/** Index of the first remaining axis, chosen so that winding is preserved. */
+	const int	kx;
+	/** Index of the second remaining axis, chosen so that winding is preserved. */
+	const int	ky;
+	/** Shear constant d[kx]/d[kz]. */
+	const float	sx;
+	/** Shear constant d[ky]/d[kz]. */
+	const float	sy;
+	/** Scale constant 1/d[kz]. */
+	const float	sz;
+
+	/** Sets line segment start point and delta to end point. Calculates intermediate values. */
+	intersect_line_triangle_line( const vec3& origin, const vec3& direction );
+
+private:
+	intersect_line_triangle_line();
+	intersect_line_triangle_line( const intersect_line_triangle_line& );
+	intersect_line_triangle_line& operator=( const intersect_line_triangle_line& );
+};
+
+/**
+ * Four triangles in structure-of-arrays form for intersect_line_triangle4.
+ * Unused slots should be cleared, which makes them degenerate so that they never intersect.
+ */
+#ifdef SWIG
+class triangle4
+#else
+SLMATH_ALIGN16 class triangle4
+#endif
+{
+public:
+	/** Number of triangles in the block. */
+	enum Constants
+	{
+		/** Number of triangles in the block. */
+		SIZE = 4,
+	};
+
+	/** Vertex coordinates, v[k][axis] holds the coordinates of vertex k of all four triangles. */
+	m128_t		v[3][3];
+
+	/** Sets ith triangle of the block. */
+	void		set( size_t i, const vec3& v0, const vec3& v1, const vec3& v2 );
+
+	/** Sets ith triangle of the block degenerate (all vertices at origin). */
+	void		clear( size_t i );
+
+	/** Returns vertex k of ith triangle of the block. */
+	vec3		vertex( size_t i, size_t k ) const;
+};
+
+/**
+ * Finds intersection between line segment and triangle without missing hits at shared edges and vertices.
+ * Hits exactly on an edge or a vertex are reported for every triangle sharing that edge or vertex,
+ * so a ray can never leak through a closed mesh. Both front and back faces are reported.
+ *
+ * See: Sven Woop, Carsten Benthin, Ingo Wald "Watertight Ray/Triangle Intersection",
+ * Journal of Computer Graphics Techniques, 2(1):65-82, 2013.
+ *
+ * @param line Line segment information.
+ * @param v0 Vertex 0 of the triangle.
+ * @param v1 Vertex 1 of the triangle.
+ * @param v2 Vertex 2 of the triangle.
+ * @param tmin Minimum accepted relative distance along the line segment, inclusive.
+ * @param tmax Maximum accepted relative distance along the line segment, inclusive.
+ * @param t [out] Relative distance to intersection. Can be 0.
+ * @param u [out] Barycentric weight of v1 at intersection point. Can be 0.
+ * @param v [out] Barycentric weight of v2 at intersection point. Can be 0.
+ * @return true if intersect.
+ */
+bool	intersect_line_triangle_watertight( const intersect_line_triangle_line& line, const vec3& v0, const vec3& v1, const vec3& v2, float tmin, float tmax, float* t, float* u, float* v );
+
+/**
+ * Finds intersection between line segment and triangle without missing hits at shared edges and vertices.
+ * Relative distance of intersection is accepted in range [0,1], inclusive.
+ *
+ * @param o Starting point of the line segment.
+ * @param d Vector from starting point of the line segment to the end point.
+ * @param v0 Vertex 0 of the triangle.
+ * @param v1 Vertex 1 of the triangle.
+ * @param v2 Vertex 2 of the triangle.
+ * @param t [out] Relative distance [0,1] to intersection. Can be 0.
+ * @param u [out] Barycentric weight of v1 at intersection point. Can be 0.
+ * @param v [out] Barycentric weight of v2 at intersection point. Can be 0.
+ * @return true if intersect.
+ * @see intersect_line_triangle_watertight
+ */
+bool	intersect_line_triangle_watertight( const vec3& o, const vec3& d, const vec3& v0, const vec3& v1, const vec3& v2, float* t, float* u, float* v );
+
+/**
+ * Finds the nearest intersection between line segment and a block of four triangles.
+ * Uses the same watertight test as intersect_line_triangle_watertight, 
+ * but tests all four triangles at once using SIMD instructions.
+ * Meant for BVH leaf tests: pass distance to the closest hit found so far as tmax.
+ *
+ * @param line Line segment information.
+ * @param tri Four triangles to test.
+ * @param tmin Minimum accepted relative distance along the line segment, inclusive.
+ * @param tmax Maximum accepted relative distance along the line segment, inclusive.
+ * @param t [out] Relative distance to the nearest intersection. Can be 0.
+ * @param u [out] Barycentric weight of v1 at the nearest intersection point. Can be 0.
+ * @param v [out] Barycentric weight of v2 at the nearest intersection point. Can be 0.
+ * @return Index [0,3] of the nearest intersecting triangle, or -1 if none intersect.
+ */
+int		intersect_line_triangle4( const intersect_line_triangle_line& line, const triangle4& tri, float tmin, float tmax, float* t, float* u, float* v );
+
 /**
  * Finds if line segment and box intersect.
  *
@@ -87,6 +214,399 @@ bool	intersect_line_box( const vec3& o, const vec3& d, const vec3& boxmin, const
  */
 //bool	intersect_line_box( const intersect_line_box_line* line, const vec3* boxminmax );
 
+/**
+ * Separating axes of a triangle for triangle-box overlap tests, with the triangle projected to each axis.
+ * Calculated once per triangle, so testing many boxes against the same triangle is faster.
+ * @see intersect_triangle_box4
+ */
+class intersect_triangle_box_triangle
+{
+public:
+	enum Constants
+	{
+		/** Number of separating axes: 3 box face normals, triangle normal and 9 edge cross products. */
+		AXIS_COUNT = 13,
+	};
+
+	/** Candidate separating axes, not normalized. */
+	vec3	axis[AXIS_COUNT];
+	/** Minimum projection of the triangle vertices to each axis. */
+	float	pmin[AXIS_COUNT];
+	/** Maximum projection of the triangle vertices to each axis. */
+	float	pmax[AXIS_COUNT];
+
+	/** Calculates separating axes of triangle. */
+	intersect_triangle_box_triangle( const vec3& v0, const vec3& v1, const vec3& v2 );
+
+private:
+	intersect_triangle_box_triangle();
+	intersect_triangle_box_triangle( const intersect_triangle_box_triangle& );
+	intersect_triangle_box_triangle& operator=( const intersect_triangle_box_triangle& );
+};
+
+/**
+ * Finds if triangle and box overlap, using separating axis test.
+ * Touching triangle and box are considered overlapping.
+ *
+ * See: Tomas Akenine-Möller, "Fast 3D Triangle-Box Overlap Testing", Journal of Graphics Tools, 6(1):29-33, 2001.
+ *
+ * @param v0 Vertex 0 of the triangle.
+ * @param v1 Vertex 1 of the triangle.
+ * @param v2 Vertex 2 of the triangle.
+ * @param boxmin Minimum coordinates of the box.
+ * @param boxmax Maximum coordinates of the box.
+ * @return true if overlap.
+ */
+bool	intersect_triangle_box( const vec3& v0, const vec3& v1, const vec3& v2, const vec3& boxmin, const vec3& boxmax );
+
+/**
+ * Finds if triangle overlaps four boxes using SIMD instructions.
+ * @param tri Precalculated separating axes of the triangle.
+ * @param cx Box center X-coordinates.
+ * @param cy Box center Y-coordinates.
+ * @param cz Box center Z-coordinates.
+ * @param hx Box half sizes along X-axis.
+ * @param hy Box half sizes along Y-axis.
+ * @param hz Box half sizes along Z-axis.
+ * @return Bit mask of the overlapping boxes, bit i set if box i overlaps.
+ */
+int		intersect_triangle_box4( const intersect_triangle_box_triangle& tri, const m128_t& cx, const m128_t& cy, const m128_t& cz, const m128_t& hx, const m128_t& hy, const m128_t& hz );
+
+/**
+ * Finds which boxes of an array overlap a triangle, four boxes at a time.
+ * Boxes are given in structure-of-arrays form.
+ * @param v0 Vertex 0 of the triangle.
+ * @param v1 Vertex 1 of the triangle.
+ * @param v2 Vertex 2 of the triangle.
+ * @param minx Minimum X-coordinates of the boxes.
+ * @param miny Minimum Y-coordinates of the boxes.
+ * @param minz Minimum Z-coordinates of the boxes.
+ * @param maxx Maximum X-coordinates of the boxes.
+ * @param maxy Maximum Y-coordinates of the boxes.
+ * @param maxz Maximum Z-coordinates of the boxes.
+ * @param n Number of boxes.
+ * @param mask [out] Receives overlap bits, bit i%32 of mask[i/32] set if box i overlaps. Must have room for (n+31)/32 words.
+ */
+void	intersect_triangle_boxes_mask( const vec3& v0, const vec3& v1, const vec3& v2, const float* minx, const float* miny, const float* minz, const float* maxx, const float* maxy, const float* maxz, size_t n, unsigned int* mask );
+
+/**
+ * Ray query modes.
+ * @see ray
+ */
+enum ray_query
+{
+	/** Find the closest hit. Ray tmax is shrunk to each hit found, so further tests are clipped against it. */
+	RAY_CLOSEST_HIT,
+	/** Find any hit in [tmin,tmax], terminating at the first one. Meant for shadow and visibility queries. */
+	RAY_ANY_HIT,
+};
+
+/**
+ * Ray with explicit range [tmin,tmax] of accepted hits.
+ * Point at ray parameter t is origin + direction*t, so unlike with line segments
+ * the direction doesn't need to reach the end point and doesn't need to be normalized.
+ * Precalculates values needed by box and triangle tests, so the same ray object
+ * should be reused for every tested primitive.
+ *
+ * @see ray_query
+ */
+class ray
+{
+public:
+	/** Precalculated values for box tests. */
+	const intersect_line_box_line		box_line;
+	/** Precalculated values for triangle tests. */
+	const intersect_line_triangle_line	triangle_line;
+	/** Minimum ray parameter of accepted hits, inclusive. */
+	float								tmin;
+	/** Maximum ray parameter of accepted hits, inclusive. Closest hit queries shrink this to the closest hit found. */
+	float								tmax;
+
+	/** Sets ray origin and direction. Range of accepted hits is [0,FLT_MAX]. */
+	ray( const vec3& origin, const vec3& direction );
+
+	/** Sets ray origin, direction and range of accepted hits. */
+	ray( const vec3& origin, const vec3& direction, float tmin0, float tmax0 );
+
+	/** Returns ray origin. */
+	const vec3&	origin() const		{return box_line.o;}
+
+	/** Returns ray direction. */
+	const vec3&	direction() const	{return box_line.d;}
+
+	/** Returns point at specified ray parameter. */
+	vec3		at( float t ) const	{return box_line.o + box_line.d*t;}
+
+private:
+	ray();
+	ray( const ray& );
+	ray& operator=( const ray& );
+};
+
+/**
+ * Information about ray hit.
+ */
+class ray_hit
+{
+public:
+	/** Ray parameter at the hit point. */
+	float	t;
+	/** Barycentric weight of triangle vertex 1 at the hit point. 0 for non-triangle primitives. */
+	float	u;
+	/** Barycentric weight of triangle vertex 2 at the hit point. 0 for non-triangle primitives. */
+	float	v;
+	/** Index of the primitive hit. */
+	size_t	index;
+};
+
+/**
+ * Finds if ray and box intersect in ray range [tmin,tmax].
+ * Also true if the ray starts inside the box.
+ * @param r The ray.
+ * @param boxmin Minimum coordinates of the box.
+ * @param boxmax Maximum coordinates of the box.
+ * @param tnear [out] Ray parameter where the ray enters the box, clipped to ray tmin. Can be 0.
+ * @return true if intersect.
+ */
+bool	intersect_ray_box( const ray& r, const vec3& boxmin, const vec3& boxmax, float* tnear );
+
+/**
+ * Finds watertight intersection between ray and triangle in ray range [tmin,tmax].
+ * @param r The ray.
+ * @param v0 Vertex 0 of the triangle.
+ * @param v1 Vertex 1 of the triangle.
+ * @param v2 Vertex 2 of the triangle.
+ * @param t [out] Ray parameter at intersection. Can be 0.
+ * @param u [out] Barycentric weight of v1 at intersection point. Can be 0.
+ * @param v [out] Barycentric weight of v2 at intersection point. Can be 0.
+ * @return true if intersect.
+ * @see intersect_line_triangle_watertight
+ */
+bool	intersect_ray_triangle( const ray& r, const vec3& v0, const vec3& v1, const vec3& v2, float* t, float* u, float* v );
+
+/**
+ * Intersects ray with array of boxes.
+ * With RAY_CLOSEST_HIT finds the box entered first and clips ray tmax to it.
+ * With RAY_ANY_HIT returns at the first box intersecting the ray range.
+ * @param r The ray. tmax is updated in RAY_CLOSEST_HIT mode.
+ * @param mode Query mode.
+ * @param boxminmax Minimum and maximum coordinates of the boxes, so array [2*n] of vec3.
+ * @param n Number of boxes.
+ * @param hit [out] Receives ray parameter and index of the box hit. Can be 0.
+ * @return true if any box intersects.
+ */
+bool	intersect_ray_boxes( ray& r, ray_query mode, const vec3* boxminmax, size_t n, ray_hit* hit );
+
+/**
+ * Intersects ray with triangle mesh.
+ * With RAY_CLOSEST_HIT finds the closest triangle and clips ray tmax to it.
+ * With RAY_ANY_HIT returns at the first triangle intersecting the ray range.
+ * @param r The ray. tmax is updated in RAY_CLOSEST_HIT mode.
+ * @param mode Query mode.
+ * @param vertices Vertex positions.
+ * @param indices Three vertex indices per triangle. If 0, every three consecutive vertices form a triangle.
+ * @param n Number of triangles.
+ * @param hit [out] Receives hit information, index is triangle index. Can be 0.
+ * @return true if any triangle intersects.
+ */
+bool	intersect_ray_triangles( ray& r, ray_query mode, const vec3* vertices, const unsigned int* indices, size_t n, ray_hit* hit );
+
+/**
+ * Intersects ray with array of triangle4 blocks, four triangles at a time.
+ * With RAY_CLOSEST_HIT finds the closest triangle and clips ray tmax to it.
+ * With RAY_ANY_HIT returns at the first block with a triangle intersecting the ray range.
+ * @param r The ray. tmax is updated in RAY_CLOSEST_HIT mode.
+ * @param mode Query mode.
+ * @param blocks Triangle blocks.
+ * @param n Number of triangle blocks.
+ * @param hit [out] Receives hit information, index is block index*4 + triangle index within the block. Can be 0.
+ * @return true if any triangle intersects.
+ */
+bool	intersect_ray_triangle4s( ray& r, ray_query mode, const triangle4* blocks, size_t n, ray_hit* hit );
+
+/**
+ * Information about closest point on a surface.
+ */
+class closest_point_hit
+{
+public:
+	/** Closest point on the surface. */
+	vec3	point;
+	/** Distance from query point to the closest point. */
+	float	distance;
+	/** Barycentric weight of triangle vertex 1 at the closest point. */
+	float	u;
+	/** Barycentric weight of triangle vertex 2 at the closest point. */
+	float	v;
+	/** Index of the closest primitive. */
+	size_t	index;
+};
+
+/**
+ * Finds closest point on triangle to a point.
+ *
+ * See: Christer Ericson, "Real-Time Collision Detection", section 5.1.5.
+ *
+ * @param p The point.
+ * @param v0 Vertex 0 of the triangle.
+ * @param v1 Vertex 1 of the triangle.
+ * @param v2 Vertex 2 of the triangle.
+ * @param u [out] Barycentric weight of v1 at the closest point. Can be 0.
+ * @param v [out] Barycentric weight of v2 at the closest point. Can be 0.
+ * @return Closest point on the triangle.
+ */
+vec3	closest_point_triangle( const vec3& p, const vec3& v0, const vec3& v1, const vec3& v2, float* u, float* v );
+
+/**
+ * Finds closest points on four triangles to a point using SIMD instructions.
+ * Voronoi regions of the triangles are selected with masks instead of branches.
+ * Note that cleared triangles are points at the origin, so results of unused triangles need to be ignored.
+ * @param p The point.
+ * @param tri The triangles.
+ * @param dist2 [out] Squared distance to the closest point of each triangle. Array [4].
+ * @param u [out] Barycentric weight of vertex 1 at the closest point of each triangle. Array [4].
+ * @param v [out] Barycentric weight of vertex 2 at the closest point of each triangle. Array [4].
+ * @see closest_point_triangle
+ */
+void	closest_point_triangle4( const vec3& p, const triangle4& tri, float* dist2, float* u, float* v );
+
+/**
+ * Finds closest point on triangle mesh to a point.
+ * @param p The point.
+ * @param vertices Vertex positions.
+ * @param indices Three vertex indices per triangle. If 0, every three consecutive vertices form a triangle.
+ * @param n Number of triangles.
+ * @param maxdist Maximum distance of accepted points, inclusive.
+ * @param hit [out] Receives the closest point, index is triangle index. Can be 0.
+ * @return true if any triangle is within maxdist.
+ */
+bool	closest_point_triangles( const vec3& p, const vec3* vertices, const unsigned int* indices, size_t n, float maxdist, closest_point_hit* hit );
+
+/**
+ * Finds if ray and sphere intersect in ray range [tmin,tmax].
+ * The sphere is solid, so if the ray starts inside it the hit is at tmin.
+ * @param r The ray.
+ * @param center Center of the sphere.
+ * @param radius Radius of the sphere.
+ * @param t [out] Ray parameter where the ray enters the sphere, clipped to ray tmin. Can be 0.
+ * @return true if intersect.
+ */
+bool	intersect_ray_sphere( const ray& r, const vec3& center, float radius, float* t );
+
+/**
+ * Finds if ray crosses plane in ray range [tmin,tmax]. Rays parallel to the plane never intersect.
+ * @param r The ray.
+ * @param plane Plane (a,b,c,d) of points p where dot(vec3(a,b,c),p)+d = 0.
+ * @param t [out] Ray parameter at intersection. Can be 0.
+ * @return true if intersect.
+ */
+bool	intersect_ray_plane( const ray& r, const vec4& plane, float* t );
+
+/**
+ * Finds if ray and capsule intersect in ray range [tmin,tmax].
+ * The capsule is solid, so if the ray starts inside it the hit is at tmin.
+ * @param r The ray.
+ * @param p0 Start point of the capsule axis.
+ * @param p1 End point of the capsule axis.
+ * @param radius Radius of the capsule.
+ * @param t [out] Ray parameter where the ray enters the capsule, clipped to ray tmin. Can be 0.
+ * @return true if intersect.
+ */
+bool	intersect_ray_capsule( const ray& r, const vec3& p0, const vec3& p1, float radius, float* t );
+
+/**
+ * Finds if ray and oriented box intersect in ray range [tmin,tmax].
+ * The ray is transformed to box space, where the box is axis aligned.
+ * The box is solid, so if the ray starts inside it the hit is at tmin.
+ * @param r The ray.
+ * @param invtm Transform from world space to box space, i.e. inverse of the box transform. Must be affine.
+ * @param boxmin Minimum coordinates of the box in box space.
+ * @param boxmax Maximum coordinates of the box in box space.
+ * @param t [out] Ray parameter where the ray enters the box, clipped to ray tmin. Can be 0.
+ * @return true if intersect.
+ */
+bool	intersect_ray_obb( const ray& r, const mat4& invtm, const vec3& boxmin, const vec3& boxmax, float* t );
+
+/**
+ * Four rays in structure-of-arrays form, for testing packets of rays against the same primitive.
+ * Unused slots should be cleared, which gives them empty range so that they never intersect.
+ * Ray parameters of the rays have the same meaning as with ray.
+ * @see ray
+ */
+#ifdef SWIG
+class ray4
+#else
+SLMATH_ALIGN16 class ray4
+#endif
+{
+public:
+	enum Constants
+	{
+		/** Number of rays in the packet. */
+		SIZE = 4,
+	};
+
+	/** Ray origins, o[axis] holds the coordinates of all four rays. */
+	m128_t		o[3];
+	/** Ray directions, d[axis] holds the coordinates of all four rays. */
+	m128_t		d[3];
+	/** Minimum ray parameters of accepted hits, inclusive. */
+	m128_t		tmin;
+	/** Maximum ray parameters of accepted hits, inclusive. */
+	m128_t		tmax;
+
+	/** Sets ith ray of the packet. */
+	void		set( size_t i, const vec3& origin, const vec3& direction, float tmin0, float tmax0 );
+
+	/** Sets ith ray of the packet to never intersect anything. */
+	void		clear( size_t i );
+};
+
+/**
+ * Finds which rays of a packet intersect sphere.
+ * @param r The rays.
+ * @param center Center of the sphere.
+ * @param radius Radius of the sphere.
+ * @param t [out] Receives ray parameter of each intersecting ray. Array [4].
+ * @return Bit mask of the intersecting rays, bit i set if ray i intersects.
+ * @see intersect_ray_sphere
+ */
+int		intersect_ray4_sphere( const ray4& r, const vec3& center, float radius, float* t );
+
+/**
+ * Finds which rays of a packet cross plane.
+ * @param r The rays.
+ * @param plane Plane (a,b,c,d) of points p where dot(vec3(a,b,c),p)+d = 0.
+ * @param t [out] Receives ray parameter of each intersecting ray. Array [4].
+ * @return Bit mask of the intersecting rays, bit i set if ray i intersects.
+ * @see intersect_ray_plane
+ */
+int		intersect_ray4_plane( const ray4& r, const vec4& plane, float* t );
+
+/**
+ * Finds which rays of a packet intersect capsule.
+ * @param r The rays.
+ * @param p0 Start point of the capsule axis.
+ * @param p1 End point of the capsule axis.
+ * @param radius Radius of the capsule.
+ * @param t [out] Receives ray parameter of each intersecting ray. Array [4].
+ * @return Bit mask of the intersecting rays, bit i set if ray i intersects.
+ * @see intersect_ray_capsule
+ */
+int		intersect_ray4_capsule( const ray4& r, const vec3& p0, const vec3& p1, float radius, float* t );
+
+/**
+ * Finds which rays of a packet intersect oriented box.
+ * @param r The rays.
+ * @param invtm Transform from world space to box space, i.e. inverse of the box transform. Must be affine.
+ * @param boxmin Minimum coordinates of the box in box space.
+ * @param boxmax Maximum coordinates of the box in box space.
+ * @param t [out] Receives ray parameter of each intersecting ray. Array [4].
+ * @return Bit mask of the intersecting rays, bit i set if ray i intersects.
+ * @see intersect_ray_obb
+ */
+int		intersect_ray4_obb( const ray4& r, const mat4& invtm, const vec3& boxmin, const vec3& boxmax, float* t );
+
 /*@}*/
 
 SLMATH_END()
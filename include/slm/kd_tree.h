@@ -0,0 +1,105 @@
+#ifndef SLMATH_KD_TREE_H
+#define SLMATH_KD_TREE_H
+
+#include <slm/vec3.h>
+#include <slm/vector_simd.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Implicit k-d tree of points, for nearest neighbour and radius queries over large point clouds.
+ *
+ * The tree has no nodes: points are reordered so that the median point of each range splits it,
+ * and the children are the ranges before and after the median. Only the split axis is stored
+ * per point, so the tree takes one byte per point on top of the points and their indices,
+ * and subtrees are contiguous in memory. Small ranges are scanned linearly.
+ *
+ * Queries are const and don't modify the tree, so several threads can query it at the same time.
+ * Batch queries visit the query points in Morton order, so consecutive queries touch the same
+ * parts of the tree; to process a batch with multiple threads, give each thread its own range of queries.
+ *
+ * @ingroup spatial_util
+ */
+class kd_tree
+{
+public:
+	enum Constants
+	{
+		/** Ranges of at most this many points are scanned linearly. */
+		LEAF_SIZE = 8,
+		/** Traversal stack size, enough for any tree with less than 2^32 points. */
+		STACK_SIZE = 64,
+	};
+
+	/** Constructs empty tree. */
+	kd_tree();
+
+	/**
+	 * Rebuilds the tree from an array of points. Point indices refer to this array.
+	 * @param points Point positions. Positions are copied, so the array doesn't need to be kept.
+	 * @param n Number of points.
+	 */
+	void		build( const vec3* points, size_t n );
+
+	/**
+	 * Finds points within specified distance of a point.
+	 * @param p Query point.
+	 * @param radius Query radius, inclusive.
+	 * @param out [out] Receives indices of found points in no particular order.
+	 * @param maxout Maximum number of indices to store to out.
+	 * @return Number of points found. Can be larger than maxout, in which case only maxout indices were stored.
+	 */
+	size_t		query_radius( const vec3& p, float radius, size_t* out, size_t maxout ) const;
+
+	/**
+	 * Finds k nearest points to a point.
+	 * @param p Query point.
+	 * @param k Number of points to find.
+	 * @param out [out] Receives indices of found points, nearest first. Must have room for k indices.
+	 * @param outdist [out] Receives distances of found points. Must have room for k values. Can be 0.
+	 * @return Number of points found, k unless there are less than k points in the tree.
+	 */
+	size_t		query_nearest( const vec3& p, size_t k, size_t* out, float* outdist ) const;
+
+	/**
+	 * Finds k nearest points to each query point of a range.
+	 * @param queries Query points.
+	 * @param first First query point to process.
+	 * @param count Number of query points to process.
+	 * @param k Number of points to find per query.
+	 * @param out [out] Receives indices of found points of query i to out[i*k..], nearest first. If less than k points are found, the rest are left untouched.
+	 * @param outdist [out] Receives distances of found points of query i to outdist[i*k..]. Can be 0.
+	 */
+	void		query_nearest_batch( const vec3* queries, size_t first, size_t count, size_t k, size_t* out, float* outdist ) const;
+
+	/**
+	 * Finds points within specified distance of each query point of a range.
+	 * @param queries Query points.
+	 * @param first First query point to process.
+	 * @param count Number of query points to process.
+	 * @param radius Query radius, inclusive.
+	 * @param maxout Maximum number of indices to store per query.
+	 * @param out [out] Receives indices of found points of query i to out[i*maxout..] in no particular order.
+	 * @param counts [out] Receives number of points found for query i to counts[i]. Can be larger than maxout.
+	 */
+	void		query_radius_batch( const vec3* queries, size_t first, size_t count, float radius, size_t maxout, size_t* out, size_t* counts ) const;
+
+	/** Returns number of points in the tree. */
+	size_t		size() const				{return m_points.size();}
+
+private:
+	vector_simd<vec3>			m_points;
+	vector_simd<size_t>			m_indices;
+	vector_simd<unsigned char>	m_axis;
+
+	size_t		query_nearest_dist2( const vec3& p, size_t k, size_t* out, float* dist2 ) const;
+
+	kd_tree( const kd_tree& );
+	kd_tree& operator=( const kd_tree& );
+};
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
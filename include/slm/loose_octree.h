@@ -0,0 +1,132 @@
+#ifndef SLMATH_LOOSE_OCTREE_H
+#define SLMATH_LOOSE_OCTREE_H
+
+#include <slm/frustum.h>
+#include <slm/intersect_util.h>
+#include <slm/vector_simd.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Loose octree of moving objects with box bounds.
+ *
+ * Bounds of each cell are extended by half of the cell size in every direction,
+ * so an object is stored to the deepest level where its size is at most the cell size,
+ * to the cell containing the center of the object. Level and cell are found in constant time,
+ * and while an object stays inside the loose bounds of its cell, updating it only copies the new bounds.
+ *
+ * All levels are stored as dense arrays of cells, so depth should be kept small, 8^depth cells
+ * are allocated for the deepest level. Each cell keeps count of objects in its subtree, so empty
+ * parts of the tree are skipped in queries.
+ *
+ * Objects are identified by user given indices, which should be kept small since arrays
+ * are allocated up to the largest index used.
+ *
+ * @ingroup spatial_util
+ */
+class loose_octree
+{
+public:
+	enum Constants
+	{
+		/** Maximum number of levels. */
+		MAX_DEPTH = 9,
+	};
+
+	/**
+	 * Constructs empty octree.
+	 * @param boundsmin Minimum coordinates of the root cell. Objects outside the root are stored to the root.
+	 * @param size Size of the root cell.
+	 * @param depth Number of levels, in range [1,MAX_DEPTH].
+	 */
+	loose_octree( const vec3& boundsmin, float size, size_t depth );
+
+	/**
+	 * Inserts object to the tree.
+	 * @param id Object index. Must not be in the tree.
+	 * @param boxmin Minimum coordinates of the object bounds.
+	 * @param boxmax Maximum coordinates of the object bounds.
+	 */
+	void		insert( size_t id, const vec3& boxmin, const vec3& boxmax );
+
+	/**
+	 * Updates bounds of object in the tree. Object is kept in its cell while it fits the loose bounds of the cell,
+	 * so it may stay at a shallower level than insert would choose.
+	 * @param id Object index. Must be in the tree.
+	 * @param boxmin Minimum coordinates of the object bounds.
+	 * @param boxmax Maximum coordinates of the object bounds.
+	 */
+	void		update( size_t id, const vec3& boxmin, const vec3& boxmax );
+
+	/**
+	 * Removes object from the tree.
+	 * @param id Object index. Must be in the tree.
+	 */
+	void		remove( size_t id );
+
+	/** Returns true if object is in the tree. */
+	bool		contains( size_t id ) const				{return id < m_cell.size() && m_cell[id] != unsigned(NONE);}
+
+	/** Returns number of objects in the tree. */
+	size_t		size() const							{return m_count;}
+
+	/**
+	 * Finds objects with bounds intersecting view frustum.
+	 * @param f The frustum.
+	 * @param out [out] Receives indices of found objects in no particular order.
+	 * @param maxout Maximum number of indices to store to out.
+	 * @return Number of objects found. Can be larger than maxout, in which case only maxout indices were stored.
+	 */
+	size_t		query_frustum( const frustum& f, size_t* out, size_t maxout ) const;
+
+	/**
+	 * Finds objects with bounds intersecting ray range [tmin,tmax].
+	 * @param r The ray.
+	 * @param out [out] Receives indices of found objects in no particular order.
+	 * @param maxout Maximum number of indices to store to out.
+	 * @return Number of objects found. Can be larger than maxout, in which case only maxout indices were stored.
+	 */
+	size_t		query_ray( const ray& r, size_t* out, size_t maxout ) const;
+
+	/**
+	 * Finds objects with bounds intersecting sphere.
+	 * @param center Center of the sphere.
+	 * @param radius Radius of the sphere.
+	 * @param out [out] Receives indices of found objects in no particular order.
+	 * @param maxout Maximum number of indices to store to out.
+	 * @return Number of objects found. Can be larger than maxout, in which case only maxout indices were stored.
+	 */
+	size_t		query_sphere( const vec3& center, float radius, size_t* out, size_t maxout ) const;
+
+private:
+	enum { NONE = 0x7FFFFFFF };
+
+	vec3						m_boundsmin;
+	float						m_size;
+	size_t						m_depth;
+	size_t						m_count;
+	size_t						m_leveloffset[MAX_DEPTH+1];
+	vector_simd<unsigned int>	m_head;
+	vector_simd<unsigned int>	m_subtree;
+	vector_simd<vec3>			m_boxmin;
+	vector_simd<vec3>			m_boxmax;
+	vector_simd<unsigned int>	m_cell;
+	vector_simd<unsigned int>	m_next;
+	vector_simd<unsigned int>	m_prev;
+
+	size_t		find_cell( const vec3& boxmin, const vec3& boxmax ) const;
+	bool		fits_cell( size_t cell, const vec3& boxmin, const vec3& boxmax ) const;
+	void		link( size_t id, size_t cell );
+	void		unlink( size_t id );
+	template <class T> size_t	query( const T& test, size_t* out, size_t maxout ) const;
+
+	loose_octree();
+	loose_octree( const loose_octree& );
+	loose_octree& operator=( const loose_octree& );
+};
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,230 @@
+#ifndef SLMATH_MAT3_H
+#define SLMATH_MAT3_H
+
+#include <slm/mat4.h>
+
+SLMATH_BEGIN()
+
+class quat;
+
+/** 
+ * 3x3 matrix. Columns vectors, column-major ordering, same semantics as mat4 and GLSL mat3.
+ * Each column is padded to 4 floats with zero W-component, so columns are multiplied with SIMD 
+ * like mat4 columns, and the matrix can be uploaded as std140 mat3 as is.
+ *
+ * Typical use is transforming normals: normal_matrix(m) gives inverse-transpose
+ * of the upper 3x3 part of a mat4 without computing full 4x4 inverse.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup mat_util
+ */
+#ifdef SWIG
+class mat3
+#else
+SLMATH_ALIGN16 class mat3
+#endif
+{
+public:
+	/** Constants related to the class. */
+	enum Constants
+	{
+		/** Number of floats including padding. */
+		SIZE = 12,
+	};
+
+	/** Constructs undefined matrix. In _DEBUG build the matrix is initialized to NaN. */
+	mat3();
+
+	/** 
+	 * Constructs diagonal matrix. All diagonal elements specified value, rest 0. 
+	 * @param d All diagonal elements are set to this value.
+	 */
+	explicit mat3( float d );
+
+	/**
+	 * Constructs matrix from upper left 3x3 part of 4x4 matrix.
+	 */
+	explicit mat3( const mat4& m );
+
+	/**
+	 * Constructs rotation matrix from quaternion.
+	 */
+	explicit mat3( const quat& q );
+
+	/**
+	 * Constructs rotation matrix from angle-axis.
+	 * @param a Rotation angle in radians.
+	 * @param v Rotation axis.
+	 */
+	mat3( float a, const vec3& v );
+
+	/** 
+	 * Constructs matrix from 3 column vectors.
+	 */
+	mat3( const vec3& c0, const vec3& c1, const vec3& c2 );
+
+	/** Sets ith column. */
+	void			set( size_t i, const vec3& v );
+
+	/** Returns specified column vector (0-based index). */
+	vec3&			operator[]( size_t i );
+
+	/** Component wise addition. */
+	mat3&			operator+=( const mat3& o );
+
+	/** Component wise subtraction. */
+	mat3&			operator-=( const mat3& o );
+
+	/** Component wise scalar multiplication. */
+	mat3&			operator*=( float s );
+
+	/** Matrix multiplication. */
+	mat3&			operator*=( const mat3& o );
+
+	/** Returns pointer to the first float. */
+	float*			begin()			{return &m_cols[0].v.x;}
+
+	/** Returns pointer to one beyond the last float. */
+	float*			end()			{return &m_cols[0].v.x+SIZE;}
+
+	/** Returns ith column. */
+	vec3			get( size_t i ) const;
+
+	/** Component wise equality. */
+	bool			operator==( const mat3& o ) const;
+
+	/** Component wise inequality. */
+	bool			operator!=( const mat3& o ) const;
+
+	/** Component wise addition. */
+	mat3			operator+( const mat3& o ) const;
+
+	/** Component wise subtraction. */
+	mat3			operator-( const mat3& o ) const;
+
+	/** Component wise subtraction. */
+	mat3			operator-() const;
+
+	/** Component wise scalar multiplication. */
+	mat3			operator*( float s ) const;
+
+	/** Matrix multiplication. */
+	mat3			operator*( const mat3& o ) const;
+
+	/** Returns specified column vector (0-based index). */
+	vec3			operator[]( size_t i ) const;
+
+	/** Returns const pointer to the first float. */
+	const float*	begin() const	{return &m_cols[0].v.x;}
+
+	/** Returns const pointer to one beyond the last float. */
+	const float*	end() const		{return &m_cols[0].v.x+SIZE;}
+
+private:
+	/** Column vector padded to 16 bytes, so columns can be returned as vec3 and loaded with SIMD. */
+	class column
+	{
+	public:
+		vec3	v;
+		float	w;
+	};
+
+	/** Column vectors, W-components are 0. */
+	column			m_cols[3];
+
+	/** Loads ith column with SIMD. */
+	m128_t			load( size_t i ) const		{return SLMATH_LOAD_PS( &m_cols[i].v.x );}
+
+	/** Stores ith column from SIMD register. */
+	void			store( size_t i, m128_t v )	{SLMATH_STORE_PS( &m_cols[i].v.x, v );}
+};
+
+/** 
+ * Transform column vector by matrix. 
+ * @param v Column vector be multiplied by matrix.
+ * @param m Matrix multiplying column vector.
+ * @ingroup mat_util
+ */
+vec3	operator*( const mat3& m, const vec3& v );
+
+/** 
+ * Transform row vector by matrix. 
+ * @param v Row vector be multiplied by matrix.
+ * @param m Matrix multiplying column vector.
+ * @ingroup mat_util
+ */
+vec3	operator*( const vec3& v, const mat3& m );
+
+/** 
+ * Transform column vector by matrix. 
+ * Same as operator*, but for scripting languages not supporting operator overloading.
+ * @param v Column vector be multiplied by matrix.
+ * @param m Matrix multiplying column vector.
+ * @ingroup mat_util
+ */
+vec3	mul( const mat3& m, const vec3& v );
+
+/** 
+ * Transform row vector by matrix. 
+ * @param v Row vector be multiplied by matrix.
+ * @param m Matrix multiplying column vector.
+ * @ingroup mat_util
+ */
+vec3	mul( const vec3& v, const mat3& m );
+
+/** 
+ * Swaps column and row vectors with each other. 
+ * @param m Matrix to be transposed.
+ * @return Transposed matrix.
+ * @ingroup mat_util
+ */
+mat3	transpose( const mat3& m );
+
+/** 
+ * Returns inverse of the matrix.
+ * @param m Matrix to be inverted.
+ * @return Inverted matrix.
+ * @ingroup mat_util
+ */
+mat3	inverse( const mat3& m );
+
+/** 
+ * Returns transpose of the inverse of the matrix.
+ * Columns of the result are cross products of the columns of m divided by determinant, 
+ * so this is cheaper than transpose(inverse(m)).
+ * @param m Matrix to be inverted.
+ * @return Inverse-transpose of the matrix.
+ * @ingroup mat_util
+ */
+mat3	inverse_transpose( const mat3& m );
+
+/** 
+ * Returns normal matrix of a transform, i.e. inverse-transpose of its upper left 3x3 part.
+ * Transformed normals need to be normalized if the transform has scaling.
+ * @param m Transform of positions.
+ * @return Transform of normals.
+ * @ingroup mat_util
+ */
+mat3	normal_matrix( const mat4& m );
+
+/**
+ * Returns determinant of the matrix.
+ * @ingroup mat_util
+ */
+float	det( const mat3& m );
+
+/** 
+ * Returns true if all components of the matrix are valid numbers. 
+ * @ingroup mat_util
+ */
+bool	check( const mat3& v );
+
+#include <slm/mat3.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,70 @@
+inline mat3::mat3()
+{
+#ifdef _DEBUG
+	const int nan = 0x7F800001;
+	float* p = begin();
+	for ( size_t i = 0 ; i < SIZE ; ++i ) 
+		p[i] = ( 3 == (i&3) ? 0.f : *(const float*)&nan );
+#endif
+}
+
+inline void mat3::set( size_t i, const vec3& v )
+{
+	SLMATH_VEC_ASSERT( i < 3 );
+	m_cols[i].v = v;
+	m_cols[i].w = 0.f;
+}
+
+inline vec3 mat3::get( size_t i ) const
+{
+	SLMATH_VEC_ASSERT( i < 3 );
+	const float* const p = begin() + i*4;
+	return vec3( p[0], p[1], p[2] );
+}
+
+inline vec3& mat3::operator[]( size_t i )
+{
+	SLMATH_VEC_ASSERT( i < 3 );
+	return m_cols[i].v;
+}
+
+inline vec3 mat3::operator[]( size_t i ) const
+{
+	return get( i );
+}
+
+inline vec3 operator*( const vec3& v, const mat3& m )
+{
+	SLMATH_VEC_ASSERT( check(v) );
+	SLMATH_VEC_ASSERT( check(m) );
+	return vec3( dot(v,m[0]), dot(v,m[1]), dot(v,m[2]) );
+}
+
+inline vec3 operator*( const mat3& m, const vec3& v )
+{
+	SLMATH_VEC_ASSERT( check(v) );
+	SLMATH_VEC_ASSERT( check(m) );
+	return m[0]*v.x + m[1]*v.y + m[2]*v.z;
+}
+
+inline vec3 mul( const mat3& m, const vec3& v )
+{
+	return m*v;
+}
+
+inline vec3 mul( const vec3& v, const mat3& m )
+{
+	return v*m;
+}
+
+inline mat3 normal_matrix( const mat4& m )
+{
+	return inverse_transpose( mat3(m) );
+}
+
+inline bool check( const mat3& v )
+{
+	return check( v.begin(), mat3::SIZE );
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,112 @@
+#ifndef SLMATH_MORTON_H
+#define SLMATH_MORTON_H
+
+#include <slm/vec3.h>
+
+SLMATH_BEGIN()
+
+/**
+ * \defgroup morton_util Morton codes and sorting by them.
+ * Morton code interleaves bits of quantized coordinates, so sorting points by the code
+ * orders them along a Z-order space filling curve, keeping nearby points close to each other.
+ * @ingroup slm
+ */
+/*@{*/
+
+/** Spreads the lowest 10 bits of x so that there are two zero bits between each. */
+inline unsigned int			morton_expand10( unsigned int x )
+{
+	x &= 0x3FFu;
+	x = (x | (x << 16)) & 0x030000FFu;
+	x = (x | (x << 8)) & 0x0300F00Fu;
+	x = (x | (x << 4)) & 0x030C30C3u;
+	x = (x | (x << 2)) & 0x09249249u;
+	return x;
+}
+
+/** Spreads the lowest 21 bits of x so that there are two zero bits between each. */
+inline unsigned long long	morton_expand21( unsigned long long x )
+{
+	x &= 0x1FFFFFull;
+	x = (x | (x << 32)) & 0x1F00000000FFFFull;
+	x = (x | (x << 16)) & 0x1F0000FF0000FFull;
+	x = (x | (x << 8)) & 0x100F00F00F00F00Full;
+	x = (x | (x << 4)) & 0x10C30C30C30C30C3ull;
+	x = (x | (x << 2)) & 0x1249249249249249ull;
+	return x;
+}
+
+/**
+ * Returns 30-bit Morton code of integer coordinates, X in the highest bit of each triplet.
+ * @param x X-coordinate in range [0,1023].
+ * @param y Y-coordinate in range [0,1023].
+ * @param z Z-coordinate in range [0,1023].
+ */
+inline unsigned int			morton_encode30( unsigned int x, unsigned int y, unsigned int z )
+{
+	return (morton_expand10(x) << 2) | (morton_expand10(y) << 1) | morton_expand10(z);
+}
+
+/**
+ * Returns 63-bit Morton code of integer coordinates, X in the highest bit of each triplet.
+ * @param x X-coordinate in range [0,2097151].
+ * @param y Y-coordinate in range [0,2097151].
+ * @param z Z-coordinate in range [0,2097151].
+ */
+inline unsigned long long	morton_encode63( unsigned int x, unsigned int y, unsigned int z )
+{
+	return (morton_expand21(x) << 2) | (morton_expand21(y) << 1) | morton_expand21(z);
+}
+
+/**
+ * Computes 30-bit Morton codes of points. Points are normalized to the box and quantized to 10 bits per axis,
+ * four points at a time with SIMD. Points outside the box are clamped to it.
+ * @param points The points.
+ * @param n Number of points.
+ * @param boxmin Minimum coordinates of the box.
+ * @param boxmax Maximum coordinates of the box.
+ * @param codes [out] Receives the codes. Array [n].
+ */
+void	morton_codes30( const vec3* points, size_t n, const vec3& boxmin, const vec3& boxmax, unsigned int* codes );
+
+/**
+ * Computes 63-bit Morton codes of points. Points are normalized to the box and quantized to 21 bits per axis,
+ * four points at a time with SIMD. Points outside the box are clamped to it.
+ * @param points The points.
+ * @param n Number of points.
+ * @param boxmin Minimum coordinates of the box.
+ * @param boxmax Maximum coordinates of the box.
+ * @param codes [out] Receives the codes. Array [n].
+ */
+void	morton_codes63( const vec3* points, size_t n, const vec3& boxmin, const vec3& boxmax, unsigned long long* codes );
+
+/**
+ * Sorts 32-bit keys to ascending order, reordering values along.
+ * Least significant digit radix sort, 8 bits per pass. Stable, and passes where all keys
+ * have the same digit are skipped, so e.g. codes of less than 24 bits take only three passes.
+ * @param keys [in/out] The keys.
+ * @param values [in/out] Values associated with the keys, e.g. indices of the sorted items.
+ * @param n Number of keys.
+ * @param tempkeys Temporary buffer. Array [n].
+ * @param tempvalues Temporary buffer. Array [n].
+ */
+void	radix_sort( unsigned int* keys, unsigned int* values, size_t n, unsigned int* tempkeys, unsigned int* tempvalues );
+
+/**
+ * Sorts 64-bit keys to ascending order, reordering values along.
+ * Least significant digit radix sort, 8 bits per pass, skipping passes where all keys have the same digit.
+ * @param keys [in/out] The keys.
+ * @param values [in/out] Values associated with the keys, e.g. indices of the sorted items.
+ * @param n Number of keys.
+ * @param tempkeys Temporary buffer. Array [n].
+ * @param tempvalues Temporary buffer. Array [n].
+ */
+void	radix_sort( unsigned long long* keys, unsigned int* values, size_t n, unsigned long long* tempkeys, unsigned int* tempvalues );
+
+/*@}*/
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,163 @@
+#ifndef SLMATH_OCTAHEDRAL_H
+#define SLMATH_OCTAHEDRAL_H
+
+#include <slm/vec3.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Unit vector packed to 24 bits with octahedral encoding, see pack_oct24.
+ * @ingroup vec_util
+ */
+class oct24
+{
+public:
+	/** Packed bits, least significant 8 bits first. */
+	unsigned char	v[3];
+};
+
+/**
+ * Packs unit vector to 16 bits with octahedral encoding: the vector is projected to the octahedron |x|+|y|+|z|=1,
+ * the lower half is folded over the upper half, and the resulting square is quantized to 8 bits per axis.
+ * Axis vectors are exact. Maximum angle error is about 0.017 radians (1 degree).
+ * @param v Unit vector.
+ * @return Packed vector.
+ * @ingroup vec_util
+ */
+unsigned short	pack_oct16( const vec3& v );
+
+/**
+ * Packs unit vector to 24 bits with octahedral encoding, 12 bits per axis.
+ * Maximum angle error is about 0.001 radians (0.06 degrees).
+ * @param v Unit vector.
+ * @return Packed vector.
+ * @ingroup vec_util
+ */
+oct24			pack_oct24( const vec3& v );
+
+/**
+ * Packs unit vector to 32 bits with octahedral encoding, 16 bits per axis.
+ * Maximum angle error is about 0.000065 radians (0.004 degrees).
+ * @param v Unit vector.
+ * @return Packed vector.
+ * @ingroup vec_util
+ */
+unsigned int	pack_oct32( const vec3& v );
+
+/**
+ * Packs unit vector to 16 bits like pack_oct16, but picks the rounding of the two axes 
+ * which gives the smallest angle error after unpacking. Slower than pack_oct16, since four candidates
+ * are unpacked per vector. Maximum angle error is about 0.011 radians (0.65 degrees).
+ * @param v Unit vector.
+ * @return Packed vector.
+ * @ingroup vec_util
+ */
+unsigned short	pack_oct16_precise( const vec3& v );
+
+/**
+ * Packs unit vector to 24 bits like pack_oct24, but picks the rounding which gives the smallest angle error.
+ * Maximum angle error is about 0.0007 radians (0.04 degrees).
+ * @param v Unit vector.
+ * @return Packed vector.
+ * @ingroup vec_util
+ */
+oct24			pack_oct24_precise( const vec3& v );
+
+/**
+ * Packs unit vector to 32 bits like pack_oct32, but picks the rounding which gives the smallest angle error.
+ * Maximum angle error is about 0.000045 radians (0.003 degrees).
+ * @param v Unit vector.
+ * @return Packed vector.
+ * @ingroup vec_util
+ */
+unsigned int	pack_oct32_precise( const vec3& v );
+
+/**
+ * Unpacks vector packed to 16 bits with octahedral encoding.
+ * @param v Packed vector.
+ * @return Unit vector.
+ * @ingroup vec_util
+ */
+vec3			unpack_oct16( unsigned short v );
+
+/**
+ * Unpacks vector packed to 24 bits with octahedral encoding.
+ * @param v Packed vector.
+ * @return Unit vector.
+ * @ingroup vec_util
+ */
+vec3			unpack_oct24( const oct24& v );
+
+/**
+ * Unpacks vector packed to 32 bits with octahedral encoding.
+ * @param v Packed vector.
+ * @return Unit vector.
+ * @ingroup vec_util
+ */
+vec3			unpack_oct32( unsigned int v );
+
+/**
+ * Packs array of unit vectors to 16 bits each, four vectors at a time with SIMD.
+ * Results are the same as with pack_oct16 or pack_oct16_precise.
+ * @param v Unit vectors.
+ * @param n Number of vectors.
+ * @param out [out] Receives n packed vectors.
+ * @param precise true to pick the rounding with the smallest angle error.
+ * @ingroup vec_util
+ */
+void			pack_oct16( const vec3* v, size_t n, unsigned short* out, bool precise );
+
+/**
+ * Packs array of unit vectors to 24 bits each, four vectors at a time with SIMD.
+ * Results are the same as with pack_oct24 or pack_oct24_precise.
+ * @param v Unit vectors.
+ * @param n Number of vectors.
+ * @param out [out] Receives n packed vectors.
+ * @param precise true to pick the rounding with the smallest angle error.
+ * @ingroup vec_util
+ */
+void			pack_oct24( const vec3* v, size_t n, oct24* out, bool precise );
+
+/**
+ * Packs array of unit vectors to 32 bits each, four vectors at a time with SIMD.
+ * Results are the same as with pack_oct32 or pack_oct32_precise.
+ * @param v Unit vectors.
+ * @param n Number of vectors.
+ * @param out [out] Receives n packed vectors.
+ * @param precise true to pick the rounding with the smallest angle error.
+ * @ingroup vec_util
+ */
+void			pack_oct32( const vec3* v, size_t n, unsigned int* out, bool precise );
+
+/**
+ * Unpacks array of vectors packed to 16 bits, four vectors at a time with SIMD.
+ * @param v Packed vectors.
+ * @param n Number of vectors.
+ * @param out [out] Receives n unit vectors.
+ * @ingroup vec_util
+ */
+void			unpack_oct16( const unsigned short* v, size_t n, vec3* out );
+
+/**
+ * Unpacks array of vectors packed to 24 bits, four vectors at a time with SIMD.
+ * @param v Packed vectors.
+ * @param n Number of vectors.
+ * @param out [out] Receives n unit vectors.
+ * @ingroup vec_util
+ */
+void			unpack_oct24( const oct24* v, size_t n, vec3* out );
+
+/**
+ * Unpacks array of vectors packed to 32 bits, four vectors at a time with SIMD.
+ * @param v Packed vectors.
+ * @param n Number of vectors.
+ * @param out [out] Receives n unit vectors.
+ * @ingroup vec_util
+ */
+void			unpack_oct32( const unsigned int* v, size_t n, vec3* out );
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -204,6 +204,12 @@ quat		slerp( const quat& a, const quat& b, float u );
  */
 void		to_angle_axis( const quat& q, float* angle, vec3* axis );
 
+/** 
+ * Rotates vector by unit quaternion. 
+ * @ingroup quat_util
+ */
+vec3		rotate( const quat& q, const vec3& v );
+
 #include <slm/quat.inl>
 
 SLMATH_END()
@@ -112,6 +112,12 @@ inline float dot( const quat& a, const quat& b )
 	return res;
 }
 
+inline vec3 rotate( const quat& q, const vec3& v )
+{
+	const vec3 qv( q.x, q.y, q.z );
+	return v + cross( qv, cross(qv,v) + v*q.w ) * 2.f;
+}
+
 inline bool quat::operator==( const quat& o ) const
 {
 	return x == o.x && y == o.y && z == o.z && z == o.z && w == o.w;
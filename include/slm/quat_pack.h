@@ -0,0 +1,108 @@
+#ifndef SLMATH_QUAT_PACK_H
+#define SLMATH_QUAT_PACK_H
+
+#include <slm/quat.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Unit quaternion packed to 48 bits with smallest-three encoding, see pack_quat48.
+ * @ingroup quat_util
+ */
+class quat48
+{
+public:
+	/** Packed bits, least significant 16 bits first. */
+	unsigned short	v[3];
+};
+
+/**
+ * Packs unit quaternion to 32 bits with smallest-three encoding: index of the largest component 
+ * in 2 bits, and the other three components quantized to 10 bits each. The largest component
+ * is reconstructed from unit length, and its sign is made positive since q and -q are the same rotation.
+ * Maximum rotation error is about 0.0045 radians (0.26 degrees).
+ * @param q Unit quaternion.
+ * @return Packed quaternion.
+ * @ingroup quat_util
+ */
+unsigned int	pack_quat32( const quat& q );
+
+/**
+ * Unpacks quaternion packed with pack_quat32.
+ * @param v Packed quaternion.
+ * @return Unit quaternion.
+ * @ingroup quat_util
+ */
+quat			unpack_quat32( unsigned int v );
+
+/**
+ * Packs unit quaternion to 48 bits with smallest-three encoding, like pack_quat32 but components quantized to 15 bits each.
+ * Maximum rotation error is about 0.00014 radians (0.008 degrees).
+ * @param q Unit quaternion.
+ * @return Packed quaternion.
+ * @ingroup quat_util
+ */
+quat48			pack_quat48( const quat& q );
+
+/**
+ * Unpacks quaternion packed with pack_quat48.
+ * @param v Packed quaternion.
+ * @return Unit quaternion.
+ * @ingroup quat_util
+ */
+quat			unpack_quat48( const quat48& v );
+
+/**
+ * Packs array of unit quaternions to 32 bits each, four quaternions at a time with SIMD.
+ * Results are the same as with pack_quat32.
+ * @param q Unit quaternions.
+ * @param n Number of quaternions.
+ * @param out [out] Receives n packed quaternions.
+ * @param maxerror [out] Receives maximum rotation error of the packed quaternions in radians. Measured by unpacking, so pass 0 if not needed.
+ * @ingroup quat_util
+ */
+void			pack_quat32( const quat* q, size_t n, unsigned int* out, float* maxerror );
+
+/**
+ * Unpacks array of quaternions packed to 32 bits, four quaternions at a time with SIMD.
+ * @param v Packed quaternions.
+ * @param n Number of quaternions.
+ * @param out [out] Receives n unit quaternions.
+ * @ingroup quat_util
+ */
+void			unpack_quat32( const unsigned int* v, size_t n, quat* out );
+
+/**
+ * Packs array of unit quaternions to 48 bits each, four quaternions at a time with SIMD.
+ * Results are the same as with pack_quat48.
+ * @param q Unit quaternions.
+ * @param n Number of quaternions.
+ * @param out [out] Receives n packed quaternions.
+ * @param maxerror [out] Receives maximum rotation error of the packed quaternions in radians. Measured by unpacking, so pass 0 if not needed.
+ * @ingroup quat_util
+ */
+void			pack_quat48( const quat* q, size_t n, quat48* out, float* maxerror );
+
+/**
+ * Unpacks array of quaternions packed to 48 bits, four quaternions at a time with SIMD.
+ * @param v Packed quaternions.
+ * @param n Number of quaternions.
+ * @param out [out] Receives n unit quaternions.
+ * @ingroup quat_util
+ */
+void			unpack_quat48( const quat48* v, size_t n, quat* out );
+
+/**
+ * Returns angle of the rotation between two unit quaternions, treating q and -q as the same rotation.
+ * @param a Unit quaternion.
+ * @param b Unit quaternion.
+ * @return Rotation angle in radians.
+ * @ingroup quat_util
+ */
+float			rotation_error( const quat& a, const quat& b );
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -14,6 +14,12 @@ SLMATH_BEGIN()
 /** Returns true if CPU supports SSE2 instruction set. */
 bool isSSE2CPU();
 
+/** Returns true if CPU and OS support AVX instruction set. */
+bool isAVXCPU();
+
+/** Returns true if CPU and OS support F16C half precision conversion instructions. Detected with MSVC, and with GCC and clang on x86. */
+bool isF16CCPU();
+
 /** Returns true if current compilation options match platform capabilities. */
 bool isValidCPU();
 
@@ -4,6 +4,7 @@
 #ifndef SLMATH_PP_H
 #include <slm/slmath_pp.h>
 #endif
+#include <string.h> // for memcpy
 
 #undef SLMATH_ALIGN16
 #undef SLMATH_MUL_PS
@@ -19,6 +20,7 @@
 
 #if defined(SLMATH_SSE2_MSVC)
 	#include <xmmintrin.h>
+	#include <emmintrin.h>
 
 	SLMATH_BEGIN()
 		typedef __m128 m128_t;
@@ -28,10 +30,28 @@
 	#define SLMATH_ADD_PS(A,B) _mm_add_ps(A,B)
 	#define SLMATH_SUB_PS(A,B) _mm_sub_ps(A,B)
 	#define SLMATH_DIV_PS(A,B) _mm_div_ps(A,B)
+	#define SLMATH_SQRT_PS(A) _mm_sqrt_ps(A)
 	#define SLMATH_SETZERO_PS() _mm_setzero_ps()
 	#define SLMATH_LOAD_PS1(A) _mm_load_ps1(A)
 	#define SLMATH_MIN_PS(A,B) _mm_min_ps(A,B)
 	#define SLMATH_MAX_PS(A,B) _mm_max_ps(A,B)
+	#define SLMATH_SET_PS(X,Y,Z,W) _mm_setr_ps(X,Y,Z,W)
+	#define SLMATH_LOAD_PS(A) _mm_load_ps(A)
+	#define SLMATH_LOADU_PS(A) _mm_loadu_ps(A)
+	#define SLMATH_STORE_PS(A,B) _mm_store_ps(A,B)
+	#define SLMATH_STOREU_PS(A,B) _mm_storeu_ps(A,B)
+	#define SLMATH_CMPEQ_PS(A,B) _mm_cmpeq_ps(A,B)
+	#define SLMATH_CMPNEQ_PS(A,B) _mm_cmpneq_ps(A,B)
+	#define SLMATH_CMPLT_PS(A,B) _mm_cmplt_ps(A,B)
+	#define SLMATH_CMPLE_PS(A,B) _mm_cmple_ps(A,B)
+	#define SLMATH_CMPGT_PS(A,B) _mm_cmpgt_ps(A,B)
+	#define SLMATH_CMPGE_PS(A,B) _mm_cmpge_ps(A,B)
+	#define SLMATH_AND_PS(A,B) _mm_and_ps(A,B)
+	#define SLMATH_ANDNOT_PS(A,B) _mm_andnot_ps(A,B)
+	#define SLMATH_OR_PS(A,B) _mm_or_ps(A,B)
+	#define SLMATH_XOR_PS(A,B) _mm_xor_ps(A,B)
+	#define SLMATH_MOVEMASK_PS(A) _mm_movemask_ps(A)
+	#define SLMATH_LOAD_U8_PS(A) _mm_cvtepi32_ps( _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128(*(const int*)(A)), _mm_setzero_si128() ), _mm_setzero_si128() ) )
 #else 
 	// SIMD emulation with standard C++, so you can still use SIMD-macros even without SIMD support if you want
 	#undef SLMATH_SIMD
@@ -46,16 +66,131 @@
 			m128_emu(float x,float y,float z,float w) {m[0]=x;m[1]=y;m[2]=z;m[3]=w;} 
 		};
 		typedef m128_emu m128_t;
+
+		// Lane masks are stored as bit patterns (all ones/all zeros) like in SSE, so bitwise ops go through integers
+		union m128_emu_lane
+		{
+			float			f;
+			unsigned int	u;
+		};
+
+		inline float m128_emu_bits( unsigned int u )
+		{
+			m128_emu_lane l;
+			l.u = u;
+			return l.f;
+		}
+
+		inline unsigned int m128_emu_bits( float f )
+		{
+			m128_emu_lane l;
+			l.f = f;
+			return l.u;
+		}
+
+		inline m128_emu m128_emu_mask( bool x, bool y, bool z, bool w )
+		{
+			return m128_emu( m128_emu_bits(x?0xFFFFFFFFu:0u), m128_emu_bits(y?0xFFFFFFFFu:0u), m128_emu_bits(z?0xFFFFFFFFu:0u), m128_emu_bits(w?0xFFFFFFFFu:0u) );
+		}
+
+		inline int m128_emu_movemask( const m128_emu& a )
+		{
+			return int(m128_emu_bits(a.m[0])>>31) | int(m128_emu_bits(a.m[1])>>31)<<1 | int(m128_emu_bits(a.m[2])>>31)<<2 | int(m128_emu_bits(a.m[3])>>31)<<3;
+		}
+
+		#define SLMATH_EMU_BITOP(NAME,EXPR) \
+		inline m128_emu NAME( const m128_emu& a, const m128_emu& b ) \
+		{ \
+			m128_emu r; \
+			for ( int i = 0 ; i < 4 ; ++i ) \
+			{ \
+				const unsigned int ai = m128_emu_bits(a.m[i]); \
+				const unsigned int bi = m128_emu_bits(b.m[i]); \
+				r.m[i] = m128_emu_bits( (unsigned int)(EXPR) ); \
+			} \
+			return r; \
+		}
+		SLMATH_EMU_BITOP( m128_emu_and, ai & bi )
+		SLMATH_EMU_BITOP( m128_emu_andnot, ~ai & bi )
+		SLMATH_EMU_BITOP( m128_emu_or, ai | bi )
+		SLMATH_EMU_BITOP( m128_emu_xor, ai ^ bi )
+		#undef SLMATH_EMU_BITOP
 	SLMATH_END()
 
 	#define SLMATH_MUL_PS(A,B) SLMATH_NS(m128_emu)( (A).m[0]*(B).m[0], (A).m[1]*(B).m[1], (A).m[2]*(B).m[2], (A).m[3]*(B).m[3] )
 	#define SLMATH_ADD_PS(A,B) SLMATH_NS(m128_emu)( (A).m[0]+(B).m[0], (A).m[1]+(B).m[1], (A).m[2]+(B).m[2], (A).m[3]+(B).m[3] )
 	#define SLMATH_SUB_PS(A,B) SLMATH_NS(m128_emu)( (A).m[0]-(B).m[0], (A).m[1]-(B).m[1], (A).m[2]-(B).m[2], (A).m[3]-(B).m[3] )
 	#define SLMATH_DIV_PS(A,B) SLMATH_NS(m128_emu)( (A).m[0]/(B).m[0], (A).m[1]/(B).m[1], (A).m[2]/(B).m[2], (A).m[3]/(B).m[3] )
+	#define SLMATH_SQRT_PS(A) SLMATH_NS(m128_emu)( sqrtf((A).m[0]), sqrtf((A).m[1]), sqrtf((A).m[2]), sqrtf((A).m[3]) )
 	#define SLMATH_SETZERO_PS() SLMATH_NS(m128_emu)( 0.f )
 	#define SLMATH_LOAD_PS1(A) SLMATH_NS(m128_emu)( *(A) )
+	// min and max return B if either is NaN, like SSE
 	#define SLMATH_MIN_PS(A,B) SLMATH_NS(m128_emu)( (A).m[0]<(B).m[0]?(A).m[0]:(B).m[0], (A).m[1]<(B).m[1]?(A).m[1]:(B).m[1], (A).m[2]<(B).m[2]?(A).m[2]:(B).m[2], (A).m[3]<(B).m[3]?(A).m[3]:(B).m[3] )
-	#define SLMATH_MAX_PS(A,B) SLMATH_NS(m128_emu)( (A).m[0]<(B).m[0]?(B).m[0]:(A).m[0], (A).m[1]<(B).m[1]?(B).m[1]:(A).m[1], (A).m[2]<(B).m[2]?(B).m[2]:(A).m[2], (A).m[3]<(B).m[3]?(B).m[3]:(A).m[3] )
+	#define SLMATH_MAX_PS(A,B) SLMATH_NS(m128_emu)( (A).m[0]>(B).m[0]?(A).m[0]:(B).m[0], (A).m[1]>(B).m[1]?(A).m[1]:(B).m[1], (A).m[2]>(B).m[2]?(A).m[2]:(B).m[2], (A).m[3]>(B).m[3]?(A).m[3]:(B).m[3] )
+	#define SLMATH_SET_PS(X,Y,Z,W) SLMATH_NS(m128_emu)( X, Y, Z, W )
+	#define SLMATH_LOAD_PS(A) SLMATH_NS(m128_emu)( (A)[0], (A)[1], (A)[2], (A)[3] )
+	#define SLMATH_LOADU_PS(A) SLMATH_NS(m128_emu)( (A)[0], (A)[1], (A)[2], (A)[3] )
+	#define SLMATH_STORE_PS(A,B) memcpy( A, (B).m, sizeof(float)*4 )
+	#define SLMATH_STOREU_PS(A,B) memcpy( A, (B).m, sizeof(float)*4 )
+	#define SLMATH_CMPEQ_PS(A,B) SLMATH_NS(m128_emu_mask)( (A).m[0]==(B).m[0], (A).m[1]==(B).m[1], (A).m[2]==(B).m[2], (A).m[3]==(B).m[3] )
+	#define SLMATH_CMPNEQ_PS(A,B) SLMATH_NS(m128_emu_mask)( !((A).m[0]==(B).m[0]), !((A).m[1]==(B).m[1]), !((A).m[2]==(B).m[2]), !((A).m[3]==(B).m[3]) )
+	#define SLMATH_CMPLT_PS(A,B) SLMATH_NS(m128_emu_mask)( (A).m[0]<(B).m[0], (A).m[1]<(B).m[1], (A).m[2]<(B).m[2], (A).m[3]<(B).m[3] )
+	#define SLMATH_CMPLE_PS(A,B) SLMATH_NS(m128_emu_mask)( (A).m[0]<=(B).m[0], (A).m[1]<=(B).m[1], (A).m[2]<=(B).m[2], (A).m[3]<=(B).m[3] )
+	#define SLMATH_CMPGT_PS(A,B) SLMATH_NS(m128_emu_mask)( (A).m[0]>(B).m[0], (A).m[1]>(B).m[1], (A).m[2]>(B).m[2], (A).m[3]>(B).m[3] )
+	#define SLMATH_CMPGE_PS(A,B) SLMATH_NS(m128_emu_mask)( (A).m[0]>=(B).m[0], (A).m[1]>=(B).m[1], (A).m[2]>=(B).m[2], (A).m[3]>=(B).m[3] )
+	#define SLMATH_AND_PS(A,B) SLMATH_NS(m128_emu_and)(A,B)
+	#define SLMATH_ANDNOT_PS(A,B) SLMATH_NS(m128_emu_andnot)(A,B)
+	#define SLMATH_OR_PS(A,B) SLMATH_NS(m128_emu_or)(A,B)
+	#define SLMATH_XOR_PS(A,B) SLMATH_NS(m128_emu_xor)(A,B)
+	#define SLMATH_MOVEMASK_PS(A) SLMATH_NS(m128_emu_movemask)(A)
+	#define SLMATH_LOAD_U8_PS(A) SLMATH_NS(m128_emu)( float((A)[0]), float((A)[1]), float((A)[2]), float((A)[3]) )
+#endif
+
+/** Selects lanes from A where mask M is set, and from B elsewhere. */
+#define SLMATH_SELECT_PS(M,A,B) SLMATH_OR_PS( SLMATH_AND_PS(M,A), SLMATH_ANDNOT_PS(M,B) )
+
+// 4-wide double precision SIMD for double types, AVX if enabled with SLMATH_AVX, otherwise emulated with standard C++.
+// Loads and stores are unaligned, so double types don't need 32-byte alignment.
+#if defined(SLMATH_SSE2_MSVC) && defined(SLMATH_AVX)
+	#include <immintrin.h>
+
+	SLMATH_BEGIN()
+		typedef __m256d m256d_t;
+	SLMATH_END()
+
+	#define SLMATH_MUL_PD(A,B) _mm256_mul_pd(A,B)
+	#define SLMATH_ADD_PD(A,B) _mm256_add_pd(A,B)
+	#define SLMATH_SUB_PD(A,B) _mm256_sub_pd(A,B)
+	#define SLMATH_DIV_PD(A,B) _mm256_div_pd(A,B)
+	#define SLMATH_SETZERO_PD() _mm256_setzero_pd()
+	#define SLMATH_LOAD_PD1(A) _mm256_broadcast_sd(A)
+	#define SLMATH_SET_PD(X,Y,Z,W) _mm256_setr_pd(X,Y,Z,W)
+	#define SLMATH_LOADU_PD(A) _mm256_loadu_pd(A)
+	#define SLMATH_STOREU_PD(A,B) _mm256_storeu_pd(A,B)
+	#define SLMATH_CVTPD_PS(A) _mm256_cvtpd_ps(A)
+#else
+	SLMATH_BEGIN()
+		struct m256d_emu
+		{
+			double m[4]; 
+			
+			m256d_emu() {} 
+			m256d_emu(double x) {m[0]=m[1]=m[2]=m[3]=x;} 
+			m256d_emu(double x,double y,double z,double w) {m[0]=x;m[1]=y;m[2]=z;m[3]=w;} 
+		};
+		typedef m256d_emu m256d_t;
+	SLMATH_END()
+
+	#define SLMATH_MUL_PD(A,B) SLMATH_NS(m256d_emu)( (A).m[0]*(B).m[0], (A).m[1]*(B).m[1], (A).m[2]*(B).m[2], (A).m[3]*(B).m[3] )
+	#define SLMATH_ADD_PD(A,B) SLMATH_NS(m256d_emu)( (A).m[0]+(B).m[0], (A).m[1]+(B).m[1], (A).m[2]+(B).m[2], (A).m[3]+(B).m[3] )
+	#define SLMATH_SUB_PD(A,B) SLMATH_NS(m256d_emu)( (A).m[0]-(B).m[0], (A).m[1]-(B).m[1], (A).m[2]-(B).m[2], (A).m[3]-(B).m[3] )
+	#define SLMATH_DIV_PD(A,B) SLMATH_NS(m256d_emu)( (A).m[0]/(B).m[0], (A).m[1]/(B).m[1], (A).m[2]/(B).m[2], (A).m[3]/(B).m[3] )
+	#define SLMATH_SETZERO_PD() SLMATH_NS(m256d_emu)( 0.0 )
+	#define SLMATH_LOAD_PD1(A) SLMATH_NS(m256d_emu)( *(A) )
+	#define SLMATH_SET_PD(X,Y,Z,W) SLMATH_NS(m256d_emu)( X, Y, Z, W )
+	#define SLMATH_LOADU_PD(A) SLMATH_NS(m256d_emu)( (A)[0], (A)[1], (A)[2], (A)[3] )
+	#define SLMATH_STOREU_PD(A,B) memcpy( A, (B).m, sizeof(double)*4 )
+	#define SLMATH_CVTPD_PS(A) SLMATH_SET_PS( float((A).m[0]), float((A).m[1]), float((A).m[2]), float((A).m[3]) )
 #endif
 
 #endif
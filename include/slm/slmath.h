@@ -16,19 +16,45 @@
 
 #include <slm/slmath_configure.h>
 #include <slm/slmath_pp.h>
+#include <slm/affine.h>
+#include <slm/bvh.h>
+#include <slm/dmat4.h>
+#include <slm/dquat.h>
+#include <slm/dualquat.h>
+#include <slm/dvec3.h>
+#include <slm/dvec4.h>
+#include <slm/fixed.h>
+#include <slm/fixed_mat4.h>
+#include <slm/fixed_quat.h>
+#include <slm/fixed_vec2.h>
+#include <slm/fixed_vec3.h>
 #include <slm/float_util.h>
+#include <slm/frustum.h>
+#include <slm/gjk.h>
+#include <slm/half.h>
+#include <slm/intersect_stats.h>
 #include <slm/intersect_util.h>
+#include <slm/kd_tree.h>
+#include <slm/loose_octree.h>
+#include <slm/mat3.h>
 #include <slm/mat4.h>
+#include <slm/morton.h>
 #include <slm/mtrnd.h>
 #include <slm/no_simd.h>
+#include <slm/octahedral.h>
 #include <slm/quat.h>
+#include <slm/quat_pack.h>
 #include <slm/runtime_checks.h>
 #include <slm/simd.h>
+#include <slm/spatial_hash.h>
+#include <slm/sweep_and_prune.h>
+#include <slm/trs.h>
 #include <slm/vec_impl.h>
 #include <slm/vec2.h>
 #include <slm/vec3.h>
 #include <slm/vec4.h>
 #include <slm/vector_simd.h>
+#include <slm/voxel_grid.h>
 
 #endif
 
@@ -15,6 +15,12 @@
 /** Enable vec-op asserts on _DEBUG build */
 //#define SLMATH_VEC_ASSERTS
 
+/** Enable counting of traversal and intersection work per thread, see intersect_stats */
+//#define SLMATH_STATS
+
+/** Enable AVX for 4-wide double precision SIMD in double types (dvec4, dmat4), requires SLMATH_SIMD and AVX capable CPU */
+//#define SLMATH_AVX
+
 #endif // SLMATH_CONFIGURE_H
 
 // This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
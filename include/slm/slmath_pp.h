@@ -54,6 +54,13 @@
 	#define SLMATH_VEC_ASSERT(V)
 #endif
 
+// Thread local storage class
+#if defined(_MSC_VER)
+	#define SLMATH_THREAD_LOCAL __declspec(thread)
+#else
+	#define SLMATH_THREAD_LOCAL __thread
+#endif
+
 // SIMD macros
 #include <slm/simd.h>
 
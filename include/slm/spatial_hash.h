@@ -0,0 +1,94 @@
+#ifndef SLMATH_SPATIAL_HASH_H
+#define SLMATH_SPATIAL_HASH_H
+
+#include <slm/vec3.h>
+#include <slm/vector_simd.h>
+
+SLMATH_BEGIN()
+
+/**
+ * \defgroup spatial_util Spatial data structures for proximity queries.
+ * @ingroup slm
+ */
+
+/**
+ * Uniform grid of points stored in a hash table, for radius and nearest neighbour queries.
+ * Grid cells are cubes of specified size and each cell is hashed to a bucket of a fixed size table,
+ * so the grid has no bounds and memory use doesn't depend on extent of the points.
+ *
+ * The grid is meant to be rebuilt every frame: build() sorts the points by bucket with
+ * counting sort in linear time, after which points in the same bucket are stored
+ * contiguously for cache friendly queries.
+ *
+ * Cell size should be about the typical query radius. Cell coordinates are clamped to +-2^29,
+ * so points farther away share the border cells, which keeps queries correct but slower.
+ *
+ * @ingroup spatial_util
+ */
+class spatial_hash
+{
+public:
+	/**
+	 * Constructs empty grid.
+	 * @param cellsize Size of a grid cell.
+	 * @param tablesize Number of hash buckets, rounded up to power of two. About the number of points is a good choice.
+	 */
+	spatial_hash( float cellsize, size_t tablesize );
+
+	/**
+	 * Rebuilds the grid from an array of points. Point indices refer to this array.
+	 * @param points Point positions. Positions are copied, so the array doesn't need to be kept.
+	 * @param n Number of points.
+	 */
+	void		build( const vec3* points, size_t n );
+
+	/**
+	 * Finds points within specified distance of a point.
+	 * @param p Query point.
+	 * @param radius Query radius, inclusive.
+	 * @param out [out] Receives indices of found points in no particular order.
+	 * @param maxout Maximum number of indices to store to out.
+	 * @return Number of points found. Can be larger than maxout, in which case only maxout indices were stored.
+	 */
+	size_t		query_radius( const vec3& p, float radius, size_t* out, size_t maxout ) const;
+
+	/**
+	 * Finds k nearest points to a point.
+	 * @param p Query point.
+	 * @param k Number of points to find.
+	 * @param out [out] Receives indices of found points, nearest first. Must have room for k indices.
+	 * @param outdist [out] Receives distances of found points. Must have room for k values. Can be 0.
+	 * @return Number of points found, k unless there are less than k points in the grid.
+	 */
+	size_t		query_nearest( const vec3& p, size_t k, size_t* out, float* outdist ) const;
+
+	/** Returns number of points in the grid. */
+	size_t		size() const				{return m_indices.size();}
+
+	/** Returns size of a grid cell. */
+	float		cell_size() const			{return m_cellsize;}
+
+private:
+	float				m_cellsize;
+	float				m_invcellsize;
+	size_t				m_mask;
+	vector_simd<size_t>	m_cellstart;
+	vector_simd<size_t>	m_indices;
+	vector_simd<vec3>	m_points;
+	vector_simd<size_t>	m_buckets;
+	int					m_boundsmin[3];
+	int					m_boundsmax[3];
+
+	void		cell( const vec3& p, int* c ) const;
+	size_t		bucket( int x, int y, int z ) const;
+
+	spatial_hash();
+	spatial_hash( const spatial_hash& );
+	spatial_hash& operator=( const spatial_hash& );
+};
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,80 @@
+#ifndef SLMATH_SWEEP_AND_PRUNE_H
+#define SLMATH_SWEEP_AND_PRUNE_H
+
+#include <slm/vec3.h>
+#include <slm/vector_simd.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Pair of overlapping boxes.
+ * @ingroup spatial_util
+ */
+class box_pair
+{
+public:
+	/** Index of the first box, always smaller than b. */
+	unsigned int	a;
+	/** Index of the second box. */
+	unsigned int	b;
+};
+
+/**
+ * Sweep-and-prune broadphase for finding overlapping pairs in a set of moving axis aligned boxes.
+ *
+ * Boxes are kept sorted by their minimum coordinate along the sort axis.
+ * The order from the previous update is used as starting point for insertion sort,
+ * so when boxes move only a little between updates sorting is close to linear time.
+ * Pairs are then found by sweeping along the sort axis, testing the other two axes
+ * of four boxes at a time using SIMD instructions.
+ *
+ * Choose the sort axis along which the boxes are most spread out, e.g. X-axis for typical game worlds.
+ *
+ * @ingroup spatial_util
+ */
+class sweep_and_prune
+{
+public:
+	/**
+	 * Constructs empty broadphase.
+	 * @param axis Sort axis, 0=X, 1=Y, 2=Z.
+	 */
+	explicit sweep_and_prune( int axis );
+
+	/**
+	 * Updates box bounds. Box indices refer to these arrays.
+	 * If number of boxes changes, the boxes are sorted from scratch.
+	 * @param boxmin Minimum coordinates of the boxes.
+	 * @param boxmax Maximum coordinates of the boxes.
+	 * @param n Number of boxes.
+	 */
+	void		update( const vec3* boxmin, const vec3* boxmax, size_t n );
+
+	/**
+	 * Finds all pairs of overlapping boxes. Touching boxes are considered overlapping.
+	 * @param pairs [out] Receives overlapping pairs in no particular order.
+	 * @param maxpairs Maximum number of pairs to store.
+	 * @return Number of overlapping pairs. Can be larger than maxpairs, in which case only maxpairs pairs were stored.
+	 */
+	size_t		find_pairs( box_pair* pairs, size_t maxpairs ) const;
+
+	/** Returns number of boxes. */
+	size_t		size() const				{return m_order.size();}
+
+private:
+	int							m_axis;
+	vector_simd<unsigned int>	m_order;
+	vector_simd<float>			m_key;
+	vector_simd<float>			m_min[3];
+	vector_simd<float>			m_max[3];
+
+	sweep_and_prune();
+	sweep_and_prune( const sweep_and_prune& );
+	sweep_and_prune& operator=( const sweep_and_prune& );
+};
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
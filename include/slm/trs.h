@@ -0,0 +1,125 @@
+#ifndef SLMATH_TRS_H
+#define SLMATH_TRS_H
+
+#include <slm/quat.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Transform made of scale, then rotation, then translation, kept as separate components.
+ * Scene graph nodes and animation poses compose and interpolate these directly,
+ * and convert to mat4 only at the end with the batch to_mat4.
+ *
+ * Semantics follow mat4: to make combined transform of child C, then parent P:
+ * PC = P * C;
+ *
+ * Composition and inverse are exact when the scale is uniform. With non-uniform scale
+ * a rotated child would need shear, which TRS can't represent, so scales are just multiplied
+ * per axis, like in most scene graphs.
+ *
+ * Note naming convention: This class is starting with small letter since 
+ * it is NOT initialized by the default constructor, much like int, float, etc. types.
+ *
+ * @ingroup quat_util
+ */
+class trs
+{
+public:
+	/** Translation, applied last. */
+	vec3	translation;
+
+	/** Rotation, unit quaternion. */
+	quat	rotation;
+
+	/** Scale per axis, applied first. */
+	vec3	scale;
+
+	/** Constructs undefined transform. In _DEBUG build the transform is initialized to NaN. */
+	trs();
+
+	/** 
+	 * Constructs transform from components.
+	 * @param t Translation.
+	 * @param r Rotation. Must be unit length.
+	 * @param s Scale per axis.
+	 */
+	trs( const vec3& t, const quat& r, const vec3& s );
+
+	/** Transform multiplication. */
+	trs&		operator*=( const trs& o );
+
+	/** Transform multiplication. */
+	trs			operator*( const trs& o ) const;
+
+	/** Component wise equality. */
+	bool		operator==( const trs& o ) const;
+
+	/** Component wise inequality. */
+	bool		operator!=( const trs& o ) const;
+};
+
+/** 
+ * Returns true if all components of the transform are valid numbers. 
+ * @ingroup quat_util
+ */
+bool		check( const trs& x );
+
+/** 
+ * Returns inverse transform. Exact if scale is uniform.
+ * @ingroup quat_util
+ */
+trs			inverse( const trs& x );
+
+/**
+ * Interpolates transforms: translation and scale linearly, rotation with slerp along the shorter path.
+ * @param a Transform at u=0.
+ * @param b Transform at u=1.
+ * @param u Interpolation parameter.
+ * @ingroup quat_util
+ */
+trs			mix( const trs& a, const trs& b, float u );
+
+/** 
+ * Transforms point: scale, rotation and translation.
+ * @ingroup quat_util
+ */
+vec3		transform_point( const trs& x, const vec3& p );
+
+/** 
+ * Transforms direction: scale and rotation.
+ * @ingroup quat_util
+ */
+vec3		transform_direction( const trs& x, const vec3& v );
+
+/** 
+ * Returns transform matrix.
+ * @ingroup quat_util
+ */
+mat4		to_mat4( const trs& x );
+
+/**
+ * Converts array of transforms to matrices.
+ * @param x Transforms.
+ * @param n Number of transforms.
+ * @param out [out] Receives n matrices.
+ * @ingroup quat_util
+ */
+void		to_mat4( const trs* x, size_t n, mat4* out );
+
+/**
+ * Computes world transforms of a hierarchy from local transforms.
+ * @param local Local transforms relative to parents.
+ * @param parents Parent index of each transform, less than its own index, or -1 for roots.
+ * @param n Number of transforms.
+ * @param world [out] Receives n world transforms. Can't be the same array as local.
+ * @ingroup quat_util
+ */
+void		compose_hierarchy( const trs* local, const int* parents, size_t n, trs* world );
+
+#include <slm/trs.inl>
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,41 @@
+inline trs::trs()
+{
+}
+
+inline trs::trs( const vec3& t, const quat& r, const vec3& s ) :
+	translation(t), rotation(r), scale(s)
+{
+}
+
+inline trs& trs::operator*=( const trs& o )
+{
+	*this = *this * o;
+	return *this;
+}
+
+inline bool trs::operator==( const trs& o ) const
+{
+	return translation == o.translation && rotation == o.rotation && scale == o.scale;
+}
+
+inline bool trs::operator!=( const trs& o ) const
+{
+	return !(*this == o);
+}
+
+inline bool check( const trs& x )
+{
+	return check(x.translation) && check(x.rotation) && check(x.scale);
+}
+
+inline vec3 transform_point( const trs& x, const vec3& p )
+{
+	return x.translation + rotate( x.rotation, x.scale*p );
+}
+
+inline vec3 transform_direction( const trs& x, const vec3& v )
+{
+	return rotate( x.rotation, x.scale*v );
+}
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
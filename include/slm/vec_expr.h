@@ -0,0 +1,249 @@
+#ifndef SLMATH_VEC_EXPR_H
+#define SLMATH_VEC_EXPR_H
+
+#include <slm/vec4.h>
+#include <slm/vector_simd.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Expression template over vec2, vec3 or vec4 values and arrays, for fusing element-wise operations.
+ *
+ * Operators of the vector classes return a new vector per operator, and operations over arrays
+ * need a pass and a temporary array per operator. An expression built from vec_expr operands only records
+ * the operations, and evaluating it computes each result element in a single pass with no intermediate storage:
+ *
+ * <pre>
+ * vec3 r = expr(a)*s + b - c;						// single vectors, converts to vec3
+ * eval( expr(pos) + expr(vel)*dt, pos, n );		// arrays: pos[i] += vel[i]*dt in one pass
+ * </pre>
+ *
+ * Operands can be vectors, arrays (pointers or vector_simd) and float scalars; at least one operand of
+ * each operator must be a vec_expr, so plain vector code is unaffected unless expr is used.
+ * Vectors and arrays are referenced, not copied, so an expression must be evaluated before its operands go away,
+ * i.e. don't store expressions in variables. This header is opt-in and not included by slmath.h.
+ *
+ * @param V Vector type, vec2, vec3 or vec4.
+ * @param E Expression node type.
+ * @ingroup vec_util
+ */
+template <class V, class E> class vec_expr
+{
+public:
+	/** Expression node. */
+	E		e;
+
+	/** Constructs expression from node. */
+	explicit vec_expr( const E& e0 )						: e(e0) {}
+
+	/** Returns value of the ith element. Expressions without arrays have the same value for every element. */
+	V		operator[]( size_t i ) const					{return e[i];}
+
+	/** Evaluates expression without arrays. */
+	operator V() const										{return e[0];}
+};
+
+/** Expression node referring to single vector. */
+template <class V> class vec_expr_value
+{
+public:
+	const V&	v;
+
+	explicit vec_expr_value( const V& v0 )					: v(v0) {}
+	const V&	operator[]( size_t ) const					{return v;}
+};
+
+/** Expression node referring to array of vectors. */
+template <class V> class vec_expr_array
+{
+public:
+	const V*	v;
+
+	explicit vec_expr_array( const V* v0 )					: v(v0) {}
+	const V&	operator[]( size_t i ) const				{return v[i];}
+};
+
+/** Expression node of scalar. */
+class vec_expr_scalar
+{
+public:
+	float		s;
+
+	explicit vec_expr_scalar( float s0 )					: s(s0) {}
+	float		operator[]( size_t ) const					{return s;}
+};
+
+/** Expression node of binary operation. */
+template <class V, class A, class B, class Op> class vec_expr_binary
+{
+public:
+	A		a;
+	B		b;
+
+	vec_expr_binary( const A& a0, const B& b0 )				: a(a0), b(b0) {}
+	V		operator[]( size_t i ) const					{return Op::apply( a[i], b[i] );}
+};
+
+/** Expression node of negation. */
+template <class V, class A> class vec_expr_negate
+{
+public:
+	A		a;
+
+	explicit vec_expr_negate( const A& a0 )					: a(a0) {}
+	V		operator[]( size_t i ) const					{return -a[i];}
+};
+
+/** Addition operation of vec_expr_binary. */
+class vec_expr_add
+{
+public:
+	template <class A, class B> static A apply( const A& a, const B& b )		{return a + b;}
+};
+
+/** Subtraction operation of vec_expr_binary. */
+class vec_expr_sub
+{
+public:
+	template <class A, class B> static A apply( const A& a, const B& b )		{return a - b;}
+};
+
+/** Multiplication operation of vec_expr_binary, component wise or by scalar. */
+class vec_expr_mul
+{
+public:
+	template <class A, class B> static A apply( const A& a, const B& b )		{return a * b;}
+	template <class B> static B apply( float a, const B& b )					{return b * a;}
+};
+
+/** Division operation of vec_expr_binary, component wise or by scalar. */
+class vec_expr_div
+{
+public:
+	template <class A, class B> static A apply( const A& a, const B& b )		{return a / b;}
+};
+
+/**
+ * Returns expression referring to single vector.
+ * @ingroup vec_util
+ */
+inline vec_expr< vec2, vec_expr_value<vec2> >		expr( const vec2& v )					{return vec_expr< vec2, vec_expr_value<vec2> >( vec_expr_value<vec2>(v) );}
+
+/**
+ * Returns expression referring to single vector.
+ * @ingroup vec_util
+ */
+inline vec_expr< vec3, vec_expr_value<vec3> >		expr( const vec3& v )					{return vec_expr< vec3, vec_expr_value<vec3> >( vec_expr_value<vec3>(v) );}
+
+/**
+ * Returns expression referring to single vector.
+ * @ingroup vec_util
+ */
+inline vec_expr< vec4, vec_expr_value<vec4> >		expr( const vec4& v )					{return vec_expr< vec4, vec_expr_value<vec4> >( vec_expr_value<vec4>(v) );}
+
+/**
+ * Returns expression referring to array of vectors.
+ * @ingroup vec_util
+ */
+inline vec_expr< vec2, vec_expr_array<vec2> >		expr( const vec2* v )					{return vec_expr< vec2, vec_expr_array<vec2> >( vec_expr_array<vec2>(v) );}
+
+/**
+ * Returns expression referring to array of vectors.
+ * @ingroup vec_util
+ */
+inline vec_expr< vec3, vec_expr_array<vec3> >		expr( const vec3* v )					{return vec_expr< vec3, vec_expr_array<vec3> >( vec_expr_array<vec3>(v) );}
+
+/**
+ * Returns expression referring to array of vectors.
+ * @ingroup vec_util
+ */
+inline vec_expr< vec4, vec_expr_array<vec4> >		expr( const vec4* v )					{return vec_expr< vec4, vec_expr_array<vec4> >( vec_expr_array<vec4>(v) );}
+
+/**
+ * Returns expression referring to array of vectors.
+ * @ingroup vec_util
+ */
+template <class V> vec_expr< V, vec_expr_array<V> >	expr( const vector_simd<V>& v )			{return vec_expr< V, vec_expr_array<V> >( vec_expr_array<V>(v.begin()) );}
+
+/**
+ * Evaluates expression to array in a single pass.
+ * Each element reads only the same element of the operand arrays, so out can be one of the operand arrays.
+ * @param e Expression.
+ * @param out [out] Receives n evaluated elements.
+ * @param n Number of elements to evaluate.
+ * @ingroup vec_util
+ */
+template <class V, class E> void eval( const vec_expr<V,E>& e, V* out, size_t n )
+{
+	for ( size_t i = 0 ; i < n ; ++i )
+		out[i] = e.e[i];
+}
+
+/**
+ * Evaluates expression to all elements of an array in a single pass. Operand arrays must have at least out->size() elements.
+ * @param e Expression.
+ * @param out [out] Receives evaluated elements.
+ * @ingroup vec_util
+ */
+template <class V, class E> void eval( const vec_expr<V,E>& e, vector_simd<V>* out )
+{
+	eval( e, out->begin(), out->size() );
+}
+
+/**
+ * Returns negation expression.
+ * @ingroup vec_util
+ */
+template <class V, class A> vec_expr< V, vec_expr_negate<V,A> > operator-( const vec_expr<V,A>& a )
+{
+	return vec_expr< V, vec_expr_negate<V,A> >( vec_expr_negate<V,A>(a.e) );
+}
+
+// binary operators between two expressions, expression and vector, and vector and expression
+#define SLMATH_VEC_EXPR_OPERATOR( OP, OPCLASS ) \
+	template <class V, class A, class B> vec_expr< V, vec_expr_binary<V,A,B,OPCLASS> > operator OP( const vec_expr<V,A>& a, const vec_expr<V,B>& b ) \
+		{return vec_expr< V, vec_expr_binary<V,A,B,OPCLASS> >( vec_expr_binary<V,A,B,OPCLASS>(a.e,b.e) );} \
+	template <class V, class A> vec_expr< V, vec_expr_binary<V,A,vec_expr_value<V>,OPCLASS> > operator OP( const vec_expr<V,A>& a, const V& b ) \
+		{return vec_expr< V, vec_expr_binary<V,A,vec_expr_value<V>,OPCLASS> >( vec_expr_binary<V,A,vec_expr_value<V>,OPCLASS>(a.e,vec_expr_value<V>(b)) );} \
+	template <class V, class B> vec_expr< V, vec_expr_binary<V,vec_expr_value<V>,B,OPCLASS> > operator OP( const V& a, const vec_expr<V,B>& b ) \
+		{return vec_expr< V, vec_expr_binary<V,vec_expr_value<V>,B,OPCLASS> >( vec_expr_binary<V,vec_expr_value<V>,B,OPCLASS>(vec_expr_value<V>(a),b.e) );}
+
+SLMATH_VEC_EXPR_OPERATOR( +, vec_expr_add )
+SLMATH_VEC_EXPR_OPERATOR( -, vec_expr_sub )
+SLMATH_VEC_EXPR_OPERATOR( *, vec_expr_mul )
+SLMATH_VEC_EXPR_OPERATOR( /, vec_expr_div )
+
+#undef SLMATH_VEC_EXPR_OPERATOR
+
+/**
+ * Returns expression multiplying expression by scalar.
+ * @ingroup vec_util
+ */
+template <class V, class A> vec_expr< V, vec_expr_binary<V,A,vec_expr_scalar,vec_expr_mul> > operator*( const vec_expr<V,A>& a, float s )
+{
+	return vec_expr< V, vec_expr_binary<V,A,vec_expr_scalar,vec_expr_mul> >( vec_expr_binary<V,A,vec_expr_scalar,vec_expr_mul>(a.e,vec_expr_scalar(s)) );
+}
+
+/**
+ * Returns expression multiplying expression by scalar.
+ * @ingroup vec_util
+ */
+template <class V, class B> vec_expr< V, vec_expr_binary<V,vec_expr_scalar,B,vec_expr_mul> > operator*( float s, const vec_expr<V,B>& b )
+{
+	return vec_expr< V, vec_expr_binary<V,vec_expr_scalar,B,vec_expr_mul> >( vec_expr_binary<V,vec_expr_scalar,B,vec_expr_mul>(vec_expr_scalar(s),b.e) );
+}
+
+/**
+ * Returns expression dividing expression by scalar.
+ * @ingroup vec_util
+ */
+template <class V, class A> vec_expr< V, vec_expr_binary<V,A,vec_expr_scalar,vec_expr_div> > operator/( const vec_expr<V,A>& a, float s )
+{
+	return vec_expr< V, vec_expr_binary<V,A,vec_expr_scalar,vec_expr_div> >( vec_expr_binary<V,A,vec_expr_scalar,vec_expr_div>(a.e,vec_expr_scalar(s)) );
+}
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
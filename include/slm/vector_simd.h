@@ -43,7 +43,7 @@ public:
 	/** Resizes vector -1 */
 	void		pop_back()						{assert(m_size); --m_size;}
 	/** Resizes vector to n elements */
-	void		resize( size_t n )				{if (n>m_cap) {if (n<m_cap*2) n=m_cap*2; reallocate(n);} m_size=n;}
+	void		resize( size_t n )				{if (n>m_cap) reallocate(n<m_cap*2 ? m_cap*2 : n); m_size=n;}
 
 	// Inspectors
 
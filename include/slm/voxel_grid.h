@@ -0,0 +1,95 @@
+#ifndef SLMATH_VOXEL_GRID_H
+#define SLMATH_VOXEL_GRID_H
+
+#include <slm/intersect_util.h>
+#include <slm/vector_simd.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Dense grid of cubic voxels, one bit per voxel.
+ * Voxel (x,y,z) covers box origin + [x,x+1]*size etc.
+ *
+ * Triangle meshes are voxelized conservatively: every voxel which a triangle touches is set,
+ * using SIMD triangle-box tests along rows of four voxels.
+ * To voxelize with multiple threads, give each thread its own grid of the same dimensions
+ * and a range of triangles, then merge() the grids.
+ *
+ * @ingroup spatial_util
+ */
+class voxel_grid
+{
+public:
+	/**
+	 * Constructs empty grid.
+	 * @param origin Minimum coordinates of the grid.
+	 * @param voxelsize Size of a voxel.
+	 * @param sx Number of voxels along X-axis.
+	 * @param sy Number of voxels along Y-axis.
+	 * @param sz Number of voxels along Z-axis.
+	 */
+	voxel_grid( const vec3& origin, float voxelsize, size_t sx, size_t sy, size_t sz );
+
+	/** Clears all voxels. */
+	void			clear();
+
+	/** Sets voxel (x,y,z). */
+	void			set( size_t x, size_t y, size_t z )			{m_bits[index(x,y,z)>>5] |= 1u << (index(x,y,z)&31);}
+
+	/** Returns true if voxel (x,y,z) is set. */
+	bool			get( size_t x, size_t y, size_t z ) const	{return 0 != (m_bits[index(x,y,z)>>5] & (1u << (index(x,y,z)&31)));}
+
+	/**
+	 * Sets voxels touched by triangles of a mesh. Parts of triangles outside the grid are ignored.
+	 * @param vertices Vertex positions.
+	 * @param indices Three vertex indices per triangle. If 0, every three consecutive vertices form a triangle.
+	 * @param first First triangle to voxelize.
+	 * @param count Number of triangles to voxelize.
+	 */
+	void			voxelize( const vec3* vertices, const unsigned int* indices, size_t first, size_t count );
+
+	/**
+	 * Sets voxels which are set in other grid.
+	 * @param other Grid of the same dimensions.
+	 */
+	void			merge( const voxel_grid& other );
+
+	/** Returns number of set voxels. */
+	size_t			count() const;
+
+	/** Returns minimum coordinates of the grid. */
+	const vec3&		origin() const						{return m_origin;}
+
+	/** Returns size of a voxel. */
+	float			voxel_size() const					{return m_voxelsize;}
+
+	/** Returns number of voxels along X-axis. */
+	size_t			size_x() const						{return m_size[0];}
+
+	/** Returns number of voxels along Y-axis. */
+	size_t			size_y() const						{return m_size[1];}
+
+	/** Returns number of voxels along Z-axis. */
+	size_t			size_z() const						{return m_size[2];}
+
+	/** Returns voxel bits, bit i%32 of word i/32 is voxel i = x + (y + z*size_y())*size_x(). */
+	const unsigned int*	bits() const					{return m_bits.begin();}
+
+private:
+	vec3						m_origin;
+	float						m_voxelsize;
+	size_t						m_size[3];
+	vector_simd<unsigned int>	m_bits;
+
+	size_t			index( size_t x, size_t y, size_t z ) const		{SLMATH_VEC_ASSERT(x < m_size[0] && y < m_size[1] && z < m_size[2]); return x + (y + z*m_size[1])*m_size[0];}
+
+	voxel_grid();
+	voxel_grid( const voxel_grid& );
+	voxel_grid& operator=( const voxel_grid& );
+};
+
+SLMATH_END()
+
+#endif
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,142 @@
+#include <slm/affine.h>
+#include <slm/quat.h>
+
+SLMATH_BEGIN()
+
+affine::affine( float d )
+{
+	vec4* const r = v4();
+	r[0] = vec4( d,0,0,0 );
+	r[1] = vec4( 0,d,0,0 );
+	r[2] = vec4( 0,0,d,0 );
+}
+
+affine::affine( const mat4& m )
+{
+	SLMATH_VEC_ASSERT( m[0][3] == 0.f && m[1][3] == 0.f && m[2][3] == 0.f && m[3][3] == 1.f );
+
+	vec4* const r = v4();
+	for ( size_t i = 0 ; i < 3 ; ++i )
+		r[i] = vec4( m[0][i], m[1][i], m[2][i], m[3][i] );
+}
+
+affine::affine( const quat& q )
+{
+	*this = affine( mat4(q) );
+}
+
+affine::affine( const quat& q, const vec3& t )
+{
+	*this = affine( mat4(q) );
+	set_translation( t );
+}
+
+affine::affine( const vec4& r0, const vec4& r1, const vec4& r2 )
+{
+	vec4* const r = v4();
+	r[0] = r0;
+	r[1] = r1;
+	r[2] = r2;
+}
+
+bool affine::operator==( const affine& o ) const
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+	SLMATH_VEC_ASSERT( check(o) );
+
+	const vec4* const r = v4();
+	for ( size_t i = 0 ; i < 3 ; ++i )
+		if ( r[i] != o[i] )
+			return false;
+	return true;
+}
+
+bool affine::operator!=( const affine& o ) const
+{
+	return !(*this == o);
+}
+
+affine& affine::operator*=( const affine& o )
+{
+	return *this = *this * o;
+}
+
+affine affine::operator*( const affine& o ) const
+{
+	affine res;
+
+	// row i of the result is combination of rows of o, plus own translation
+	const float* const a = begin();
+	for ( size_t i = 0 ; i < 3 ; ++i )
+	{
+		const float* const ai = a + i*4;
+		const m128_t t = SLMATH_SET_PS( 0.f, 0.f, 0.f, ai[3] );
+		res.m_m128[i] = SLMATH_ADD_PS(
+			SLMATH_ADD_PS( SLMATH_MUL_PS(SLMATH_LOAD_PS1(ai+0),o.m_m128[0]), SLMATH_MUL_PS(SLMATH_LOAD_PS1(ai+1),o.m_m128[1]) ),
+			SLMATH_ADD_PS( SLMATH_MUL_PS(SLMATH_LOAD_PS1(ai+2),o.m_m128[2]), t ) );
+	}
+
+	SLMATH_VEC_ASSERT( check(res) );
+	return res;
+}
+
+mat4 to_mat4( const affine& a )
+{
+	return mat4( vec4(a[0].x,a[1].x,a[2].x,0.f), vec4(a[0].y,a[1].y,a[2].y,0.f), vec4(a[0].z,a[1].z,a[2].z,0.f), vec4(a[0].w,a[1].w,a[2].w,1.f) );
+}
+
+mat4 operator*( const mat4& m, const affine& a )
+{
+	return m * to_mat4(a);
+}
+
+mat4 operator*( const affine& a, const mat4& m )
+{
+	return to_mat4(a) * m;
+}
+
+affine operator*( const affine& a, const quat& q )
+{
+	return a * affine(q);
+}
+
+affine operator*( const quat& q, const affine& a )
+{
+	return affine(q) * a;
+}
+
+float det( const affine& a )
+{
+	return dot( a[0].xyz(), cross(a[1].xyz(),a[2].xyz()) );
+}
+
+affine inverse( const affine& a )
+{
+	// columns of the inverse 3x3 part are cross products of the rows divided by determinant
+	const vec3 r0 = a[0].xyz();
+	const vec3 r1 = a[1].xyz();
+	const vec3 r2 = a[2].xyz();
+	const vec3 c0 = cross( r1, r2 );
+	const vec3 c1 = cross( r2, r0 );
+	const vec3 c2 = cross( r0, r1 );
+	const float d = dot( r0, c0 );
+	SLMATH_VEC_ASSERT( fabsf(d) > FLT_MIN );
+
+	const float invd = 1.f / d;
+	affine res( vec4(c0.x,c1.x,c2.x,0.f)*invd, vec4(c0.y,c1.y,c2.y,0.f)*invd, vec4(c0.z,c1.z,c2.z,0.f)*invd );
+	res.set_translation( -transform_direction(res, a.translation()) );
+	return res;
+}
+
+affine inverse_orthonormal( const affine& a )
+{
+	const vec3 t = a.translation();
+	const vec3 c0 = a.column( 0 );
+	const vec3 c1 = a.column( 1 );
+	const vec3 c2 = a.column( 2 );
+	return affine( vec4(c0,-dot(c0,t)), vec4(c1,-dot(c1,t)), vec4(c2,-dot(c2,t)) );
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
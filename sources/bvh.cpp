@@ -0,0 +1,840 @@
+#include <slm/bvh.h>
+#include <slm/intersect_stats.h>
+#include <slm/morton.h>
+
+SLMATH_BEGIN()
+
+/** Number of bins used to evaluate split positions. */
+static const size_t BVH_BINS = 16;
+
+/** Maximum number of triangles in a leaf. */
+static const size_t BVH_LEAF_SIZE = triangle4::SIZE;
+
+/** Depth after which ranges are split in the middle, which bounds depth of the tree regardless of triangle distribution. */
+static const int BVH_SAH_DEPTH = 32;
+
+/** Ray tmax is scaled up by this in node tests, so that rounding in decompression never culls a child hit at the exact bounds. */
+static const float BVH_TMAX_SCALE = 1.f + 4.f*FLT_EPSILON;
+
+/** Largest quantized coordinate. */
+static const float BVH_QMAX = 255.f;
+
+vec3 bvh_node::child_min( size_t i ) const
+{
+	SLMATH_VEC_ASSERT( i < SIZE );
+	return vec3( origin[0] + float(qmin[0][i])*scale[0], origin[1] + float(qmin[1][i])*scale[1], origin[2] + float(qmin[2][i])*scale[2] );
+}
+
+vec3 bvh_node::child_max( size_t i ) const
+{
+	SLMATH_VEC_ASSERT( i < SIZE );
+	return vec3( origin[0] + float(qmax[0][i])*scale[0], origin[1] + float(qmax[1][i])*scale[1], origin[2] + float(qmax[2][i])*scale[2] );
+}
+
+/** Range of triangles waiting to be built to a node. */
+class bvh_task
+{
+public:
+	size_t	node;
+	size_t	begin;
+	size_t	end;
+	int		depth;
+};
+
+/** Returns surface area of a box, or half of it to be exact. */
+static inline float half_area( const vec3& bmin, const vec3& bmax )
+{
+	const vec3 e = bmax - bmin;
+	return e.x*e.y + e.y*e.z + e.z*e.x;
+}
+
+/** Computes bounds of triangles order[begin..end). */
+static void range_bounds( const vec3* trimin, const vec3* trimax, const unsigned int* order, size_t begin, size_t end, vec3* bmin, vec3* bmax )
+{
+	*bmin = trimin[order[begin]];
+	*bmax = trimax[order[begin]];
+	for ( size_t i = begin+1 ; i < end ; ++i )
+	{
+		*bmin = min( *bmin, trimin[order[i]] );
+		*bmax = max( *bmax, trimax[order[i]] );
+	}
+}
+
+/**
+ * Splits triangles order[begin..end) to two non-empty ranges, using binned surface area heuristic
+ * along the axis of largest centroid extent.
+ * @return First triangle of the second range.
+ */
+static size_t split_range( const vec3* trimin, const vec3* trimax, const vec3* centroid, unsigned int* order, size_t begin, size_t end, int depth )
+{
+	SLMATH_VEC_ASSERT( end-begin >= 2 );
+
+	vec3 cmin = centroid[order[begin]];
+	vec3 cmax = cmin;
+	for ( size_t i = begin+1 ; i < end ; ++i )
+	{
+		cmin = min( cmin, centroid[order[i]] );
+		cmax = max( cmax, centroid[order[i]] );
+	}
+	const vec3 ext = cmax - cmin;
+	const int axis = (ext.x > ext.y ? (ext.x > ext.z ? 0 : 2) : (ext.y > ext.z ? 1 : 2));
+	if ( !(ext[axis] > FLT_MIN) || depth >= BVH_SAH_DEPTH )
+		return begin + (end-begin)/2;
+
+	// bin triangles by centroid
+	const float binscale = float(BVH_BINS) * (1.f-FLT_EPSILON) / ext[axis];
+	size_t count[BVH_BINS];
+	vec3 binmin[BVH_BINS];
+	vec3 binmax[BVH_BINS];
+	for ( size_t k = 0 ; k < BVH_BINS ; ++k )
+	{
+		count[k] = 0;
+		binmin[k] = vec3( FLT_MAX );
+		binmax[k] = vec3( -FLT_MAX );
+	}
+	for ( size_t i = begin ; i < end ; ++i )
+	{
+		const unsigned int j = order[i];
+		size_t k = size_t( (centroid[j][axis] - cmin[axis]) * binscale );
+		if ( k >= BVH_BINS )
+			k = BVH_BINS-1;
+		++count[k];
+		binmin[k] = min( binmin[k], trimin[j] );
+		binmax[k] = max( binmax[k], trimax[j] );
+	}
+
+	// cost of splitting before bin k is area*count of the both sides
+	float rightcost[BVH_BINS];
+	vec3 bmin( FLT_MAX );
+	vec3 bmax( -FLT_MAX );
+	size_t n = 0;
+	for ( size_t k = BVH_BINS-1 ; k > 0 ; --k )
+	{
+		n += count[k];
+		bmin = min( bmin, binmin[k] );
+		bmax = max( bmax, binmax[k] );
+		rightcost[k] = (n > 0 ? half_area(bmin,bmax) * float(n) : 0.f);
+	}
+
+	size_t best = 0;
+	float bestcost = FLT_MAX;
+	bmin = vec3( FLT_MAX );
+	bmax = vec3( -FLT_MAX );
+	n = 0;
+	for ( size_t k = 1 ; k < BVH_BINS ; ++k )
+	{
+		n += count[k-1];
+		bmin = min( bmin, binmin[k-1] );
+		bmax = max( bmax, binmax[k-1] );
+		if ( 0 == n || end-begin == n )
+			continue;
+		const float cost = half_area(bmin,bmax) * float(n) + rightcost[k];
+		if ( cost < bestcost )
+		{
+			bestcost = cost;
+			best = k;
+		}
+	}
+	SLMATH_VEC_ASSERT( best > 0 );
+
+	// partition by bin
+	size_t i = begin;
+	size_t j = end;
+	while ( i < j )
+	{
+		const size_t k = size_t( (centroid[order[i]][axis] - cmin[axis]) * binscale );
+		if ( k < best )
+		{
+			++i;
+		}
+		else
+		{
+			--j;
+			const unsigned int tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+		}
+	}
+	return i;
+}
+
+/**
+ * Splits triangles order[begin..end), sorted by Morton code, at the highest bit where the codes differ.
+ * Ranges of equal codes are split in the middle.
+ * @return First triangle of the second range.
+ */
+static size_t split_morton( const unsigned int* codes, size_t begin, size_t end )
+{
+	SLMATH_VEC_ASSERT( end-begin >= 2 );
+
+	const unsigned int diff = codes[begin] ^ codes[end-1];
+	if ( 0 == diff )
+		return begin + (end-begin)/2;
+	unsigned int bit = 0x80000000u;
+	while ( 0 == (diff & bit) )
+		bit >>= 1;
+
+	// codes share the bits above, so the bit is clear in the first part and set in the second
+	size_t lo = begin;
+	size_t hi = end-1;
+	while ( hi-lo > 1 )
+	{
+		const size_t mid = lo + (hi-lo)/2;
+		if ( codes[mid] & bit )
+			hi = mid;
+		else
+			lo = mid;
+	}
+	return hi;
+}
+
+/** Range split of SAH build. */
+class bvh_sah_split
+{
+public:
+	const vec3*		trimin;
+	const vec3*		trimax;
+	const vec3*		centroid;
+
+	size_t operator()( unsigned int* order, size_t begin, size_t end, int depth ) const	{return split_range( trimin, trimax, centroid, order, begin, end, depth );}
+};
+
+/** Range split of linear build, codes are in the same order as the sorted triangles. */
+class bvh_morton_split
+{
+public:
+	const unsigned int*	codes;
+
+	size_t operator()( unsigned int*, size_t begin, size_t end, int ) const				{return split_morton( codes, begin, end );}
+};
+
+/** Stores child bounds to the node, quantized to a grid over the node bounds and rounded outwards. */
+static void quantize_children( bvh_node* node, const vec3& nodemin, const vec3& nodemax, const vec3* childmin, const vec3* childmax, size_t n )
+{
+	for ( size_t a = 0 ; a < 3 ; ++a )
+	{
+		// make sure the grid reaches the node bounds despite rounding
+		const float o = nodemin[a];
+		float s = (nodemax[a] - o) / BVH_QMAX;
+		while ( o + BVH_QMAX*s < nodemax[a] )
+			s = s*(1.f+FLT_EPSILON) + FLT_MIN;
+		const float inv = (s > 0.f ? 1.f/s : 0.f);
+		node->origin[a] = o;
+		node->scale[a] = s;
+
+		for ( size_t i = 0 ; i < bvh_node::SIZE ; ++i )
+		{
+			if ( i >= n )
+			{
+				node->qmin[a][i] = 255;
+				node->qmax[a][i] = 0;
+				continue;
+			}
+
+			float lo = floorf( (childmin[i][a] - o) * inv );
+			lo = (lo < 0.f ? 0.f : lo > BVH_QMAX ? BVH_QMAX : lo);
+			while ( lo > 0.f && o + lo*s > childmin[i][a] )
+				lo -= 1.f;
+
+			float hi = ceilf( (childmax[i][a] - o) * inv );
+			hi = (hi < 0.f ? 0.f : hi > BVH_QMAX ? BVH_QMAX : hi);
+			while ( hi < BVH_QMAX && o + hi*s < childmax[i][a] )
+				hi += 1.f;
+
+			node->qmin[a][i] = (unsigned char)lo;
+			node->qmax[a][i] = (unsigned char)hi;
+		}
+	}
+}
+
+/** Identifies bvh image, 'SBVH' in little endian byte order. */
+static const unsigned int BVH_IMAGE_MAGIC = 0x48564253u;
+
+/** Version of bvh image layout. Increment whenever the layout or meaning of the data changes. */
+static const unsigned int BVH_IMAGE_VERSION = 2;
+
+/** Alignment of data array offsets in bvh image. */
+static const size_t BVH_IMAGE_ALIGN = 64;
+
+/**
+ * Header at the beginning of bvh image. Arrays follow the header at specified offsets from the beginning of the image,
+ * aligned to BVH_IMAGE_ALIGN bytes: nodes, triangle blocks and triangle indices.
+ * Sizes of the node and block types are stored to catch images from platforms with different data layout.
+ */
+class bvh_image_header
+{
+public:
+	unsigned int	magic;
+	unsigned int	version;
+	unsigned int	imagesize;
+	unsigned int	nodesize;
+	unsigned int	blocksize;
+	unsigned int	trianglecount;
+	unsigned int	nodecount;
+	unsigned int	blockcount;
+	unsigned int	nodeoffset;
+	unsigned int	blockoffset;
+	unsigned int	indexoffset;
+	float			boundsmin[3];
+	float			boundsmax[3];
+};
+
+/** Returns offset rounded up to BVH_IMAGE_ALIGN. */
+static inline size_t align_image_offset( size_t offset )
+{
+	return (offset + BVH_IMAGE_ALIGN-1) & ~(BVH_IMAGE_ALIGN-1);
+}
+
+/**
+ * Fills in sizes and offsets of image header of the hierarchy.
+ * @return Size of the image in bytes, 0 if too large to be addressed by 32-bit offsets.
+ */
+static size_t layout_image( bvh_image_header* h, size_t nodecount, size_t blockcount )
+{
+	const size_t nodeoffset = align_image_offset( sizeof(bvh_image_header) );
+	const size_t blockoffset = align_image_offset( nodeoffset + nodecount*sizeof(bvh_node) );
+	const size_t indexoffset = align_image_offset( blockoffset + blockcount*sizeof(triangle4) );
+	const size_t imagesize = align_image_offset( indexoffset + blockcount*triangle4::SIZE*sizeof(unsigned int) );
+
+	h->nodesize = sizeof(bvh_node);
+	h->blocksize = sizeof(triangle4);
+	h->nodecount = (unsigned int)nodecount;
+	h->blockcount = (unsigned int)blockcount;
+	h->nodeoffset = (unsigned int)nodeoffset;
+	h->blockoffset = (unsigned int)blockoffset;
+	h->indexoffset = (unsigned int)indexoffset;
+	h->imagesize = (unsigned int)imagesize;
+	return (imagesize == h->imagesize ? imagesize : 0);
+}
+
+bvh::bvh() :
+	m_size( 0 ),
+	m_boundsmin( 0.f ),
+	m_boundsmax( 0.f ),
+	m_nodeptr( 0 ),
+	m_nodecount( 0 ),
+	m_blockptr( 0 ),
+	m_blockcount( 0 ),
+	m_indexptr( 0 )
+{
+	clear_tree( 0 );
+}
+
+void bvh::set_owned_data()
+{
+	m_nodeptr = m_nodes.begin();
+	m_nodecount = m_nodes.size();
+	m_blockptr = m_blocks.begin();
+	m_blockcount = m_blocks.size();
+	m_indexptr = m_indices.begin();
+}
+
+size_t bvh::image_size() const
+{
+	bvh_image_header h;
+	return layout_image( &h, m_nodecount, m_blockcount );
+}
+
+size_t bvh::save_image( void* image, size_t size ) const
+{
+	bvh_image_header h;
+	const size_t imagesize = layout_image( &h, m_nodecount, m_blockcount );
+	if ( 0 == imagesize || size < imagesize )
+		return 0;
+
+	h.magic = BVH_IMAGE_MAGIC;
+	h.version = BVH_IMAGE_VERSION;
+	h.trianglecount = (unsigned int)m_size;
+	for ( size_t i = 0 ; i < 3 ; ++i )
+	{
+		h.boundsmin[i] = m_boundsmin[i];
+		h.boundsmax[i] = m_boundsmax[i];
+	}
+
+	char* const buf = reinterpret_cast<char*>( image );
+	memset( buf, 0, h.imagesize );
+	memcpy( buf, &h, sizeof(h) );
+	memcpy( buf + h.nodeoffset, m_nodeptr, m_nodecount*sizeof(bvh_node) );
+	memcpy( buf + h.blockoffset, m_blockptr, m_blockcount*sizeof(triangle4) );
+	memcpy( buf + h.indexoffset, m_indexptr, m_blockcount*triangle4::SIZE*sizeof(unsigned int) );
+	return h.imagesize;
+}
+
+/**
+ * Checks that node references of an image stay inside its arrays. Inner nodes must come after their parents
+ * and at most bvh::MAX_DEPTH levels deep, as written by the builders, so traversal terminates within its stack.
+ */
+static bool valid_image_nodes( const bvh_node* nodes, size_t nodecount, size_t blockcount )
+{
+	vector_simd<unsigned char> depth;
+	depth.resize( nodecount );
+	memset( depth.begin(), 0, nodecount );
+	for ( size_t i = 0 ; i < nodecount ; ++i )
+	{
+		for ( size_t k = 0 ; k < bvh_node::SIZE ; ++k )
+		{
+			const unsigned int ref = nodes[i].child[k];
+			if ( 0 == ref )
+				continue;
+			if ( bvh_node::is_leaf(ref) )
+			{
+				if ( bvh_node::leaf_block(ref) >= blockcount )
+					return false;
+				continue;
+			}
+			const size_t child = bvh_node::inner_index( ref );
+			if ( child <= i || child >= nodecount || depth[i]+1 >= bvh::MAX_DEPTH )
+				return false;
+			depth[child] = (unsigned char)max( int(depth[child]), depth[i]+1 );
+		}
+	}
+	return true;
+}
+
+bool bvh::load_image( const void* image, size_t size )
+{
+	clear_tree( 0 );
+
+	const char* const buf = reinterpret_cast<const char*>( image );
+	if ( 0 != ((size_t)buf & 15) || size < sizeof(bvh_image_header) )
+		return false;
+	const bvh_image_header& h = *reinterpret_cast<const bvh_image_header*>( buf );
+	if ( h.magic != BVH_IMAGE_MAGIC || h.version != BVH_IMAGE_VERSION || h.nodesize != sizeof(bvh_node) || h.blocksize != sizeof(triangle4) )
+		return false;
+
+	// layout must be exactly what this version would write, which also bounds the arrays to the image
+	bvh_image_header expected;
+	const size_t imagesize = layout_image( &expected, h.nodecount, h.blockcount );
+	if ( h.nodecount < 1 || 0 == imagesize || imagesize > size || h.imagesize != expected.imagesize ||
+		h.nodeoffset != expected.nodeoffset || h.blockoffset != expected.blockoffset || h.indexoffset != expected.indexoffset )
+		return false;
+	const bvh_node* const nodes = reinterpret_cast<const bvh_node*>( buf + h.nodeoffset );
+	const unsigned int* const indices = reinterpret_cast<const unsigned int*>( buf + h.indexoffset );
+	if ( !valid_image_nodes(nodes, h.nodecount, h.blockcount) )
+		return false;
+	for ( size_t i = 0 ; i < size_t(h.blockcount)*triangle4::SIZE ; ++i )
+		if ( indices[i] >= h.trianglecount && indices[i] != 0xFFFFFFFFu )
+			return false;
+
+	m_size = h.trianglecount;
+	m_boundsmin = vec3( h.boundsmin[0], h.boundsmin[1], h.boundsmin[2] );
+	m_boundsmax = vec3( h.boundsmax[0], h.boundsmax[1], h.boundsmax[2] );
+	m_nodeptr = nodes;
+	m_nodecount = h.nodecount;
+	m_blockptr = reinterpret_cast<const triangle4*>( buf + h.blockoffset );
+	m_blockcount = h.blockcount;
+	m_indexptr = indices;
+	return true;
+}
+
+void bvh::clear_tree( size_t n )
+{
+	m_size = n;
+	m_nodes.resize( 1 );
+	m_blocks.resize( 0 );
+	m_indices.resize( 0 );
+	memset( &m_nodes[0], 0, sizeof(bvh_node) );
+	m_boundsmin = m_boundsmax = vec3( 0.f );
+	set_owned_data();
+}
+
+/** Computes bounds and centroids of triangles, and sets order to identity. */
+static void triangle_bounds( const vec3* vertices, const unsigned int* indices, size_t n, vec3* trimin, vec3* trimax, vec3* centroid, unsigned int* order )
+{
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const vec3& v0 = vertices[indices ? indices[i*3] : i*3];
+		const vec3& v1 = vertices[indices ? indices[i*3+1] : i*3+1];
+		const vec3& v2 = vertices[indices ? indices[i*3+2] : i*3+2];
+		trimin[i] = min( v0, min(v1,v2) );
+		trimax[i] = max( v0, max(v1,v2) );
+		centroid[i] = (trimin[i] + trimax[i]) * .5f;
+		order[i] = (unsigned int)i;
+	}
+}
+
+void bvh::build( const vec3* vertices, const unsigned int* indices, size_t n )
+{
+	clear_tree( n );
+	if ( 0 == n )
+		return;
+
+	vector_simd<vec3> trimin;
+	vector_simd<vec3> trimax;
+	vector_simd<vec3> centroid;
+	vector_simd<unsigned int> order;
+	trimin.resize( n );
+	trimax.resize( n );
+	centroid.resize( n );
+	order.resize( n );
+	triangle_bounds( vertices, indices, n, trimin.begin(), trimax.begin(), centroid.begin(), order.begin() );
+
+	bvh_sah_split split;
+	split.trimin = trimin.begin();
+	split.trimax = trimax.begin();
+	split.centroid = centroid.begin();
+	build_tree( vertices, indices, trimin.begin(), trimax.begin(), order.begin(), split );
+}
+
+void bvh::build_lbvh( const vec3* vertices, const unsigned int* indices, size_t n )
+{
+	clear_tree( n );
+	if ( 0 == n )
+		return;
+
+	vector_simd<vec3> trimin;
+	vector_simd<vec3> trimax;
+	vector_simd<vec3> centroid;
+	vector_simd<unsigned int> order;
+	trimin.resize( n );
+	trimax.resize( n );
+	centroid.resize( n );
+	order.resize( n );
+	triangle_bounds( vertices, indices, n, trimin.begin(), trimax.begin(), centroid.begin(), order.begin() );
+
+	// sort triangles by Morton code of centroid within centroid bounds
+	vec3 cmin = centroid[0];
+	vec3 cmax = cmin;
+	for ( size_t i = 1 ; i < n ; ++i )
+	{
+		cmin = min( cmin, centroid[i] );
+		cmax = max( cmax, centroid[i] );
+	}
+	vector_simd<unsigned int> codes;
+	vector_simd<unsigned int> tempcodes;
+	vector_simd<unsigned int> temporder;
+	codes.resize( n );
+	tempcodes.resize( n );
+	temporder.resize( n );
+	morton_codes30( centroid.begin(), n, cmin, cmax, codes.begin() );
+	radix_sort( codes.begin(), order.begin(), n, tempcodes.begin(), temporder.begin() );
+
+	bvh_morton_split split;
+	split.codes = codes.begin();
+	build_tree( vertices, indices, trimin.begin(), trimax.begin(), order.begin(), split );
+}
+
+template <class T> void bvh::build_tree( const vec3* vertices, const unsigned int* indices, const vec3* trimin, const vec3* trimax, unsigned int* order, const T& split )
+{
+	const size_t n = m_size;
+	range_bounds( trimin, trimax, order, 0, n, &m_boundsmin, &m_boundsmax );
+
+	vector_simd<bvh_task> tasks;
+	bvh_task root;
+	root.node = 0;
+	root.begin = 0;
+	root.end = n;
+	root.depth = 0;
+	tasks.push_back( root );
+
+	while ( !tasks.empty() )
+	{
+		const bvh_task task = tasks.back();
+		tasks.pop_back();
+		SLMATH_VEC_ASSERT( task.depth < MAX_DEPTH );
+
+		// split the largest range until there is a range for each child
+		size_t begin[bvh_node::SIZE];
+		size_t end[bvh_node::SIZE];
+		size_t count = 1;
+		begin[0] = task.begin;
+		end[0] = task.end;
+		while ( count < bvh_node::SIZE )
+		{
+			size_t largest = 0;
+			for ( size_t i = 1 ; i < count ; ++i )
+				if ( end[i]-begin[i] > end[largest]-begin[largest] )
+					largest = i;
+			if ( end[largest]-begin[largest] <= BVH_LEAF_SIZE )
+				break;
+
+			const size_t mid = split( order, begin[largest], end[largest], task.depth );
+			begin[count] = mid;
+			end[count] = end[largest];
+			end[largest] = mid;
+			++count;
+		}
+
+		// leaves are stored right away, inner nodes are appended and left for later
+		vec3 childmin[bvh_node::SIZE];
+		vec3 childmax[bvh_node::SIZE];
+		unsigned int child[bvh_node::SIZE] = {0,0,0,0};
+		for ( size_t i = 0 ; i < count ; ++i )
+		{
+			range_bounds( trimin, trimax, order, begin[i], end[i], &childmin[i], &childmax[i] );
+
+			if ( end[i]-begin[i] <= BVH_LEAF_SIZE )
+			{
+				const size_t first = m_blocks.size();
+				m_blocks.resize( first+1 );
+				m_indices.resize( (first+1)*triangle4::SIZE );
+				triangle4& block = m_blocks[first];
+				for ( size_t k = 0 ; k < triangle4::SIZE ; ++k )
+				{
+					const size_t j = begin[i]+k;
+					if ( j < end[i] )
+					{
+						const size_t tri = order[j];
+						block.set( k, vertices[indices ? indices[tri*3] : tri*3], vertices[indices ? indices[tri*3+1] : tri*3+1], vertices[indices ? indices[tri*3+2] : tri*3+2] );
+						m_indices[first*triangle4::SIZE+k] = (unsigned int)tri;
+					}
+					else
+					{
+						block.clear( k );
+						m_indices[first*triangle4::SIZE+k] = 0xFFFFFFFFu;
+					}
+				}
+				child[i] = bvh_node::make_leaf( first );
+			}
+			else
+			{
+				bvh_task sub;
+				sub.node = m_nodes.size();
+				sub.begin = begin[i];
+				sub.end = end[i];
+				sub.depth = task.depth+1;
+				m_nodes.resize( sub.node+1 );
+				tasks.push_back( sub );
+				child[i] = bvh_node::make_inner( sub.node );
+			}
+		}
+
+		bvh_node* const node = &m_nodes[task.node];
+		vec3 nodemin = childmin[0];
+		vec3 nodemax = childmax[0];
+		for ( size_t i = 1 ; i < count ; ++i )
+		{
+			nodemin = min( nodemin, childmin[i] );
+			nodemax = max( nodemax, childmax[i] );
+		}
+		quantize_children( node, nodemin, nodemax, childmin, childmax, count );
+		for ( size_t i = 0 ; i < bvh_node::SIZE ; ++i )
+			node->child[i] = child[i];
+	}
+	set_owned_data();
+}
+
+int intersect_ray_bvh_node( const ray& r, const bvh_node& node, float* tnear )
+{
+	const intersect_line_box_line& line = r.box_line;
+	const int* const sign = &line.signx;
+	const float tmax = r.tmax * BVH_TMAX_SCALE;
+	m128_t t0 = SLMATH_LOAD_PS1( &r.tmin );
+	m128_t t1 = SLMATH_LOAD_PS1( &tmax );
+
+	for ( size_t a = 0 ; a < 3 ; ++a )
+	{
+		// decompress child bounds relative to ray origin, then clip against the slabs
+		const float d = node.origin[a] - line.o[a];
+		const m128_t d4 = SLMATH_LOAD_PS1( &d );
+		const m128_t s4 = SLMATH_LOAD_PS1( &node.scale[a] );
+		const m128_t inv4 = SLMATH_LOAD_PS1( &line.inv_d[a] );
+		const m128_t lo = SLMATH_MUL_PS( SLMATH_ADD_PS(d4, SLMATH_MUL_PS(SLMATH_LOAD_U8_PS(node.qmin[a]),s4)), inv4 );
+		const m128_t hi = SLMATH_MUL_PS( SLMATH_ADD_PS(d4, SLMATH_MUL_PS(SLMATH_LOAD_U8_PS(node.qmax[a]),s4)), inv4 );
+		// slab first, since min and max return the second operand if either is NaN, so 0*inf with ray origin on the plane is discarded
+		t0 = SLMATH_MAX_PS( sign[a] ? hi : lo, t0 );
+		t1 = SLMATH_MIN_PS( sign[a] ? lo : hi, t1 );
+	}
+
+	SLMATH_STOREU_PS( tnear, t0 );
+	int valid = 0;
+	for ( size_t i = 0 ; i < bvh_node::SIZE ; ++i )
+		valid |= (0 != node.child[i]) << i;
+	return SLMATH_MOVEMASK_PS( SLMATH_CMPLE_PS(t0,t1) ) & valid;
+}
+
+bool intersect_ray_bvh( ray& r, ray_query mode, const bvh& tree, ray_hit* hit )
+{
+	const bvh_node* const nodes = tree.nodes();
+	const triangle4* const blocks = tree.blocks();
+	const unsigned int* const indices = tree.triangle_indices();
+	bool found = false;
+
+	// stack of node references and their entry points, reference 0 is the root here
+	unsigned int stack[bvh::STACK_SIZE];
+	float stackt[bvh::STACK_SIZE];
+	size_t sp = 0;
+	stack[sp] = 0;
+	stackt[sp++] = r.tmin;
+	SLMATH_STATS_ADD( queries, 1 );
+
+	while ( sp > 0 )
+	{
+		--sp;
+		if ( stackt[sp] > r.tmax )
+		{
+			SLMATH_STATS_ADD( early_outs, 1 );
+			continue;
+		}
+
+		SLMATH_STATS_ADD( node_visits, 1 );
+		const unsigned int ref = stack[sp];
+		if ( bvh_node::is_leaf(ref) )
+		{
+			const size_t b = bvh_node::leaf_block( ref );
+			SLMATH_STATS_ADD( triangle_tests, triangle4::SIZE );
+			float t, u, v;
+			const int k = intersect_line_triangle4( r.triangle_line, blocks[b], r.tmin, r.tmax, &t, &u, &v );
+			if ( k >= 0 )
+			{
+				if (hit)
+				{
+					hit->t = t;
+					hit->u = u;
+					hit->v = v;
+					hit->index = indices[b*triangle4::SIZE + size_t(k)];
+				}
+				if ( RAY_ANY_HIT == mode )
+				{
+					SLMATH_STATS_ADD( early_outs, 1 );
+					return true;
+				}
+				r.tmax = t;
+				found = true;
+			}
+			continue;
+		}
+
+		// push children sorted so that the nearest is popped first
+		const bvh_node& node = nodes[bvh_node::inner_index(ref)];
+		float tnear[bvh_node::SIZE];
+		int mask = intersect_ray_bvh_node( r, node, tnear );
+		SLMATH_STATS_ADD( box_tests, bvh_node::SIZE );
+		const size_t first = sp;
+		for ( size_t k = 0 ; mask ; ++k, mask >>= 1 )
+		{
+			if ( 0 == (mask & 1) )
+				continue;
+
+			SLMATH_VEC_ASSERT( sp < bvh::STACK_SIZE );
+			const float t = tnear[k];
+			size_t i = sp++;
+			for ( ; i > first && stackt[i-1] < t ; --i )
+			{
+				stack[i] = stack[i-1];
+				stackt[i] = stackt[i-1];
+			}
+			stack[i] = node.child[k];
+			stackt[i] = t;
+		}
+	}
+	return found;
+}
+
+/** Returns bit mask of children of the node within squared distance maxdist2 of point p, and squared distance to each in dist2. */
+static int closest_point_bvh_node( const vec3& p, const bvh_node& node, float maxdist2, float* dist2 )
+{
+	const m128_t zero = SLMATH_SETZERO_PS();
+	m128_t d2 = zero;
+	for ( size_t a = 0 ; a < 3 ; ++a )
+	{
+		// distance outside the slab, zero inside
+		const float d = p[a] - node.origin[a];
+		const m128_t d4 = SLMATH_LOAD_PS1( &d );
+		const m128_t s4 = SLMATH_LOAD_PS1( &node.scale[a] );
+		const m128_t lo = SLMATH_SUB_PS( SLMATH_MUL_PS(SLMATH_LOAD_U8_PS(node.qmin[a]),s4), d4 );
+		const m128_t hi = SLMATH_SUB_PS( d4, SLMATH_MUL_PS(SLMATH_LOAD_U8_PS(node.qmax[a]),s4) );
+		const m128_t out = SLMATH_MAX_PS( zero, SLMATH_MAX_PS(lo,hi) );
+		d2 = SLMATH_ADD_PS( d2, SLMATH_MUL_PS(out,out) );
+	}
+
+	SLMATH_STOREU_PS( dist2, d2 );
+	int valid = 0;
+	for ( size_t i = 0 ; i < bvh_node::SIZE ; ++i )
+		valid |= (0 != node.child[i]) << i;
+	return SLMATH_MOVEMASK_PS( SLMATH_CMPLE_PS(d2,SLMATH_LOAD_PS1(&maxdist2)) ) & valid;
+}
+
+bool closest_point_bvh( const vec3& p, const bvh& tree, float maxdist, closest_point_hit* hit )
+{
+	SLMATH_VEC_ASSERT( maxdist >= 0.f );
+
+	const bvh_node* const nodes = tree.nodes();
+	const triangle4* const blocks = tree.blocks();
+	const unsigned int* const indices = tree.triangle_indices();
+	float best2 = maxdist*maxdist;
+	size_t bestblock = 0;
+	size_t bestlane = 0;
+	float bestu = 0.f;
+	float bestv = 0.f;
+	bool found = false;
+
+	// stack of node references and their squared distances, reference 0 is the root here
+	unsigned int stack[bvh::STACK_SIZE];
+	float stackd2[bvh::STACK_SIZE];
+	size_t sp = 0;
+	stack[sp] = 0;
+	stackd2[sp++] = 0.f;
+	SLMATH_STATS_ADD( queries, 1 );
+
+	while ( sp > 0 )
+	{
+		--sp;
+		if ( stackd2[sp] > best2 )
+		{
+			SLMATH_STATS_ADD( early_outs, 1 );
+			continue;
+		}
+
+		SLMATH_STATS_ADD( node_visits, 1 );
+		const unsigned int ref = stack[sp];
+		if ( bvh_node::is_leaf(ref) )
+		{
+			const size_t b = bvh_node::leaf_block( ref );
+			SLMATH_STATS_ADD( triangle_tests, triangle4::SIZE );
+			float d2[triangle4::SIZE], u[triangle4::SIZE], v[triangle4::SIZE];
+			closest_point_triangle4( p, blocks[b], d2, u, v );
+			for ( size_t k = 0 ; k < triangle4::SIZE ; ++k )
+			{
+				if ( 0xFFFFFFFFu == indices[b*triangle4::SIZE+k] )
+					continue;
+				if ( d2[k] < best2 || (!found && d2[k] <= best2) )
+				{
+					best2 = d2[k];
+					bestblock = b;
+					bestlane = k;
+					bestu = u[k];
+					bestv = v[k];
+					found = true;
+				}
+			}
+			continue;
+		}
+
+		// push children sorted so that the nearest is popped first
+		const bvh_node& node = nodes[bvh_node::inner_index(ref)];
+		float d2[bvh_node::SIZE];
+		int mask = closest_point_bvh_node( p, node, best2, d2 );
+		SLMATH_STATS_ADD( box_tests, bvh_node::SIZE );
+		const size_t first = sp;
+		for ( size_t k = 0 ; mask ; ++k, mask >>= 1 )
+		{
+			if ( 0 == (mask & 1) )
+				continue;
+
+			SLMATH_VEC_ASSERT( sp < bvh::STACK_SIZE );
+			size_t i = sp++;
+			for ( ; i > first && stackd2[i-1] < d2[k] ; --i )
+			{
+				stack[i] = stack[i-1];
+				stackd2[i] = stackd2[i-1];
+			}
+			stack[i] = node.child[k];
+			stackd2[i] = d2[k];
+		}
+	}
+
+	if ( found && hit )
+	{
+		const triangle4& tri = blocks[bestblock];
+		const vec3 v0 = tri.vertex( bestlane, 0 );
+		hit->point = v0 + (tri.vertex(bestlane,1) - v0)*bestu + (tri.vertex(bestlane,2) - v0)*bestv;
+		hit->distance = sqrtf( best2 );
+		hit->u = bestu;
+		hit->v = bestv;
+		hit->index = indices[bestblock*triangle4::SIZE + bestlane];
+	}
+	return found;
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
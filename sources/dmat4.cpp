@@ -0,0 +1,235 @@
+#include <slm/dmat4.h>
+#include <slm/dquat.h>
+
+// for computing matrix minors
+#define DET2(a,b,c,d) ( a*d-b*c )
+#define DET3(a,b,c, d,e,f, g,h,i) ( a*DET2(e,f,h,i) - b*DET2(d,f,g,i) + c*DET2(d,e,g,h) )
+#define DET4(a,b,c,d, e,f,g,h, i,j,k,l, m,n,o,p) ( a*DET3(f,g,h,j,k,l,n,o,p) - b*DET3(e,g,h,i,k,l,m,o,p) + c*DET3(e,f,h,i,j,l,m,n,p) - d*DET3(e,f,g,i,j,k,m,n,o) )
+
+SLMATH_BEGIN()
+
+dmat4::dmat4( double d )
+{
+	m_cols[0] = dvec4( d,0,0,0 );
+	m_cols[1] = dvec4( 0,d,0,0 );
+	m_cols[2] = dvec4( 0,0,d,0 );
+	m_cols[3] = dvec4( 0,0,0,d );
+}
+
+dmat4::dmat4( const mat4& m )
+{
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		m_cols[i] = dvec4( m[i] );
+}
+
+dmat4::dmat4( const dquat& q )
+{
+	const double sqw = q.w*q.w;
+	const double sqx = q.x*q.x;
+	const double sqy = q.y*q.y;
+	const double sqz = q.z*q.z;
+	const double qlen = sqx + sqy + sqz + sqw;
+
+	SLMATH_VEC_ASSERT( qlen > DBL_MIN );
+	const double invs = 1.0 / qlen; // only needed if not normalized
+	const double xy = q.x*q.y;
+	const double zw = q.z*q.w;
+	const double xz = q.x*q.z;
+	const double yw = q.y*q.w;
+	const double yz = q.y*q.z;
+	const double xw = q.x*q.w;
+
+	m_cols[0] = dvec4( (sqx-sqy-sqz+sqw)*invs, 2.0*(xy+zw)*invs, 2.0*(xz-yw)*invs, 0.0 );
+	m_cols[1] = dvec4( 2.0*(xy-zw)*invs, (-sqx+sqy-sqz+sqw)*invs, 2.0*(yz+xw)*invs, 0.0 );
+	m_cols[2] = dvec4( 2.0*(xz+yw)*invs, 2.0*(yz-xw)*invs, (-sqx-sqy+sqz+sqw)*invs, 0.0 );
+	m_cols[3] = dvec4( 0.0, 0.0, 0.0, 1.0 );
+}
+
+dmat4::dmat4( const dvec4& c0, const dvec4& c1, const dvec4& c2, const dvec4& c3 )
+{
+	m_cols[0] = c0;
+	m_cols[1] = c1;
+	m_cols[2] = c2;
+	m_cols[3] = c3;
+}
+
+dmat4& dmat4::operator+=( const dmat4& o )
+{
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		m_cols[i] += o.m_cols[i];
+	return *this;
+}
+
+dmat4& dmat4::operator-=( const dmat4& o )
+{
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		m_cols[i] -= o.m_cols[i];
+	return *this;
+}
+
+dmat4& dmat4::operator*=( double s )
+{
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		m_cols[i] *= s;
+	return *this;
+}
+
+dmat4& dmat4::operator*=( const dmat4& o )
+{
+	return *this = *this * o;
+}
+
+bool dmat4::operator==( const dmat4& o ) const
+{
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		if ( m_cols[i] != o.m_cols[i] )
+			return false;
+	return true;
+}
+
+bool dmat4::operator!=( const dmat4& o ) const
+{
+	return !(*this == o);
+}
+
+dmat4 dmat4::operator+( const dmat4& o ) const
+{
+	dmat4 res( *this );
+	return res += o;
+}
+
+dmat4 dmat4::operator-( const dmat4& o ) const
+{
+	dmat4 res( *this );
+	return res -= o;
+}
+
+dmat4 dmat4::operator*( double s ) const
+{
+	dmat4 res( *this );
+	return res *= s;
+}
+
+dmat4 dmat4::operator*( const dmat4& o ) const
+{
+	// column j of the result is this matrix times column j of o
+	const dmat4& m = *this;
+	return dmat4( m*o[0], m*o[1], m*o[2], m*o[3] );
+}
+
+dmat4 transpose( const dmat4& m )
+{
+	dmat4 res;
+	for ( size_t j = 0 ; j < 4 ; ++j )
+	{
+		res[0][j] = m[j][0];
+		res[1][j] = m[j][1];
+		res[2][j] = m[j][2];
+		res[3][j] = m[j][3];
+	}
+	return res;
+}
+
+double det( const dmat4& m )
+{
+	const double res = DET4( m[0][0],m[0][1],m[0][2],m[0][3], m[1][0],m[1][1],m[1][2],m[1][3], m[2][0],m[2][1],m[2][2],m[2][3], m[3][0],m[3][1],m[3][2],m[3][3] );
+	SLMATH_VEC_ASSERT( check(res) );
+	return res;
+}
+
+dmat4 inverse( const dmat4& m0 )
+{
+	SLMATH_VEC_ASSERT( check(m0) );
+
+	const double* const mp = m0.begin();
+	const double a = mp[0];	const double b = mp[1];	const double c = mp[2];	const double d = mp[3];
+	const double e = mp[4];	const double f = mp[5];	const double g = mp[6];	const double h = mp[7];
+	const double i = mp[8];	const double j = mp[9];	const double k = mp[10];	const double l = mp[11];
+	const double m = mp[12];	const double n = mp[13];	const double o = mp[14];	const double p = mp[15];
+	
+	const double min_a = DET3(f,g,h,j,k,l,n,o,p);
+	const double min_b = DET3(e,g,h,i,k,l,m,o,p);
+	const double min_c = DET3(e,f,h,i,j,l,m,n,p);
+	const double min_d = DET3(e,f,g,i,j,k,m,n,o);
+	const double det_m = a*min_a - b*min_b + c*min_c - d*min_d;
+	SLMATH_VEC_ASSERT( det_m > DBL_MIN || det_m < -DBL_MIN ); // invertible?
+
+	dmat4 res;
+	res[0][0] = min_a;
+	res[1][0] = -min_b;
+	res[2][0] = min_c;
+	res[3][0] = -min_d;
+	res[0][1] = -DET3(b,c,d,j,k,l,n,o,p);
+	res[1][1] = DET3(a,c,d,i,k,l,m,o,p);
+	res[2][1] = -DET3(a,b,d,i,j,l,m,n,p);
+	res[3][1] = DET3(a,b,c,i,j,k,m,n,o);
+	res[0][2] = DET3(b,c,d,f,g,h,n,o,p);
+	res[1][2] = -DET3(a,c,d,e,g,h,m,o,p);
+	res[2][2] = DET3(a,b,d,e,f,h,m,n,p);
+	res[3][2] = -DET3(a,b,c,e,f,g,m,n,o);
+	res[0][3] = -DET3(b,c,d,f,g,h,j,k,l);
+	res[1][3] = DET3(a,c,d,e,g,h,i,k,l);
+	res[2][3] = -DET3(a,b,d,e,f,h,i,j,l);
+	res[3][3] = DET3(a,b,c,e,f,g,i,j,k);
+	return res * (1.0/det_m);
+}
+
+dmat4 translation( const dvec3& t )
+{
+	SLMATH_VEC_ASSERT( check(t) );
+	return dmat4( dvec4(1,0,0,0), dvec4(0,1,0,0), dvec4(0,0,1,0), dvec4(t,1.0) );
+}
+
+mat4 to_mat4( const dmat4& m )
+{
+	mat4 res;
+	m128_t* const r = res.m128();
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		r[i] = SLMATH_CVTPD_PS( m[i].m256d() );
+	return res;
+}
+
+mat4 camera_relative( const dmat4& m, const dvec3& camera )
+{
+	mat4 res;
+	camera_relative( &m, 1, camera, &res );
+	return res;
+}
+
+void camera_relative( const dmat4* m, size_t n, const dvec3& camera, mat4* out )
+{
+	// translation(-camera) * m subtracts camera scaled by W-component from each column
+	const m256d_t c = SLMATH_SET_PD( camera.x, camera.y, camera.z, 0.0 );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		m128_t* const r = out[i].m128();
+		for ( size_t j = 0 ; j < 4 ; ++j )
+		{
+			const dvec4& col = m[i][j];
+			r[j] = SLMATH_CVTPD_PS( SLMATH_SUB_PD(col.m256d(), SLMATH_MUL_PD(c,SLMATH_LOAD_PD1(&col.w))) );
+		}
+	}
+}
+
+void camera_relative( const dvec3* points, size_t n, const dvec3& camera, vec3* out )
+{
+	// four points are 12 consecutive doubles, so camera is subtracted in three rotated patterns
+	const m256d_t c0 = SLMATH_SET_PD( camera.x, camera.y, camera.z, camera.x );
+	const m256d_t c1 = SLMATH_SET_PD( camera.y, camera.z, camera.x, camera.y );
+	const m256d_t c2 = SLMATH_SET_PD( camera.z, camera.x, camera.y, camera.z );
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+	{
+		const double* const p = &points[i].x;
+		float* const o = &out[i].x;
+		SLMATH_STOREU_PS( o+0, SLMATH_CVTPD_PS(SLMATH_SUB_PD(SLMATH_LOADU_PD(p+0),c0)) );
+		SLMATH_STOREU_PS( o+4, SLMATH_CVTPD_PS(SLMATH_SUB_PD(SLMATH_LOADU_PD(p+4),c1)) );
+		SLMATH_STOREU_PS( o+8, SLMATH_CVTPD_PS(SLMATH_SUB_PD(SLMATH_LOADU_PD(p+8),c2)) );
+	}
+	for ( ; i < n ; ++i )
+		out[i] = to_vec3( points[i] - camera );
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,106 @@
+#include <slm/dquat.h>
+
+#define ASSERT_IS_UNIT(Q) SLMATH_VEC_ASSERT( fabs(norm(Q)-1.0) < 1e-6 )
+
+SLMATH_BEGIN()
+
+dquat::dquat( double a, const dvec3& v )
+{
+	SLMATH_VEC_ASSERT( fabs(length(v)-1.0) < 1e-6 ); // axis must be normalized before calling this
+
+	const double s = sin( a*.5 );
+	x = v.x * s;
+	y = v.y * s;
+	z = v.z * s;
+	w = cos( a*.5 );
+}
+
+dquat::dquat( const dmat4& m )
+{
+	const double trace = m[0][0] + m[1][1] + m[2][2];
+
+	if ( trace > 0.0 )
+	{
+		double root = sqrt( trace + 1.0 );
+		w = root * .5;
+		root = .5 / root;
+		x = root * (m[1][2] - m[2][1]);
+		y = root * (m[2][0] - m[0][2]);
+		z = root * (m[0][1] - m[1][0]);
+	}
+	else
+	{
+		size_t i = 0;
+		if ( m[1][1] > m[0][0] )
+			i = 1;
+		if ( m[2][2] > m[i][i] )	
+			i = 2;
+		const size_t j = (i == 2 ? 0 : i+1);
+		const size_t k = (j == 2 ? 0 : j+1);
+
+		double root = sqrt( m[i][i] - m[j][j] - m[k][k] + 1.0 );
+		double* v = &x;
+		v[i] = root * .5;
+		SLMATH_VEC_ASSERT( fabs(root) >= DBL_MIN );
+		root = .5 / root;
+		v[j] = root * (m[i][j] + m[j][i]);
+		v[k] = root * (m[i][k] + m[k][i]);
+		w = root * (m[j][k] - m[k][j]);
+	}
+
+	SLMATH_VEC_ASSERT( check(*this) );
+}
+
+void dquat::normalize()
+{
+	const double n = norm(*this);
+	SLMATH_VEC_ASSERT( n > DBL_MIN );
+	*this *= 1.0/n;
+}
+
+dquat dquat::operator*( const dquat& o ) const
+{
+	dquat q;
+	q.w = (w*o.w - x*o.x - y*o.y - z*o.z);
+	q.x = (w*o.x + x*o.w + y*o.z - z*o.y);
+	q.y = (w*o.y - x*o.z + y*o.w + z*o.x);
+	q.z = (w*o.z + x*o.y - y*o.x + z*o.w);
+
+	SLMATH_VEC_ASSERT( check(q) );
+	return q;
+}
+
+dquat normalize( const dquat& q )
+{
+	const double n = norm(q);
+	SLMATH_VEC_ASSERT( n > DBL_MIN );
+	return q * (1.0/n);
+}
+
+dquat inverse( const dquat& q )
+{
+	const double n2 = norm_squared(q);
+	SLMATH_VEC_ASSERT( n2 > DBL_MIN );
+	return conjugate(q) * (1.0/n2);
+}
+
+dquat slerp( const dquat& a, const dquat& b, double u )
+{
+	ASSERT_IS_UNIT( a ); // normalize(q) before use this function
+	ASSERT_IS_UNIT( b ); // normalize(q) before use this function
+
+	double c = dot( a, b );
+	c = ( c > 1.0 ? 1.0 : (c < -1.0 ? -1.0 : c) );
+	const double angle = acos( c );
+	const double s = sin( angle );
+
+	if ( s < DBL_MIN )
+		return a;
+
+	const double invs = 1.0 / s;
+	return a * (invs * sin((1.0-u)*angle)) + b * (invs * sin(u*angle));
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
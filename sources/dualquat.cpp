@@ -0,0 +1,108 @@
+#include <slm/dualquat.h>
+
+SLMATH_BEGIN()
+
+dualquat::dualquat( const quat& q, const vec3& t ) :
+	real( q ),
+	dual( quat(t.x,t.y,t.z,0.f) * q * .5f )
+{
+	SLMATH_VEC_ASSERT( fabsf(norm(q)-1.f) < 1e-3f );
+}
+
+dualquat::dualquat( const mat4& m )
+{
+	SLMATH_VEC_ASSERT( fabsf(det(m)-1.f) < 1e-3f ); // rigid transform?
+
+	*this = dualquat( normalize(quat(m)), vec3(m[3].x,m[3].y,m[3].z) );
+}
+
+dualquat normalize( const dualquat& q )
+{
+	const float len = norm( q.real );
+	SLMATH_VEC_ASSERT( len > FLT_MIN );
+	return q * (1.f/len);
+}
+
+mat4 to_mat4( const dualquat& q )
+{
+	mat4 m( q.real );
+	m[3] = vec4( translation(q), 1.f );
+	return m;
+}
+
+/** Transforms point by unit real part r and dual part d of dual quaternion. */
+static inline vec3 transform_point( const vec3& rv, float rw, const vec3& dv, float dw, const vec3& p )
+{
+	return rotate( quat(rv.x,rv.y,rv.z,rw), p ) + (dv*rw - rv*dw + cross(rv,dv)) * 2.f;
+}
+
+vec3 transform_point( const dualquat& q, const vec3& p )
+{
+	SLMATH_VEC_ASSERT( check(q) );
+	return transform_point( vec3(q.real.x,q.real.y,q.real.z), q.real.w, vec3(q.dual.x,q.dual.y,q.dual.z), q.dual.w, p );
+}
+
+vec3 transform_direction( const dualquat& q, const vec3& v )
+{
+	SLMATH_VEC_ASSERT( check(q) );
+	return rotate( q.real, v );
+}
+
+dualquat blend( const dualquat* q, const float* weights, size_t n )
+{
+	SLMATH_VEC_ASSERT( n > 0 );
+
+	dualquat res = q[0] * weights[0];
+	for ( size_t i = 1 ; i < n ; ++i )
+	{
+		const float w = ( dot(q[i].real,q[0].real) < 0.f ? -weights[i] : weights[i] );
+		res += q[i] * w;
+	}
+	return normalize( res );
+}
+
+void skin_vertices( const dualquat* bones, const vec3* positions, const vec3* normals, const unsigned int* boneindices, const float* weights, size_t n, vec3* outpositions, vec3* outnormals )
+{
+	SLMATH_VEC_ASSERT( !normals || outnormals );
+
+	SLMATH_ALIGN16 float r[4];
+	SLMATH_ALIGN16 float d[4];
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		// blend real and dual parts as 4-vectors, flipping influences in opposite hemisphere from the first
+		const unsigned int* const bi = boneindices + i*4;
+		const float* const wi = weights + i*4;
+		const dualquat& b0 = bones[bi[0]];
+		m128_t real = SLMATH_MUL_PS( SLMATH_LOADU_PS(&b0.real.x), SLMATH_LOAD_PS1(wi) );
+		m128_t dual = SLMATH_MUL_PS( SLMATH_LOADU_PS(&b0.dual.x), SLMATH_LOAD_PS1(wi) );
+		for ( size_t k = 1 ; k < 4 ; ++k )
+		{
+			if ( 0.f == wi[k] )
+				continue;
+			const dualquat& b = bones[bi[k]];
+			const float w = ( dot(b.real,b0.real) < 0.f ? -wi[k] : wi[k] );
+			const m128_t w128 = SLMATH_LOAD_PS1( &w );
+			real = SLMATH_ADD_PS( real, SLMATH_MUL_PS(SLMATH_LOADU_PS(&b.real.x), w128) );
+			dual = SLMATH_ADD_PS( dual, SLMATH_MUL_PS(SLMATH_LOADU_PS(&b.dual.x), w128) );
+		}
+		SLMATH_STORE_PS( r, real );
+		SLMATH_STORE_PS( d, dual );
+
+		// normalize both parts by length of the real part
+		const float len2 = r[0]*r[0] + r[1]*r[1] + r[2]*r[2] + r[3]*r[3];
+		SLMATH_VEC_ASSERT( len2 > FLT_MIN );
+		const float invlen = 1.f / sqrtf( len2 );
+		const vec3 rv = vec3( r[0], r[1], r[2] ) * invlen;
+		const float rw = r[3] * invlen;
+		const vec3 dv = vec3( d[0], d[1], d[2] ) * invlen;
+		const float dw = d[3] * invlen;
+
+		outpositions[i] = transform_point( rv, rw, dv, dw, positions[i] );
+		if ( normals )
+			outnormals[i] = rotate( quat(rv.x,rv.y,rv.z,rw), normals[i] );
+	}
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
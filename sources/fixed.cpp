@@ -0,0 +1,94 @@
+#include <slm/fixed.h>
+#include <slm/fixed_vec3.h>
+
+SLMATH_BEGIN()
+
+fixed fixed::sqrt_wide( unsigned long long v )
+{
+	// bit by bit integer square root, result has half the fraction bits of the input
+	unsigned long long r = 0;
+	unsigned long long bit = 1ULL << 62;
+	while ( bit > v )
+		bit >>= 2;
+	while ( bit != 0 )
+	{
+		if ( v >= r+bit )
+		{
+			v -= r+bit;
+			r = (r >> 1) + bit;
+		}
+		else
+		{
+			r >>= 1;
+		}
+		bit >>= 2;
+	}
+	return fixed::from_raw( int(r) );
+}
+
+fixed sqrt( fixed a )
+{
+	SLMATH_VEC_ASSERT( a.raw >= 0 );
+	return fixed::sqrt_wide( (unsigned long long)(a.raw < 0 ? 0 : a.raw) << fixed::FRACTION_BITS );
+}
+
+// pi multiples with 48 fraction bits, so range reduction doesn't accumulate error with large angles
+static const long long PI48 = 884279719003555LL;
+static const long long HALF_PI48 = 442139859501778LL;
+static const long long TWO_PI48 = 1768559438007110LL;
+
+static long long to_wide_angle( fixed a )
+{
+	// 16.16 to 16.48, fits 64 bits for any raw value
+	return ((long long)a.raw * (1LL << 32)) % TWO_PI48;
+}
+
+static fixed sin_wide( long long x )
+{
+	// reduce to [-pi,pi] and then to [-pi/2,pi/2] with sin(x) = sin(pi-x), x is in (-3pi,3pi) here
+	if ( x > PI48 )
+		x -= TWO_PI48;
+	else if ( x < -PI48 )
+		x += TWO_PI48;
+	if ( x > HALF_PI48 )
+		x = PI48 - x;
+	else if ( x < -HALF_PI48 )
+		x = -PI48 - x;
+
+	// Taylor series up to x^9 with Horner's rule, 28 fraction bits
+	const int FRAC = 28;
+	const long long C3 = 44739243;	// 2^28/3!
+	const long long C5 = 2236962;	// 2^28/5!
+	const long long C7 = 53261;		// 2^28/7!
+	const long long C9 = 740;		// 2^28/9!
+	const long long one = 1LL << FRAC;
+	const long long x28 = x / (1LL << (48-FRAC));
+	const long long x2 = (x28 * x28) >> FRAC;
+	long long r = C7 - ((x2 * C9) >> FRAC);
+	r = C5 - ((x2 * r) >> FRAC);
+	r = C3 - ((x2 * r) >> FRAC);
+	r = one - ((x2 * r) >> FRAC);
+	r = (x28 * r) >> FRAC;
+	return fixed::from_raw( int( (r + (1 << (FRAC-fixed::FRACTION_BITS-1))) >> (FRAC-fixed::FRACTION_BITS) ) );
+}
+
+fixed sin( fixed a )
+{
+	return sin_wide( to_wide_angle(a) );
+}
+
+fixed cos( fixed a )
+{
+	// offset after reduction so large angles don't overflow
+	return sin_wide( to_wide_angle(a) + HALF_PI48 );
+}
+
+void to_vec3( const fixed_vec3* v, size_t n, vec3* out )
+{
+	for ( size_t i = 0 ; i < n ; ++i )
+		out[i] = to_vec3( v[i] );
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
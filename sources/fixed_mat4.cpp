@@ -0,0 +1,138 @@
+#include <slm/fixed_mat4.h>
+
+SLMATH_BEGIN()
+
+typedef long long fixed_wide;
+
+fixed_mat4::fixed_mat4( fixed d )
+{
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		for ( size_t j = 0 ; j < 4 ; ++j )
+			m[i][j] = ( i == j ? d : fixed::from_raw(0) );
+}
+
+fixed_mat4::fixed_mat4( const fixed_quat& q, const fixed_vec3& t )
+{
+	const fixed one( 1 );
+	const fixed zero = fixed::from_raw( 0 );
+	const fixed x2 = q.x + q.x;
+	const fixed y2 = q.y + q.y;
+	const fixed z2 = q.z + q.z;
+	const fixed xx = q.x * x2;
+	const fixed yy = q.y * y2;
+	const fixed zz = q.z * z2;
+	const fixed xy = q.x * y2;
+	const fixed xz = q.x * z2;
+	const fixed yz = q.y * z2;
+	const fixed wx = q.w * x2;
+	const fixed wy = q.w * y2;
+	const fixed wz = q.w * z2;
+
+	m[0][0] = one - (yy + zz);
+	m[0][1] = xy + wz;
+	m[0][2] = xz - wy;
+	m[0][3] = zero;
+	m[1][0] = xy - wz;
+	m[1][1] = one - (xx + zz);
+	m[1][2] = yz + wx;
+	m[1][3] = zero;
+	m[2][0] = xz + wy;
+	m[2][1] = yz - wx;
+	m[2][2] = one - (xx + yy);
+	m[2][3] = zero;
+	m[3][0] = t.x;
+	m[3][1] = t.y;
+	m[3][2] = t.z;
+	m[3][3] = one;
+}
+
+fixed_mat4::fixed_mat4( const mat4& a )
+{
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		for ( size_t j = 0 ; j < 4 ; ++j )
+			m[i][j] = fixed( a[i][j] );
+}
+
+fixed_mat4 fixed_mat4::operator*( const fixed_mat4& o ) const
+{
+	fixed_mat4 r;
+	for ( size_t i = 0 ; i < 4 ; ++i )
+	{
+		for ( size_t j = 0 ; j < 4 ; ++j )
+		{
+			fixed_wide s = 0;
+			for ( size_t k = 0 ; k < 4 ; ++k )
+				s += (fixed_wide)m[k][j].raw * o.m[i][k].raw;
+			r.m[i][j] = fixed::from_wide( s );
+		}
+	}
+	return r;
+}
+
+bool fixed_mat4::operator==( const fixed_mat4& o ) const
+{
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		for ( size_t j = 0 ; j < 4 ; ++j )
+			if ( m[i][j] != o.m[i][j] )
+				return false;
+	return true;
+}
+
+bool fixed_mat4::operator!=( const fixed_mat4& o ) const
+{
+	return !(*this == o);
+}
+
+fixed_vec3 transform_point( const fixed_mat4& m, const fixed_vec3& p )
+{
+	const fixed_wide one = fixed::ONE;
+	fixed_vec3 r;
+	for ( size_t j = 0 ; j < 3 ; ++j )
+		r[j] = fixed::from_wide( (fixed_wide)m.m[0][j].raw*p.x.raw + (fixed_wide)m.m[1][j].raw*p.y.raw + (fixed_wide)m.m[2][j].raw*p.z.raw + m.m[3][j].raw*one );
+	return r;
+}
+
+fixed_vec3 transform_direction( const fixed_mat4& m, const fixed_vec3& d )
+{
+	fixed_vec3 r;
+	for ( size_t j = 0 ; j < 3 ; ++j )
+		r[j] = fixed::from_wide( (fixed_wide)m.m[0][j].raw*d.x.raw + (fixed_wide)m.m[1][j].raw*d.y.raw + (fixed_wide)m.m[2][j].raw*d.z.raw );
+	return r;
+}
+
+void transform_points( const fixed_mat4& m, const fixed_vec3* p, size_t n, fixed_vec3* out )
+{
+	for ( size_t i = 0 ; i < n ; ++i )
+		out[i] = transform_point( m, p[i] );
+}
+
+fixed_mat4 transpose( const fixed_mat4& m )
+{
+	fixed_mat4 r;
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		for ( size_t j = 0 ; j < 4 ; ++j )
+			r.m[i][j] = m.m[j][i];
+	return r;
+}
+
+fixed_mat4 translation( const fixed_vec3& t )
+{
+	fixed_mat4 r( fixed(1) );
+	r.m[3][0] = t.x;
+	r.m[3][1] = t.y;
+	r.m[3][2] = t.z;
+	return r;
+}
+
+mat4 to_mat4( const fixed_mat4& m )
+{
+	mat4 r;
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		for ( size_t j = 0 ; j < 4 ; ++j )
+			r[i][j] = to_float( m.m[i][j] );
+	return r;
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,44 @@
+#include <slm/fixed_quat.h>
+
+SLMATH_BEGIN()
+
+fixed_quat::fixed_quat( fixed a, const fixed_vec3& v )
+{
+	const fixed half = fixed::from_raw( a.raw / 2 );
+	const fixed s = sin( half );
+	x = v.x * s;
+	y = v.y * s;
+	z = v.z * s;
+	w = cos( half );
+}
+
+fixed_quat fixed_quat::operator*( const fixed_quat& o ) const
+{
+	typedef long long wide;
+	return fixed_quat(
+		fixed::from_wide( (wide)w.raw*o.x.raw + (wide)x.raw*o.w.raw + (wide)y.raw*o.z.raw - (wide)z.raw*o.y.raw ),
+		fixed::from_wide( (wide)w.raw*o.y.raw + (wide)y.raw*o.w.raw + (wide)z.raw*o.x.raw - (wide)x.raw*o.z.raw ),
+		fixed::from_wide( (wide)w.raw*o.z.raw + (wide)z.raw*o.w.raw + (wide)x.raw*o.y.raw - (wide)y.raw*o.x.raw ),
+		fixed::from_wide( (wide)w.raw*o.w.raw - (wide)x.raw*o.x.raw - (wide)y.raw*o.y.raw - (wide)z.raw*o.z.raw ) );
+}
+
+fixed_quat normalize( const fixed_quat& q )
+{
+	typedef long long wide;
+	const fixed len = fixed::sqrt_wide( (unsigned long long)( (wide)q.x.raw*q.x.raw + (wide)q.y.raw*q.y.raw + (wide)q.z.raw*q.z.raw + (wide)q.w.raw*q.w.raw ) );
+	SLMATH_VEC_ASSERT( len.raw > 0 );
+	return fixed_quat( q.x/len, q.y/len, q.z/len, q.w/len );
+}
+
+fixed_vec3 rotate( const fixed_quat& q, const fixed_vec3& v )
+{
+	// v + 2w(u x v) + 2u x (u x v), where u is the vector part of q
+	const fixed_vec3 u( q.x, q.y, q.z );
+	const fixed_vec3 t = cross( u, v );
+	const fixed_vec3 t2( t.x+t.x, t.y+t.y, t.z+t.z );
+	return v + t2*q.w + cross( u, t2 );
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,149 @@
+#include <slm/frustum.h>
+
+SLMATH_BEGIN()
+
+frustum::frustum( const mat4& m )
+{
+	// rows of the matrix
+	const vec4 r0( m[0][0], m[1][0], m[2][0], m[3][0] );
+	const vec4 r1( m[0][1], m[1][1], m[2][1], m[3][1] );
+	const vec4 r2( m[0][2], m[1][2], m[2][2], m[3][2] );
+	const vec4 r3( m[0][3], m[1][3], m[2][3], m[3][3] );
+
+	planes[PLANE_LEFT] = r3 + r0;
+	planes[PLANE_RIGHT] = r3 - r0;
+	planes[PLANE_BOTTOM] = r3 + r1;
+	planes[PLANE_TOP] = r3 - r1;
+	planes[PLANE_NEAR] = r2;
+	planes[PLANE_FAR] = r3 - r2;
+
+	for ( size_t i = 0 ; i < PLANE_COUNT ; ++i )
+	{
+		const float len = length( planes[i].xyz() );
+		SLMATH_VEC_ASSERT( len > FLT_MIN );
+		planes[i] *= 1.f / len;
+	}
+}
+
+/** Plane coefficients broadcast to all SIMD lanes. */
+class frustum_planes4
+{
+public:
+	m128_t	nx[frustum::PLANE_COUNT];
+	m128_t	ny[frustum::PLANE_COUNT];
+	m128_t	nz[frustum::PLANE_COUNT];
+	m128_t	d[frustum::PLANE_COUNT];
+
+	explicit frustum_planes4( const frustum& f )
+	{
+		for ( size_t i = 0 ; i < frustum::PLANE_COUNT ; ++i )
+		{
+			nx[i] = SLMATH_LOAD_PS1( &f.planes[i].x );
+			ny[i] = SLMATH_LOAD_PS1( &f.planes[i].y );
+			nz[i] = SLMATH_LOAD_PS1( &f.planes[i].z );
+			d[i] = SLMATH_LOAD_PS1( &f.planes[i].w );
+		}
+	}
+};
+
+/** Returns visibility bits of the four spheres starting at index i. */
+static inline int cull_spheres4( const frustum_planes4& p, const float* x, const float* y, const float* z, const float* r, size_t i )
+{
+	const m128_t cx = SLMATH_LOADU_PS( x+i );
+	const m128_t cy = SLMATH_LOADU_PS( y+i );
+	const m128_t cz = SLMATH_LOADU_PS( z+i );
+	const m128_t nr = SLMATH_SUB_PS( SLMATH_SETZERO_PS(), SLMATH_LOADU_PS(r+i) );
+
+	m128_t outside = SLMATH_SETZERO_PS();
+	for ( size_t k = 0 ; k < frustum::PLANE_COUNT ; ++k )
+	{
+		const m128_t dist = SLMATH_ADD_PS( SLMATH_ADD_PS(SLMATH_MUL_PS(p.nx[k],cx), SLMATH_MUL_PS(p.ny[k],cy)), SLMATH_ADD_PS(SLMATH_MUL_PS(p.nz[k],cz), p.d[k]) );
+		outside = SLMATH_OR_PS( outside, SLMATH_CMPLT_PS(dist,nr) );
+	}
+	return ~SLMATH_MOVEMASK_PS(outside) & 0xF;
+}
+
+/** Returns visibility bits of the four boxes starting at index i. */
+static inline int cull_boxes4( const frustum& f, const frustum_planes4& p, const float* const* boxminmax, size_t i )
+{
+	const m128_t zero = SLMATH_SETZERO_PS();
+	m128_t outside = zero;
+	for ( size_t k = 0 ; k < frustum::PLANE_COUNT ; ++k )
+	{
+		// test the box corners furthest along plane normal
+		const vec4& pl = f.planes[k];
+		const m128_t cx = SLMATH_LOADU_PS( boxminmax[pl.x < 0.f ? 0 : 3] + i );
+		const m128_t cy = SLMATH_LOADU_PS( boxminmax[pl.y < 0.f ? 1 : 4] + i );
+		const m128_t cz = SLMATH_LOADU_PS( boxminmax[pl.z < 0.f ? 2 : 5] + i );
+		const m128_t dist = SLMATH_ADD_PS( SLMATH_ADD_PS(SLMATH_MUL_PS(p.nx[k],cx), SLMATH_MUL_PS(p.ny[k],cy)), SLMATH_ADD_PS(SLMATH_MUL_PS(p.nz[k],cz), p.d[k]) );
+		outside = SLMATH_OR_PS( outside, SLMATH_CMPLT_PS(dist,zero) );
+	}
+	return ~SLMATH_MOVEMASK_PS(outside) & 0xF;
+}
+
+/** Appends indices of set bits to the visible list. */
+static inline size_t append_visible( int bits, size_t i, size_t* visible, size_t count )
+{
+	for ( size_t k = 0 ; bits ; ++k, bits >>= 1 )
+		if ( bits & 1 )
+			visible[count++] = i+k;
+	return count;
+}
+
+size_t cull_spheres( const frustum& f, const float* x, const float* y, const float* z, const float* r, size_t n, size_t* visible )
+{
+	const frustum_planes4 p( f );
+	size_t count = 0;
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+		count = append_visible( cull_spheres4(p,x,y,z,r,i), i, visible, count );
+	for ( ; i < n ; ++i )
+		if ( intersect_frustum_sphere(f, vec3(x[i],y[i],z[i]), r[i]) )
+			visible[count++] = i;
+	return count;
+}
+
+void cull_spheres_mask( const frustum& f, const float* x, const float* y, const float* z, const float* r, size_t n, unsigned int* mask )
+{
+	const frustum_planes4 p( f );
+	for ( size_t w = 0 ; w < (n+31)/32 ; ++w )
+		mask[w] = 0;
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+		mask[i>>5] |= unsigned(cull_spheres4(p,x,y,z,r,i)) << (i&31);
+	for ( ; i < n ; ++i )
+		if ( intersect_frustum_sphere(f, vec3(x[i],y[i],z[i]), r[i]) )
+			mask[i>>5] |= 1u << (i&31);
+}
+
+size_t cull_boxes( const frustum& f, const float* minx, const float* miny, const float* minz, const float* maxx, const float* maxy, const float* maxz, size_t n, size_t* visible )
+{
+	const frustum_planes4 p( f );
+	const float* const boxminmax[6] = {minx, miny, minz, maxx, maxy, maxz};
+	size_t count = 0;
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+		count = append_visible( cull_boxes4(f,p,boxminmax,i), i, visible, count );
+	for ( ; i < n ; ++i )
+		if ( intersect_frustum_box(f, vec3(minx[i],miny[i],minz[i]), vec3(maxx[i],maxy[i],maxz[i])) )
+			visible[count++] = i;
+	return count;
+}
+
+void cull_boxes_mask( const frustum& f, const float* minx, const float* miny, const float* minz, const float* maxx, const float* maxy, const float* maxz, size_t n, unsigned int* mask )
+{
+	const frustum_planes4 p( f );
+	const float* const boxminmax[6] = {minx, miny, minz, maxx, maxy, maxz};
+	for ( size_t w = 0 ; w < (n+31)/32 ; ++w )
+		mask[w] = 0;
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+		mask[i>>5] |= unsigned(cull_boxes4(f,p,boxminmax,i)) << (i&31);
+	for ( ; i < n ; ++i )
+		if ( intersect_frustum_box(f, vec3(minx[i],miny[i],minz[i]), vec3(maxx[i],maxy[i],maxz[i])) )
+			mask[i>>5] |= 1u << (i&31);
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
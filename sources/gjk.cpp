@@ -0,0 +1,599 @@
+#include <slm/gjk.h>
+#include <slm/intersect_util.h>
+
+SLMATH_BEGIN()
+
+/** Maximum number of GJK iterations, convergence is usually reached in less than 10. */
+static const size_t GJK_MAX_ITERATIONS = 64;
+
+/** GJK terminates when a new support point improves squared distance less than this relative amount. */
+static const float GJK_REL_EPSILON = 1e-6f;
+
+/** Maximum number of EPA iterations. */
+static const size_t EPA_MAX_ITERATIONS = 64;
+
+/** Maximum number of EPA polytope vertices. */
+static const size_t EPA_MAX_VERTICES = EPA_MAX_ITERATIONS + 4;
+
+/** Maximum number of EPA polytope faces. */
+static const size_t EPA_MAX_FACES = 2*EPA_MAX_VERTICES;
+
+/** EPA terminates when a new support point moves the closest face less than this relative amount. */
+static const float EPA_REL_EPSILON = 1e-4f;
+
+gjk_shape::gjk_shape( gjk_support_function support_, const void* data_, float radius_ ) :
+	support( support_ ),
+	data( data_ ),
+	radius( radius_ )
+{
+	SLMATH_VEC_ASSERT( radius >= 0.f );
+}
+
+vec3 gjk_support_point( const void* data, const vec3& )
+{
+	return *reinterpret_cast<const vec3*>( data );
+}
+
+vec3 gjk_support_segment( const void* data, const vec3& dir )
+{
+	const vec3* const p = reinterpret_cast<const vec3*>( data );
+	return ( dot(p[1]-p[0],dir) > 0.f ? p[1] : p[0] );
+}
+
+vec3 gjk_support_box( const void* data, const vec3& dir )
+{
+	const gjk_box& box = *reinterpret_cast<const gjk_box*>( data );
+	vec3 p = box.center;
+	for ( size_t i = 0 ; i < 3 ; ++i )
+		p += ( dot(box.axis[i],dir) >= 0.f ? box.axis[i] : -box.axis[i] );
+	return p;
+}
+
+vec3 gjk_support_point_hull( const void* data, const vec3& dir )
+{
+	const gjk_point_hull& hull = *reinterpret_cast<const gjk_point_hull*>( data );
+	SLMATH_VEC_ASSERT( hull.n > 0 && hull.n < (1<<24) );
+
+	// best dot product and index per lane, indices as floats so they can be selected with float masks
+	const float minf = -FLT_MAX;
+	const float fourf = 4.f;
+	const float lanef[4] = {0.f, 1.f, 2.f, 3.f};
+	const m128_t dx = SLMATH_LOAD_PS1( &dir.x );
+	const m128_t dy = SLMATH_LOAD_PS1( &dir.y );
+	const m128_t dz = SLMATH_LOAD_PS1( &dir.z );
+	const m128_t four = SLMATH_LOAD_PS1( &fourf );
+	m128_t best = SLMATH_LOAD_PS1( &minf );
+	m128_t bestindex = SLMATH_SETZERO_PS();
+	m128_t index = SLMATH_LOADU_PS( lanef );
+	const size_t n4 = hull.n & ~size_t(3);
+	for ( size_t i = 0 ; i < n4 ; i += 4 )
+	{
+		const m128_t d = SLMATH_ADD_PS( SLMATH_ADD_PS( SLMATH_MUL_PS(SLMATH_LOADU_PS(hull.x+i),dx), SLMATH_MUL_PS(SLMATH_LOADU_PS(hull.y+i),dy) ), SLMATH_MUL_PS(SLMATH_LOADU_PS(hull.z+i),dz) );
+		const m128_t gt = SLMATH_CMPGT_PS( d, best );
+		best = SLMATH_SELECT_PS( gt, d, best );
+		bestindex = SLMATH_SELECT_PS( gt, index, bestindex );
+		index = SLMATH_ADD_PS( index, four );
+	}
+
+	float bestd[4];
+	float besti[4];
+	SLMATH_STOREU_PS( bestd, best );
+	SLMATH_STOREU_PS( besti, bestindex );
+	size_t k = size_t( besti[0] );
+	float kd = bestd[0];
+	for ( size_t i = 1 ; i < 4 ; ++i )
+	{
+		if ( bestd[i] > kd )
+		{
+			kd = bestd[i];
+			k = size_t( besti[i] );
+		}
+	}
+	for ( size_t i = n4 ; i < hull.n ; ++i )
+	{
+		const float d = hull.x[i]*dir.x + hull.y[i]*dir.y + hull.z[i]*dir.z;
+		if ( d > kd )
+		{
+			kd = d;
+			k = i;
+		}
+	}
+	return vec3( hull.x[k], hull.y[k], hull.z[k] );
+}
+
+/** Vertex of Minkowski difference A-B with the support points and search direction producing it. */
+class gjk_vertex
+{
+public:
+	vec3	w;
+	vec3	a;
+	vec3	b;
+	vec3	dir;
+};
+
+/** Returns vertex of Minkowski difference of core shapes furthest in direction. */
+static inline gjk_vertex gjk_support( const gjk_shape& a, const gjk_shape& b, const vec3& dir )
+{
+	gjk_vertex v;
+	v.dir = dir;
+	v.a = a.support( a.data, dir );
+	v.b = b.support( b.data, -dir );
+	v.w = v.a - v.b;
+	return v;
+}
+
+/** Keeps simplex vertices with bits set in mask, and their weights. */
+static void reduce_simplex( gjk_vertex* v, size_t* count, float* weight, const float* w, int mask )
+{
+	size_t n = 0;
+	for ( size_t i = 0 ; i < *count ; ++i )
+	{
+		if ( mask & (1<<i) )
+		{
+			v[n] = v[i];
+			weight[n++] = w[i];
+		}
+	}
+	*count = n;
+}
+
+/**
+ * Finds point of triangle closest to origin, as Voronoi region mask of the vertices and their barycentric weights.
+ * @return Region mask, bit i set if vertex i has non-zero weight.
+ */
+static int closest_triangle_region( const vec3& a, const vec3& b, const vec3& c, float* w )
+{
+	const vec3 ab = b - a;
+	const vec3 ac = c - a;
+	const float d1 = -dot( ab, a );
+	const float d2 = -dot( ac, a );
+	w[0] = 1.f; w[1] = w[2] = 0.f;
+	if ( d1 <= 0.f && d2 <= 0.f )
+		return 1;
+
+	const float d3 = -dot( ab, b );
+	const float d4 = -dot( ac, b );
+	if ( d3 >= 0.f && d4 <= d3 )
+	{
+		w[0] = 0.f; w[1] = 1.f;
+		return 2;
+	}
+
+	const float vc = d1*d4 - d3*d2;
+	if ( vc <= 0.f && d1 >= 0.f && d3 <= 0.f )
+	{
+		const float s = d1 / (d1-d3);
+		w[0] = 1.f-s; w[1] = s;
+		return 3;
+	}
+
+	const float d5 = -dot( ab, c );
+	const float d6 = -dot( ac, c );
+	if ( d6 >= 0.f && d5 <= d6 )
+	{
+		w[0] = 0.f; w[2] = 1.f;
+		return 4;
+	}
+
+	const float vb = d5*d2 - d1*d6;
+	if ( vb <= 0.f && d2 >= 0.f && d6 <= 0.f )
+	{
+		const float t = d2 / (d2-d6);
+		w[0] = 1.f-t; w[2] = t;
+		return 5;
+	}
+
+	const float va = d3*d6 - d5*d4;
+	if ( va <= 0.f && d4-d3 >= 0.f && d5-d6 >= 0.f )
+	{
+		const float t = (d4-d3) / ((d4-d3) + (d5-d6));
+		w[0] = 0.f; w[1] = 1.f-t; w[2] = t;
+		return 6;
+	}
+
+	const float denom = va + vb + vc;
+	if ( !(denom > 0.f) )
+		return 1;
+	w[1] = vb/denom;
+	w[2] = vc/denom;
+	w[0] = 1.f - w[1] - w[2];
+	return 7;
+}
+
+/**
+ * Reduces simplex to the smallest subset whose convex hull contains the point closest to origin.
+ * @param weight [out] Receives barycentric weights of the remaining vertices.
+ * @return The closest point. If count is 4 after the call, origin is inside the tetrahedron.
+ */
+static vec3 solve_simplex( gjk_vertex* v, size_t* count, float* weight )
+{
+	float w[4] = {1.f, 0.f, 0.f, 0.f};
+	int mask = 1;
+	switch ( *count )
+	{
+	case 2:
+		{
+			const vec3 ab = v[1].w - v[0].w;
+			const float len2 = dot( ab, ab );
+			const float t = ( len2 > 0.f ? -dot(v[0].w,ab) / len2 : 0.f );
+			if ( t <= 0.f )
+				mask = 1;
+			else if ( t >= 1.f )
+				mask = 2, w[1] = 1.f;
+			else
+				mask = 3, w[0] = 1.f-t, w[1] = t;
+		}
+		break;
+
+	case 3:
+		mask = closest_triangle_region( v[0].w, v[1].w, v[2].w, w );
+		break;
+
+	case 4:
+		{
+			// flat tetrahedron doesn't add a dimension, so the last vertex is dropped
+			const vec3 e1 = v[1].w - v[0].w;
+			const vec3 e2 = v[2].w - v[0].w;
+			const vec3 e3 = v[3].w - v[0].w;
+			const float len = max( length(e1), max(length(e2),length(e3)) );
+			if ( fabsf(dot(cross(e1,e2),e3)) <= len*len*len*1e-6f )
+			{
+				*count = 3;
+				return solve_simplex( v, count, weight );
+			}
+
+			// closest point is on a face which has origin on its outer side, or origin is inside
+			static const int faces[4][4] = { {0,1,2,3}, {0,3,1,2}, {0,2,3,1}, {1,3,2,0} };
+			float best = FLT_MAX;
+			mask = 15;
+			for ( size_t f = 0 ; f < 4 ; ++f )
+			{
+				const vec3& a = v[faces[f][0]].w;
+				const vec3& b = v[faces[f][1]].w;
+				const vec3& c = v[faces[f][2]].w;
+				const vec3 n = cross( b-a, c-a );
+				const float so = -dot( n, a );
+				const float sd = dot( n, v[faces[f][3]].w - a );
+				if ( so*sd >= 0.f )
+					continue;
+
+				float fw[3];
+				const int fmask = closest_triangle_region( a, b, c, fw );
+				const vec3 p = a*fw[0] + b*fw[1] + c*fw[2];
+				const float d2 = dot( p, p );
+				if ( d2 < best )
+				{
+					best = d2;
+					mask = 0;
+					w[0] = w[1] = w[2] = w[3] = 0.f;
+					for ( size_t i = 0 ; i < 3 ; ++i )
+					{
+						if ( fmask & (1<<i) )
+						{
+							mask |= 1 << faces[f][i];
+							w[faces[f][i]] = fw[i];
+						}
+					}
+				}
+			}
+			if ( 15 == mask )
+			{
+				// inside, weights are not needed
+				for ( size_t i = 0 ; i < 4 ; ++i )
+					weight[i] = .25f;
+				return vec3( 0.f );
+			}
+		}
+		break;
+	}
+
+	reduce_simplex( v, count, weight, w, mask );
+	vec3 p( 0.f );
+	for ( size_t i = 0 ; i < *count ; ++i )
+		p += v[i].w * weight[i];
+	return p;
+}
+
+/**
+ * Runs GJK on core shapes.
+ * @return true if the core shapes overlap, in which case the simplex contains or touches origin.
+ */
+static bool gjk_core( const gjk_shape& a, const gjk_shape& b, gjk_simplex* simplex, gjk_vertex* v, size_t* count, float* weight, size_t* iterations )
+{
+	// warm start from cached directions, otherwise from an arbitrary direction
+	*count = 0;
+	if ( simplex )
+	{
+		for ( size_t i = 0 ; i < simplex->count ; ++i )
+			v[(*count)++] = gjk_support( a, b, simplex->dir[i] );
+	}
+	if ( 0 == *count )
+		v[(*count)++] = gjk_support( a, b, vec3(1.f,0.f,0.f) );
+	vec3 p = solve_simplex( v, count, weight );
+
+	float scale2 = 0.f;
+	bool overlap = false;
+	size_t iter = 0;
+	for ( ; iter < GJK_MAX_ITERATIONS ; ++iter )
+	{
+		const float p2 = dot( p, p );
+		for ( size_t i = 0 ; i < *count ; ++i )
+			scale2 = max( scale2, dot(v[i].w,v[i].w) );
+		if ( 4 == *count || p2 <= scale2*1e-12f )
+		{
+			overlap = true;
+			break;
+		}
+
+		// stop when the support point doesn't get closer to origin than the current point
+		const gjk_vertex w = gjk_support( a, b, -p );
+		if ( p2 - dot(p,w.w) <= p2*GJK_REL_EPSILON )
+			break;
+
+		v[(*count)++] = w;
+		const vec3 q = solve_simplex( v, count, weight );
+		if ( dot(q,q) >= p2 )
+			break;
+		p = q;
+	}
+
+	*iterations = iter+1;
+	if ( simplex )
+	{
+		simplex->count = *count;
+		for ( size_t i = 0 ; i < *count ; ++i )
+			simplex->dir[i] = v[i].dir;
+	}
+	return overlap;
+}
+
+/** Fills in result from closest points of the core shapes, which are at distance d, adding radii of the shapes. */
+static void core_result( const gjk_shape& a, const gjk_shape& b, const vec3& pa, const vec3& pb, gjk_result* result )
+{
+	const vec3 ab = pb - pa;
+	const float d = length( ab );
+	result->normal = ( d > 0.f ? ab/d : vec3(1.f,0.f,0.f) );
+	result->pointa = pa + result->normal*a.radius;
+	result->pointb = pb - result->normal*b.radius;
+	result->distance = d - a.radius - b.radius;
+}
+
+bool gjk_distance( const gjk_shape& a, const gjk_shape& b, gjk_simplex* simplex, gjk_result* result )
+{
+	gjk_vertex v[4];
+	float weight[4];
+	size_t count;
+	if ( gjk_core(a, b, simplex, v, &count, weight, &result->iterations) )
+	{
+		result->distance = 0.f;
+		return false;
+	}
+
+	vec3 pa( 0.f );
+	vec3 pb( 0.f );
+	for ( size_t i = 0 ; i < count ; ++i )
+	{
+		pa += v[i].a * weight[i];
+		pb += v[i].b * weight[i];
+	}
+	core_result( a, b, pa, pb, result );
+	return result->distance > 0.f;
+}
+
+/** Triangle of EPA polytope, vertices in counterclockwise order seen from outside. */
+class epa_face
+{
+public:
+	size_t	v[3];
+	vec3	n;
+	float	d;
+};
+
+/** Computes outward normal and distance from origin of a face, flipping the face if it faces the interior point. */
+static bool make_epa_face( const gjk_vertex* verts, size_t i0, size_t i1, size_t i2, const vec3& interior, epa_face* f )
+{
+	f->v[0] = i0;
+	f->v[1] = i1;
+	f->v[2] = i2;
+	const vec3& a = verts[i0].w;
+	vec3 n = cross( verts[i1].w - a, verts[i2].w - a );
+	const float len = length( n );
+	if ( !(len > 0.f) )
+		return false;
+	n /= len;
+	if ( dot(n, interior - a) > 0.f )
+	{
+		n = -n;
+		f->v[1] = i2;
+		f->v[2] = i1;
+	}
+	f->n = n;
+	f->d = dot( n, a );
+	return true;
+}
+
+/** Adds edge to horizon, or removes it if the opposite edge is already there, since then both of its faces were removed. */
+static void add_horizon_edge( size_t (*edges)[2], size_t* count, size_t e0, size_t e1 )
+{
+	for ( size_t i = 0 ; i < *count ; ++i )
+	{
+		if ( edges[i][0] == e1 && edges[i][1] == e0 )
+		{
+			--*count;
+			edges[i][0] = edges[*count][0];
+			edges[i][1] = edges[*count][1];
+			return;
+		}
+	}
+	edges[*count][0] = e0;
+	edges[*count][1] = e1;
+	++*count;
+}
+
+/**
+ * Expands simplex containing origin to a tetrahedron.
+ * @param flatnormal [out] Receives unit normal of the flat Minkowski difference if false is returned.
+ * @return false if the Minkowski difference is flat around origin, i.e. only the radii overlap.
+ */
+static bool epa_tetrahedron( const gjk_shape& a, const gjk_shape& b, gjk_vertex* v, size_t* count, float eps, vec3* flatnormal )
+{
+	*flatnormal = vec3( 1.f, 0.f, 0.f );
+	if ( 1 == *count )
+	{
+		static const float dirs[6][3] = { {1,0,0}, {-1,0,0}, {0,1,0}, {0,-1,0}, {0,0,1}, {0,0,-1} };
+		for ( size_t i = 0 ; i < 6 && 1 == *count ; ++i )
+		{
+			const gjk_vertex w = gjk_support( a, b, vec3(dirs[i][0],dirs[i][1],dirs[i][2]) );
+			if ( length(w.w - v[0].w) > eps )
+				v[(*count)++] = w;
+		}
+	}
+	if ( 2 == *count )
+	{
+		const vec3 ab = v[1].w - v[0].w;
+		const vec3 aabs = abs( ab );
+		const vec3 axis = ( aabs.x <= aabs.y && aabs.x <= aabs.z ? vec3(1,0,0) : aabs.y <= aabs.z ? vec3(0,1,0) : vec3(0,0,1) );
+		const vec3 e1 = cross( ab, axis );
+		const vec3 e2 = cross( ab, e1 );
+		const vec3 dirs[4] = { e1, -e1, e2, -e2 };
+		for ( size_t i = 0 ; i < 4 && 2 == *count ; ++i )
+		{
+			const gjk_vertex w = gjk_support( a, b, dirs[i] );
+			if ( length(cross(w.w - v[0].w, ab)) > eps*length(ab) )
+				v[(*count)++] = w;
+		}
+		// segment, any perpendicular direction has zero core depth
+		const float len = length( e1 );
+		if ( 2 == *count && len > 0.f )
+			*flatnormal = e1 / len;
+	}
+	if ( 3 == *count )
+	{
+		vec3 n = cross( v[1].w - v[0].w, v[2].w - v[0].w );
+		const float len = length( n );
+		if ( len > 0.f )
+		{
+			n /= len;
+			gjk_vertex w = gjk_support( a, b, n );
+			if ( fabsf(dot(w.w - v[0].w, n)) <= eps )
+				w = gjk_support( a, b, -n );
+			if ( fabsf(dot(w.w - v[0].w, n)) > eps )
+				v[(*count)++] = w;
+			else
+				*flatnormal = n;
+		}
+	}
+	if ( *count < 4 )
+		return false;
+
+	const float vol = dot( cross(v[1].w - v[0].w, v[2].w - v[0].w), v[3].w - v[0].w );
+	return fabsf(vol) > eps*eps*eps;
+}
+
+bool epa_penetration( const gjk_shape& a, const gjk_shape& b, gjk_simplex* simplex, gjk_result* result )
+{
+	gjk_vertex verts[EPA_MAX_VERTICES];
+	float weight[4];
+	size_t count;
+	const bool overlap = gjk_core( a, b, simplex, verts, &count, weight, &result->iterations );
+
+	vec3 pa( 0.f );
+	vec3 pb( 0.f );
+	for ( size_t i = 0 ; i < count ; ++i )
+	{
+		pa += verts[i].a * weight[i];
+		pb += verts[i].b * weight[i];
+	}
+	if ( !overlap )
+	{
+		// separated, or overlapping only within radii
+		core_result( a, b, pa, pb, result );
+		return result->distance < 0.f;
+	}
+
+	float scale = 0.f;
+	for ( size_t i = 0 ; i < count ; ++i )
+		scale = max( scale, length(verts[i].w) );
+	const float eps = max( scale, FLT_MIN ) * 1e-5f;
+
+	// cores overlap only in a plane or a line, penetration is the sum of radii along its normal
+	vec3 flatnormal;
+	if ( !epa_tetrahedron(a, b, verts, &count, eps, &flatnormal) )
+	{
+		result->normal = flatnormal;
+		result->pointa = pa + result->normal*a.radius;
+		result->pointb = pb - result->normal*b.radius;
+		result->distance = -a.radius - b.radius;
+		return true;
+	}
+
+	const vec3 interior = (verts[0].w + verts[1].w + verts[2].w + verts[3].w) * .25f;
+	epa_face faces[EPA_MAX_FACES];
+	size_t facecount = 0;
+	static const size_t tetra[4][3] = { {0,1,2}, {0,3,1}, {0,2,3}, {1,3,2} };
+	for ( size_t i = 0 ; i < 4 ; ++i )
+		if ( make_epa_face(verts, tetra[i][0], tetra[i][1], tetra[i][2], interior, &faces[facecount]) )
+			++facecount;
+
+	epa_face face = faces[0];
+	for ( size_t iter = 0 ; facecount > 0 ; ++iter )
+	{
+		size_t closest = 0;
+		for ( size_t i = 1 ; i < facecount ; ++i )
+			if ( faces[i].d < faces[closest].d )
+				closest = i;
+
+		face = faces[closest];
+		if ( iter >= EPA_MAX_ITERATIONS || count >= EPA_MAX_VERTICES )
+			break;
+		const gjk_vertex w = gjk_support( a, b, face.n );
+		if ( dot(w.w, face.n) - face.d <= max(face.d*EPA_REL_EPSILON, eps) )
+			break;
+
+		// remove faces seen from the new vertex, and connect the hole boundary to it
+		size_t edges[EPA_MAX_FACES*3][2];
+		size_t edgecount = 0;
+		for ( size_t i = 0 ; i < facecount ; )
+		{
+			const epa_face& f = faces[i];
+			if ( dot(f.n, w.w - verts[f.v[0]].w) > 0.f )
+			{
+				add_horizon_edge( edges, &edgecount, f.v[0], f.v[1] );
+				add_horizon_edge( edges, &edgecount, f.v[1], f.v[2] );
+				add_horizon_edge( edges, &edgecount, f.v[2], f.v[0] );
+				faces[i] = faces[--facecount];
+			}
+			else
+			{
+				++i;
+			}
+		}
+		if ( facecount + edgecount > EPA_MAX_FACES )
+			break;
+
+		verts[count] = w;
+		for ( size_t i = 0 ; i < edgecount ; ++i )
+			if ( make_epa_face(verts, edges[i][0], edges[i][1], count, interior, &faces[facecount]) )
+				++facecount;
+		++count;
+	}
+
+	// deepest points from barycentric coordinates of the closest point on the closest face
+	const gjk_vertex& v0 = verts[face.v[0]];
+	const gjk_vertex& v1 = verts[face.v[1]];
+	const gjk_vertex& v2 = verts[face.v[2]];
+	float u, v;
+	closest_point_triangle( face.n*face.d, v0.w, v1.w, v2.w, &u, &v );
+	pa = v0.a*(1.f-u-v) + v1.a*u + v2.a*v;
+	pb = v0.b*(1.f-u-v) + v1.b*u + v2.b*v;
+
+	result->normal = face.n;
+	result->pointa = pa + face.n*a.radius;
+	result->pointb = pb - face.n*b.radius;
+	result->distance = -face.d - a.radius - b.radius;
+	return true;
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
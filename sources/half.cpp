@@ -0,0 +1,88 @@
+#include <slm/half.h>
+#include <slm/runtime_checks.h>
+
+// MSVC intrinsics don't need F16C enabled at compile time, GCC and clang enable it only for the conversion functions
+#if defined(SLMATH_SSE2_MSVC) && defined(SLMATH_MSVC_HAS_INTRIN_H)
+	#include <immintrin.h>
+	#define SLMATH_HALF_F16C
+	#define SLMATH_HALF_F16C_TARGET
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define SLMATH_HALF_F16C
+	#define SLMATH_HALF_F16C_TARGET __attribute__((target("f16c")))
+#endif
+
+SLMATH_BEGIN()
+
+#ifdef SLMATH_HALF_F16C
+/** Returns true if F16C instructions can be used, checked once. */
+static bool useF16C()
+{
+	static const bool f16c = isF16CCPU();
+	return f16c;
+}
+
+/** Converts groups of four floats with F16C, returns number of values converted. */
+static SLMATH_HALF_F16C_TARGET size_t float_to_half_f16c( const float* in, size_t n, unsigned short* out )
+{
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+		_mm_storel_epi64( (__m128i*)(out+i), _mm_cvtps_ph(_mm_loadu_ps(in+i), 0) );
+	return i;
+}
+
+/** Converts groups of four half precision values with F16C, returns number of values converted. */
+static SLMATH_HALF_F16C_TARGET size_t half_to_float_f16c( const unsigned short* in, size_t n, float* out )
+{
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+		_mm_storeu_ps( out+i, _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)(in+i))) );
+	return i;
+}
+#endif
+
+void float_to_half( const float* in, size_t n, unsigned short* out )
+{
+	size_t i = 0;
+#ifdef SLMATH_HALF_F16C
+	if ( useF16C() )
+		i = float_to_half_f16c( in, n, out );
+#endif
+	for ( ; i < n ; ++i )
+		out[i] = float_to_half( in[i] );
+}
+
+void half_to_float( const unsigned short* in, size_t n, float* out )
+{
+	size_t i = 0;
+#ifdef SLMATH_HALF_F16C
+	if ( useF16C() )
+		i = half_to_float_f16c( in, n, out );
+#endif
+	for ( ; i < n ; ++i )
+		out[i] = half_to_float( in[i] );
+}
+
+void to_half( const vec2* in, size_t n, vec2h* out )
+{
+	float_to_half( &in[0].x, n*2, &out[0].x );
+}
+
+void to_half( const vec4* in, size_t n, vec4h* out )
+{
+	float_to_half( &in[0].x, n*4, &out[0].x );
+}
+
+void to_float( const vec2h* in, size_t n, vec2* out )
+{
+	half_to_float( &in[0].x, n*2, &out[0].x );
+}
+
+void to_float( const vec4h* in, size_t n, vec4* out )
+{
+	half_to_float( &in[0].x, n*4, &out[0].x );
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,62 @@
+#include <slm/intersect_stats.h>
+
+SLMATH_BEGIN()
+
+SLMATH_THREAD_LOCAL intersect_stats g_thread_intersect_stats;
+
+void intersect_stats::clear()
+{
+	queries = 0;
+	node_visits = 0;
+	box_tests = 0;
+	triangle_tests = 0;
+	early_outs = 0;
+}
+
+intersect_stats& intersect_stats::operator+=( const intersect_stats& other )
+{
+	queries += other.queries;
+	node_visits += other.node_visits;
+	box_tests += other.box_tests;
+	triangle_tests += other.triangle_tests;
+	early_outs += other.early_outs;
+	return *this;
+}
+
+intersect_stats& intersect_stats::operator-=( const intersect_stats& other )
+{
+	queries -= other.queries;
+	node_visits -= other.node_visits;
+	box_tests -= other.box_tests;
+	triangle_tests -= other.triangle_tests;
+	early_outs -= other.early_outs;
+	return *this;
+}
+
+intersect_stats& thread_intersect_stats()
+{
+	return g_thread_intersect_stats;
+}
+
+/** Prints one counter and its average per query. */
+static void print_counter( const char* name, size_t count, size_t queries, FILE* fp )
+{
+	const double avg = (queries > 0 ? double(count) / double(queries) : 0.0);
+	fprintf( fp, "%-16s %12lu %12.2f/query\n", name, (unsigned long)count, avg );
+}
+
+void print_intersect_stats( const intersect_stats& stats, FILE* fp )
+{
+#ifndef SLMATH_STATS
+	fprintf( fp, "intersect_stats: SLMATH_STATS not defined, nothing counted\n" );
+#endif
+	fprintf( fp, "%-16s %12lu\n", "queries", (unsigned long)stats.queries );
+	print_counter( "node_visits", stats.node_visits, stats.queries, fp );
+	print_counter( "box_tests", stats.box_tests, stats.queries, fp );
+	print_counter( "triangle_tests", stats.triangle_tests, stats.queries, fp );
+	print_counter( "early_outs", stats.early_outs, stats.queries, fp );
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
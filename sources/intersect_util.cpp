@@ -1,4 +1,5 @@
 #include <slm/intersect_util.h>
+#include <slm/intersect_stats.h>
 
 SLMATH_BEGIN()
 
@@ -14,6 +15,199 @@ intersect_line_box_line::intersect_line_box_line( const vec3& origin, const vec3
 {
 }
 
+/** Returns index of the component with the largest absolute value. */
+static int dominant_axis( const vec3& d )
+{
+	const vec3 a = abs(d);
+	return a.x > a.y ? (a.x > a.z ? 0 : 2) : (a.y > a.z ? 1 : 2);
+}
+
+/** Returns axis which maps to X-axis in watertight ray space. Swapped with Y if needed to preserve winding. */
+static int watertight_kx( const vec3& d )
+{
+	const int kz = dominant_axis( d );
+	const int kx = (kz == 2 ? 0 : kz+1);
+	const int ky = (kx == 2 ? 0 : kx+1);
+	return d[kz] < 0.f ? ky : kx;
+}
+
+/** Returns axis which maps to Y-axis in watertight ray space. Swapped with X if needed to preserve winding. */
+static int watertight_ky( const vec3& d )
+{
+	const int kz = dominant_axis( d );
+	const int kx = (kz == 2 ? 0 : kz+1);
+	const int ky = (kx == 2 ? 0 : kx+1);
+	return d[kz] < 0.f ? kx : ky;
+}
+
+intersect_line_triangle_line::intersect_line_triangle_line( const vec3& origin, const vec3& direction ) :
+	o( origin ),
+	d( direction ),
+	kz( dominant_axis(direction) ),
+	kx( watertight_kx(direction) ),
+	ky( watertight_ky(direction) ),
+	sx( direction[watertight_kx(direction)] / direction[dominant_axis(direction)] ),
+	sy( direction[watertight_ky(direction)] / direction[dominant_axis(direction)] ),
+	sz( 1.f / direction[dominant_axis(direction)] )
+{
+	SLMATH_VEC_ASSERT( length(direction) > FLT_MIN );
+}
+
+void triangle4::set( size_t i, const vec3& v0, const vec3& v1, const vec3& v2 )
+{
+	assert( i < SIZE );
+	const vec3* const vk[3] = {&v0, &v1, &v2};
+	for ( size_t k = 0 ; k < 3 ; ++k )
+		for ( size_t a = 0 ; a < 3 ; ++a )
+			reinterpret_cast<float*>(&v[k][a])[i] = (*vk[k])[a];
+}
+
+void triangle4::clear( size_t i )
+{
+	const vec3 zero( 0.f );
+	set( i, zero, zero, zero );
+}
+
+vec3 triangle4::vertex( size_t i, size_t k ) const
+{
+	assert( i < SIZE && k < 3 );
+	return vec3( reinterpret_cast<const float*>(&v[k][0])[i], reinterpret_cast<const float*>(&v[k][1])[i], reinterpret_cast<const float*>(&v[k][2])[i] );
+}
+
+bool intersect_line_triangle_watertight( const intersect_line_triangle_line& line, const vec3& v0, const vec3& v1, const vec3& v2, float tmin, float tmax, float* t, float* u, float* v )
+{
+	const int kx = line.kx;
+	const int ky = line.ky;
+	const int kz = line.kz;
+
+	// vertices relative to line start point
+	const vec3 a = v0 - line.o;
+	const vec3 b = v1 - line.o;
+	const vec3 c = v2 - line.o;
+
+	// shear and scale vertices so that the line points along +Z
+	const float ax = a[kx] - line.sx*a[kz];
+	const float ay = a[ky] - line.sy*a[kz];
+	const float bx = b[kx] - line.sx*b[kz];
+	const float by = b[ky] - line.sy*b[kz];
+	const float cx = c[kx] - line.sx*c[kz];
+	const float cy = c[ky] - line.sy*c[kz];
+
+	// scaled barycentric coordinates
+	float U = cx*by - cy*bx;
+	float V = ax*cy - ay*cx;
+	float W = bx*ay - by*ax;
+
+	// fall back to double precision test at edges, where float result can have wrong sign
+	if ( U == 0.f || V == 0.f || W == 0.f )
+	{
+		U = float( double(cx)*double(by) - double(cy)*double(bx) );
+		V = float( double(ax)*double(cy) - double(ay)*double(cx) );
+		W = float( double(bx)*double(ay) - double(by)*double(ax) );
+	}
+
+	if ( (U < 0.f || V < 0.f || W < 0.f) && (U > 0.f || V > 0.f || W > 0.f) )
+		return false;
+
+	const float det = U + V + W;
+	if ( det == 0.f )
+		return false;
+
+	const float T = U*line.sz*a[kz] + V*line.sz*b[kz] + W*line.sz*c[kz];
+	const float invdet = 1.f / det;
+	const float s = T * invdet;
+	if ( s < tmin || s > tmax )
+		return false;
+
+	if (t)
+		*t = s;
+	if (u)
+		*u = V * invdet;
+	if (v)
+		*v = W * invdet;
+	return true;
+}
+
+bool intersect_line_triangle_watertight( const vec3& o, const vec3& d, const vec3& v0, const vec3& v1, const vec3& v2, float* t, float* u, float* v )
+{
+	const intersect_line_triangle_line line( o, d );
+	return intersect_line_triangle_watertight( line, v0, v1, v2, 0.f, 1.f, t, u, v );
+}
+
+int intersect_line_triangle4( const intersect_line_triangle_line& line, const triangle4& tri, float tmin, float tmax, float* t, float* u, float* v )
+{
+	const int kx = line.kx;
+	const int ky = line.ky;
+	const int kz = line.kz;
+
+	const m128_t ox = SLMATH_LOAD_PS1( &line.o[kx] );
+	const m128_t oy = SLMATH_LOAD_PS1( &line.o[ky] );
+	const m128_t oz = SLMATH_LOAD_PS1( &line.o[kz] );
+	const m128_t sx = SLMATH_LOAD_PS1( &line.sx );
+	const m128_t sy = SLMATH_LOAD_PS1( &line.sy );
+	const m128_t sz = SLMATH_LOAD_PS1( &line.sz );
+
+	// vertices relative to line start point, sheared so that the line points along +Z
+	const m128_t az = SLMATH_MUL_PS( SLMATH_SUB_PS(tri.v[0][kz],oz), sz );
+	const m128_t bz = SLMATH_MUL_PS( SLMATH_SUB_PS(tri.v[1][kz],oz), sz );
+	const m128_t cz = SLMATH_MUL_PS( SLMATH_SUB_PS(tri.v[2][kz],oz), sz );
+	const m128_t ax = SLMATH_SUB_PS( SLMATH_SUB_PS(tri.v[0][kx],ox), SLMATH_MUL_PS(sx,SLMATH_SUB_PS(tri.v[0][kz],oz)) );
+	const m128_t ay = SLMATH_SUB_PS( SLMATH_SUB_PS(tri.v[0][ky],oy), SLMATH_MUL_PS(sy,SLMATH_SUB_PS(tri.v[0][kz],oz)) );
+	const m128_t bx = SLMATH_SUB_PS( SLMATH_SUB_PS(tri.v[1][kx],ox), SLMATH_MUL_PS(sx,SLMATH_SUB_PS(tri.v[1][kz],oz)) );
+	const m128_t by = SLMATH_SUB_PS( SLMATH_SUB_PS(tri.v[1][ky],oy), SLMATH_MUL_PS(sy,SLMATH_SUB_PS(tri.v[1][kz],oz)) );
+	const m128_t cx = SLMATH_SUB_PS( SLMATH_SUB_PS(tri.v[2][kx],ox), SLMATH_MUL_PS(sx,SLMATH_SUB_PS(tri.v[2][kz],oz)) );
+	const m128_t cy = SLMATH_SUB_PS( SLMATH_SUB_PS(tri.v[2][ky],oy), SLMATH_MUL_PS(sy,SLMATH_SUB_PS(tri.v[2][kz],oz)) );
+
+	// scaled barycentric coordinates
+	// note: no double precision fallback here, but inclusive edge tests still leave no gaps between triangles
+	const m128_t U = SLMATH_SUB_PS( SLMATH_MUL_PS(cx,by), SLMATH_MUL_PS(cy,bx) );
+	const m128_t V = SLMATH_SUB_PS( SLMATH_MUL_PS(ax,cy), SLMATH_MUL_PS(ay,cx) );
+	const m128_t W = SLMATH_SUB_PS( SLMATH_MUL_PS(bx,ay), SLMATH_MUL_PS(by,ax) );
+
+	const m128_t zero = SLMATH_SETZERO_PS();
+	const m128_t anyneg = SLMATH_OR_PS( SLMATH_OR_PS(SLMATH_CMPLT_PS(U,zero), SLMATH_CMPLT_PS(V,zero)), SLMATH_CMPLT_PS(W,zero) );
+	const m128_t anypos = SLMATH_OR_PS( SLMATH_OR_PS(SLMATH_CMPGT_PS(U,zero), SLMATH_CMPGT_PS(V,zero)), SLMATH_CMPGT_PS(W,zero) );
+	const m128_t det = SLMATH_ADD_PS( SLMATH_ADD_PS(U,V), W );
+	m128_t valid = SLMATH_ANDNOT_PS( SLMATH_AND_PS(anyneg,anypos), SLMATH_CMPNEQ_PS(det,zero) );
+	if ( 0 == SLMATH_MOVEMASK_PS(valid) )
+		return -1;
+
+	const float onef = 1.f;
+	const m128_t one = SLMATH_LOAD_PS1( &onef );
+	const m128_t invdet = SLMATH_DIV_PS( one, SLMATH_SELECT_PS(valid,det,one) );
+	const m128_t T = SLMATH_ADD_PS( SLMATH_ADD_PS(SLMATH_MUL_PS(U,az), SLMATH_MUL_PS(V,bz)), SLMATH_MUL_PS(W,cz) );
+	const m128_t s = SLMATH_MUL_PS( T, invdet );
+	valid = SLMATH_AND_PS( valid, SLMATH_CMPGE_PS(s,SLMATH_LOAD_PS1(&tmin)) );
+	valid = SLMATH_AND_PS( valid, SLMATH_CMPLE_PS(s,SLMATH_LOAD_PS1(&tmax)) );
+	const int mask = SLMATH_MOVEMASK_PS( valid );
+	if ( 0 == mask )
+		return -1;
+
+	SLMATH_ALIGN16 float sv[4];
+	SLMATH_STORE_PS( sv, s );
+	int nearest = -1;
+	for ( int i = 0 ; i < 4 ; ++i )
+	{
+		if ( (mask & (1<<i)) && (nearest < 0 || sv[i] < sv[nearest]) )
+			nearest = i;
+	}
+
+	if (t)
+		*t = sv[nearest];
+	if (u || v)
+	{
+		SLMATH_ALIGN16 float uv[4];
+		SLMATH_ALIGN16 float vv[4];
+		SLMATH_STORE_PS( uv, SLMATH_MUL_PS(V,invdet) );
+		SLMATH_STORE_PS( vv, SLMATH_MUL_PS(W,invdet) );
+		if (u)
+			*u = uv[nearest];
+		if (v)
+			*v = vv[nearest];
+	}
+	return nearest;
+}
+
 bool intersect_line_triangle( const vec3& o, const vec3& d, const vec3& v0, const vec3& v1, const vec3& v2, float* t )
 {
 	const vec3	e1		= v1 - v0;
@@ -44,13 +238,14 @@ bool intersect_line_triangle( const vec3& o, const vec3& d, const vec3& v0, cons
 	return true;
 }
 
-bool intersect_line_box( const intersect_line_box_line& r, const vec3* boxminmax )
+/**
+ * Clips line parameter range to the box slabs.
+ * @return false if the line misses the box, otherwise [tmin,tmax] is the range of the line inside the box.
+ */
+static inline bool intersect_line_box_slabs( const intersect_line_box_line& r, const vec3* boxminmax, float* ptmin, float* ptmax )
 {
-	const float t0 = 0.0f;
-	const float t1 = 1.0f;
-
 	const int* const sign = &r.signx;
-	register float tmin, tmax, tymin, tymax, tzmin, tzmax;
+	float tmin, tmax, tymin, tymax, tzmin, tzmax;
 	tmin = (boxminmax[sign[0]].x - r.o.x) * r.inv_d.x;
 	tmax = (boxminmax[1-sign[0]].x - r.o.x) * r.inv_d.x;
 	tymin = (boxminmax[sign[1]].y - r.o.y) * r.inv_d.y;
@@ -66,9 +261,22 @@ bool intersect_line_box( const intersect_line_box_line& r, const vec3* boxminmax
 	if ( (tmin > tzmax) || (tzmin > tmax) ) 
 		return false;
 	if (tzmin > tmin)
-	tmin = tzmin;
+		tmin = tzmin;
 	if (tzmax < tmax)
 		tmax = tzmax;
+	*ptmin = tmin;
+	*ptmax = tmax;
+	return true;
+}
+
+bool intersect_line_box( const intersect_line_box_line& r, const vec3* boxminmax )
+{
+	const float t0 = 0.0f;
+	const float t1 = 1.0f;
+
+	float tmin, tmax;
+	if ( !intersect_line_box_slabs(r, boxminmax, &tmin, &tmax) )
+		return false;
 	return ( (tmin < t1) && (tmax > t0) );
 }
 
@@ -81,6 +289,703 @@ bool intersect_line_box( const vec3& o, const vec3& d, const vec3& boxmin, const
 	return intersect_line_box( line, boxminmax );
 }
 
+intersect_triangle_box_triangle::intersect_triangle_box_triangle( const vec3& v0, const vec3& v1, const vec3& v2 )
+{
+	const vec3 edge[3] = {v1-v0, v2-v1, v0-v2};
+	axis[0] = vec3( 1.f, 0.f, 0.f );
+	axis[1] = vec3( 0.f, 1.f, 0.f );
+	axis[2] = vec3( 0.f, 0.f, 1.f );
+	axis[3] = cross( edge[0], edge[1] );
+	for ( size_t i = 0 ; i < 3 ; ++i )
+		for ( size_t k = 0 ; k < 3 ; ++k )
+			axis[4+i*3+k] = cross( axis[i], edge[k] );
+
+	for ( size_t i = 0 ; i < AXIS_COUNT ; ++i )
+	{
+		const float p0 = dot( axis[i], v0 );
+		const float p1 = dot( axis[i], v1 );
+		const float p2 = dot( axis[i], v2 );
+		pmin[i] = min( p0, min(p1,p2) );
+		pmax[i] = max( p0, max(p1,p2) );
+	}
+}
+
+bool intersect_triangle_box( const vec3& v0, const vec3& v1, const vec3& v2, const vec3& boxmin, const vec3& boxmax )
+{
+	// separated if projections of the triangle and the box don't overlap on any axis
+	const intersect_triangle_box_triangle tri( v0, v1, v2 );
+	const vec3 c = (boxmin + boxmax) * .5f;
+	const vec3 h = (boxmax - boxmin) * .5f;
+	for ( size_t i = 0 ; i < intersect_triangle_box_triangle::AXIS_COUNT ; ++i )
+	{
+		const vec3& a = tri.axis[i];
+		const float s = dot( a, c );
+		const float r = fabsf(a.x)*h.x + fabsf(a.y)*h.y + fabsf(a.z)*h.z;
+		if ( tri.pmin[i] - s > r || tri.pmax[i] - s < -r )
+			return false;
+	}
+	return true;
+}
+
+int intersect_triangle_box4( const intersect_triangle_box_triangle& tri, const m128_t& cx, const m128_t& cy, const m128_t& cz, const m128_t& hx, const m128_t& hy, const m128_t& hz )
+{
+	m128_t separated = SLMATH_SETZERO_PS();
+	for ( size_t i = 0 ; i < intersect_triangle_box_triangle::AXIS_COUNT ; ++i )
+	{
+		// box faces first, they reject most boxes
+		if ( 3 == i && 0xF == SLMATH_MOVEMASK_PS(separated) )
+			return 0;
+
+		const vec3& a = tri.axis[i];
+		const vec3 absa = abs( a );
+		const m128_t s = SLMATH_ADD_PS( SLMATH_ADD_PS(SLMATH_MUL_PS(SLMATH_LOAD_PS1(&a.x),cx), SLMATH_MUL_PS(SLMATH_LOAD_PS1(&a.y),cy)), SLMATH_MUL_PS(SLMATH_LOAD_PS1(&a.z),cz) );
+		const m128_t r = SLMATH_ADD_PS( SLMATH_ADD_PS(SLMATH_MUL_PS(SLMATH_LOAD_PS1(&absa.x),hx), SLMATH_MUL_PS(SLMATH_LOAD_PS1(&absa.y),hy)), SLMATH_MUL_PS(SLMATH_LOAD_PS1(&absa.z),hz) );
+		const m128_t lo = SLMATH_SUB_PS( SLMATH_LOAD_PS1(&tri.pmin[i]), s );
+		const m128_t hi = SLMATH_SUB_PS( SLMATH_LOAD_PS1(&tri.pmax[i]), s );
+		separated = SLMATH_OR_PS( separated, SLMATH_OR_PS(SLMATH_CMPGT_PS(lo,r), SLMATH_CMPLT_PS(SLMATH_ADD_PS(hi,r),SLMATH_SETZERO_PS())) );
+	}
+	return ~SLMATH_MOVEMASK_PS(separated) & 0xF;
+}
+
+void intersect_triangle_boxes_mask( const vec3& v0, const vec3& v1, const vec3& v2, const float* minx, const float* miny, const float* minz, const float* maxx, const float* maxy, const float* maxz, size_t n, unsigned int* mask )
+{
+	const intersect_triangle_box_triangle tri( v0, v1, v2 );
+	const float halff = .5f;
+	const m128_t half = SLMATH_LOAD_PS1( &halff );
+	for ( size_t w = 0 ; w < (n+31)/32 ; ++w )
+		mask[w] = 0;
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+	{
+		const m128_t bminx = SLMATH_LOADU_PS( minx+i ), bmaxx = SLMATH_LOADU_PS( maxx+i );
+		const m128_t bminy = SLMATH_LOADU_PS( miny+i ), bmaxy = SLMATH_LOADU_PS( maxy+i );
+		const m128_t bminz = SLMATH_LOADU_PS( minz+i ), bmaxz = SLMATH_LOADU_PS( maxz+i );
+		const m128_t cx = SLMATH_MUL_PS( SLMATH_ADD_PS(bminx,bmaxx), half );
+		const m128_t cy = SLMATH_MUL_PS( SLMATH_ADD_PS(bminy,bmaxy), half );
+		const m128_t cz = SLMATH_MUL_PS( SLMATH_ADD_PS(bminz,bmaxz), half );
+		const m128_t hx = SLMATH_MUL_PS( SLMATH_SUB_PS(bmaxx,bminx), half );
+		const m128_t hy = SLMATH_MUL_PS( SLMATH_SUB_PS(bmaxy,bminy), half );
+		const m128_t hz = SLMATH_MUL_PS( SLMATH_SUB_PS(bmaxz,bminz), half );
+		mask[i>>5] |= unsigned(intersect_triangle_box4(tri,cx,cy,cz,hx,hy,hz)) << (i&31);
+	}
+	for ( ; i < n ; ++i )
+		if ( intersect_triangle_box(v0, v1, v2, vec3(minx[i],miny[i],minz[i]), vec3(maxx[i],maxy[i],maxz[i])) )
+			mask[i>>5] |= 1u << (i&31);
+}
+
+ray::ray( const vec3& origin, const vec3& direction ) :
+	box_line( origin, direction ),
+	triangle_line( origin, direction ),
+	tmin( 0.f ),
+	tmax( FLT_MAX )
+{
+}
+
+ray::ray( const vec3& origin, const vec3& direction, float tmin0, float tmax0 ) :
+	box_line( origin, direction ),
+	triangle_line( origin, direction ),
+	tmin( tmin0 ),
+	tmax( tmax0 )
+{
+	SLMATH_VEC_ASSERT( tmin0 <= tmax0 );
+}
+
+/** Clips ray range [tmin,tmax] to the box, returns false if empty. */
+static inline bool intersect_ray_box( const ray& r, const vec3* boxminmax, float* tnear )
+{
+	float tmin, tmax;
+	if ( !intersect_line_box_slabs(r.box_line, boxminmax, &tmin, &tmax) )
+		return false;
+	tmin = max( tmin, r.tmin );
+	tmax = min( tmax, r.tmax );
+	if ( tmin > tmax )
+		return false;
+	*tnear = tmin;
+	return true;
+}
+
+bool intersect_ray_box( const ray& r, const vec3& boxmin, const vec3& boxmax, float* tnear )
+{
+	const vec3 boxminmax[2] = {boxmin, boxmax};
+	float t;
+	if ( !intersect_ray_box(r, boxminmax, &t) )
+		return false;
+	if (tnear)
+		*tnear = t;
+	return true;
+}
+
+bool intersect_ray_triangle( const ray& r, const vec3& v0, const vec3& v1, const vec3& v2, float* t, float* u, float* v )
+{
+	return intersect_line_triangle_watertight( r.triangle_line, v0, v1, v2, r.tmin, r.tmax, t, u, v );
+}
+
+bool intersect_ray_boxes( ray& r, ray_query mode, const vec3* boxminmax, size_t n, ray_hit* hit )
+{
+	bool found = false;
+	SLMATH_STATS_ADD( queries, 1 );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		SLMATH_STATS_ADD( box_tests, 1 );
+		float t;
+		if ( intersect_ray_box(r, boxminmax+i*2, &t) )
+		{
+			if (hit)
+			{
+				hit->t = t;
+				hit->u = hit->v = 0.f;
+				hit->index = i;
+			}
+			if ( RAY_ANY_HIT == mode )
+			{
+				SLMATH_STATS_ADD( early_outs, 1 );
+				return true;
+			}
+			r.tmax = t;
+			found = true;
+		}
+	}
+	return found;
+}
+
+bool intersect_ray_triangles( ray& r, ray_query mode, const vec3* vertices, const unsigned int* indices, size_t n, ray_hit* hit )
+{
+	bool found = false;
+	SLMATH_STATS_ADD( queries, 1 );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		SLMATH_STATS_ADD( triangle_tests, 1 );
+		const size_t i0 = indices ? indices[i*3+0] : i*3+0;
+		const size_t i1 = indices ? indices[i*3+1] : i*3+1;
+		const size_t i2 = indices ? indices[i*3+2] : i*3+2;
+		float t, u, v;
+		if ( intersect_line_triangle_watertight(r.triangle_line, vertices[i0], vertices[i1], vertices[i2], r.tmin, r.tmax, &t, &u, &v) )
+		{
+			if (hit)
+			{
+				hit->t = t;
+				hit->u = u;
+				hit->v = v;
+				hit->index = i;
+			}
+			if ( RAY_ANY_HIT == mode )
+			{
+				SLMATH_STATS_ADD( early_outs, 1 );
+				return true;
+			}
+			r.tmax = t;
+			found = true;
+		}
+	}
+	return found;
+}
+
+bool intersect_ray_triangle4s( ray& r, ray_query mode, const triangle4* blocks, size_t n, ray_hit* hit )
+{
+	bool found = false;
+	SLMATH_STATS_ADD( queries, 1 );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		SLMATH_STATS_ADD( triangle_tests, triangle4::SIZE );
+		float t, u, v;
+		const int k = intersect_line_triangle4( r.triangle_line, blocks[i], r.tmin, r.tmax, &t, &u, &v );
+		if ( k >= 0 )
+		{
+			if (hit)
+			{
+				hit->t = t;
+				hit->u = u;
+				hit->v = v;
+				hit->index = i*triangle4::SIZE + size_t(k);
+			}
+			if ( RAY_ANY_HIT == mode )
+			{
+				SLMATH_STATS_ADD( early_outs, 1 );
+				return true;
+			}
+			r.tmax = t;
+			found = true;
+		}
+	}
+	return found;
+}
+
+/** Returns point v0 + ab*s + ac*t of triangle and stores barycentric weights s and t to u and v. */
+static inline vec3 triangle_point( const vec3& v0, const vec3& ab, const vec3& ac, float s, float t, float* u, float* v )
+{
+	if (u)
+		*u = s;
+	if (v)
+		*v = t;
+	return v0 + ab*s + ac*t;
+}
+
+vec3 closest_point_triangle( const vec3& p, const vec3& v0, const vec3& v1, const vec3& v2, float* u, float* v )
+{
+	// vertex 0 region
+	const vec3 ab = v1 - v0;
+	const vec3 ac = v2 - v0;
+	const vec3 ap = p - v0;
+	const float d1 = dot( ab, ap );
+	const float d2 = dot( ac, ap );
+	if ( d1 <= 0.f && d2 <= 0.f )
+		return triangle_point( v0, ab, ac, 0.f, 0.f, u, v );
+
+	// vertex 1 region
+	const vec3 bp = p - v1;
+	const float d3 = dot( ab, bp );
+	const float d4 = dot( ac, bp );
+	if ( d3 >= 0.f && d4 <= d3 )
+		return triangle_point( v0, ab, ac, 1.f, 0.f, u, v );
+
+	// edge 01 region
+	const float vc = d1*d4 - d3*d2;
+	if ( vc <= 0.f && d1 >= 0.f && d3 <= 0.f )
+		return triangle_point( v0, ab, ac, d1/(d1-d3), 0.f, u, v );
+
+	// vertex 2 region
+	const vec3 cp = p - v2;
+	const float d5 = dot( ab, cp );
+	const float d6 = dot( ac, cp );
+	if ( d6 >= 0.f && d5 <= d6 )
+		return triangle_point( v0, ab, ac, 0.f, 1.f, u, v );
+
+	// edge 02 region
+	const float vb = d5*d2 - d1*d6;
+	if ( vb <= 0.f && d2 >= 0.f && d6 <= 0.f )
+		return triangle_point( v0, ab, ac, 0.f, d2/(d2-d6), u, v );
+
+	// edge 12 region
+	const float va = d3*d6 - d5*d4;
+	if ( va <= 0.f && d4-d3 >= 0.f && d5-d6 >= 0.f )
+	{
+		const float t = (d4-d3) / ((d4-d3) + (d5-d6));
+		return triangle_point( v0, ab, ac, 1.f-t, t, u, v );
+	}
+
+	// inside face
+	const float denom = va + vb + vc;
+	if ( denom == 0.f )
+		return triangle_point( v0, ab, ac, 0.f, 0.f, u, v );
+	return triangle_point( v0, ab, ac, vb/denom, vc/denom, u, v );
+}
+
+/** Returns dot products of four vectors in SoA form. */
+static inline m128_t dot4( m128_t ax, m128_t ay, m128_t az, m128_t bx, m128_t by, m128_t bz )
+{
+	return SLMATH_ADD_PS( SLMATH_ADD_PS(SLMATH_MUL_PS(ax,bx), SLMATH_MUL_PS(ay,by)), SLMATH_MUL_PS(az,bz) );
+}
+
+/** Returns a/b, or 0 where b is zero. */
+static inline m128_t safe_div4( m128_t a, m128_t b )
+{
+	const m128_t nz = SLMATH_CMPNEQ_PS( b, SLMATH_SETZERO_PS() );
+	const float onef = 1.f;
+	return SLMATH_AND_PS( nz, SLMATH_DIV_PS(a, SLMATH_SELECT_PS(nz,b,SLMATH_LOAD_PS1(&onef))) );
+}
+
+void closest_point_triangle4( const vec3& p, const triangle4& tri, float* dist2, float* u, float* v )
+{
+	const m128_t zero = SLMATH_SETZERO_PS();
+	const float onef = 1.f;
+	const m128_t one = SLMATH_LOAD_PS1( &onef );
+	const m128_t px = SLMATH_LOAD_PS1( &p.x );
+	const m128_t py = SLMATH_LOAD_PS1( &p.y );
+	const m128_t pz = SLMATH_LOAD_PS1( &p.z );
+
+	const m128_t abx = SLMATH_SUB_PS( tri.v[1][0], tri.v[0][0] );
+	const m128_t aby = SLMATH_SUB_PS( tri.v[1][1], tri.v[0][1] );
+	const m128_t abz = SLMATH_SUB_PS( tri.v[1][2], tri.v[0][2] );
+	const m128_t acx = SLMATH_SUB_PS( tri.v[2][0], tri.v[0][0] );
+	const m128_t acy = SLMATH_SUB_PS( tri.v[2][1], tri.v[0][1] );
+	const m128_t acz = SLMATH_SUB_PS( tri.v[2][2], tri.v[0][2] );
+	const m128_t apx = SLMATH_SUB_PS( px, tri.v[0][0] );
+	const m128_t apy = SLMATH_SUB_PS( py, tri.v[0][1] );
+	const m128_t apz = SLMATH_SUB_PS( pz, tri.v[0][2] );
+	const m128_t bpx = SLMATH_SUB_PS( px, tri.v[1][0] );
+	const m128_t bpy = SLMATH_SUB_PS( py, tri.v[1][1] );
+	const m128_t bpz = SLMATH_SUB_PS( pz, tri.v[1][2] );
+	const m128_t cpx = SLMATH_SUB_PS( px, tri.v[2][0] );
+	const m128_t cpy = SLMATH_SUB_PS( py, tri.v[2][1] );
+	const m128_t cpz = SLMATH_SUB_PS( pz, tri.v[2][2] );
+
+	const m128_t d1 = dot4( abx, aby, abz, apx, apy, apz );
+	const m128_t d2 = dot4( acx, acy, acz, apx, apy, apz );
+	const m128_t d3 = dot4( abx, aby, abz, bpx, bpy, bpz );
+	const m128_t d4 = dot4( acx, acy, acz, bpx, bpy, bpz );
+	const m128_t d5 = dot4( abx, aby, abz, cpx, cpy, cpz );
+	const m128_t d6 = dot4( acx, acy, acz, cpx, cpy, cpz );
+	const m128_t va = SLMATH_SUB_PS( SLMATH_MUL_PS(d3,d6), SLMATH_MUL_PS(d5,d4) );
+	const m128_t vb = SLMATH_SUB_PS( SLMATH_MUL_PS(d5,d2), SLMATH_MUL_PS(d1,d6) );
+	const m128_t vc = SLMATH_SUB_PS( SLMATH_MUL_PS(d1,d4), SLMATH_MUL_PS(d3,d2) );
+	const m128_t d43 = SLMATH_SUB_PS( d4, d3 );
+	const m128_t d56 = SLMATH_SUB_PS( d5, d6 );
+
+	// start from inside face and override with regions in reverse order of the scalar version's tests
+	const m128_t denom = SLMATH_ADD_PS( SLMATH_ADD_PS(va,vb), vc );
+	m128_t s = safe_div4( vb, denom );
+	m128_t t = safe_div4( vc, denom );
+
+	const m128_t edge12 = SLMATH_AND_PS( SLMATH_CMPLE_PS(va,zero), SLMATH_AND_PS(SLMATH_CMPGE_PS(d43,zero), SLMATH_CMPGE_PS(d56,zero)) );
+	const m128_t t12 = safe_div4( d43, SLMATH_ADD_PS(d43,d56) );
+	s = SLMATH_SELECT_PS( edge12, SLMATH_SUB_PS(one,t12), s );
+	t = SLMATH_SELECT_PS( edge12, t12, t );
+
+	const m128_t edge02 = SLMATH_AND_PS( SLMATH_CMPLE_PS(vb,zero), SLMATH_AND_PS(SLMATH_CMPGE_PS(d2,zero), SLMATH_CMPLE_PS(d6,zero)) );
+	s = SLMATH_ANDNOT_PS( edge02, s );
+	t = SLMATH_SELECT_PS( edge02, safe_div4(d2,SLMATH_SUB_PS(d2,d6)), t );
+
+	const m128_t vertex2 = SLMATH_AND_PS( SLMATH_CMPGE_PS(d6,zero), SLMATH_CMPLE_PS(d5,d6) );
+	s = SLMATH_ANDNOT_PS( vertex2, s );
+	t = SLMATH_SELECT_PS( vertex2, one, t );
+
+	const m128_t edge01 = SLMATH_AND_PS( SLMATH_CMPLE_PS(vc,zero), SLMATH_AND_PS(SLMATH_CMPGE_PS(d1,zero), SLMATH_CMPLE_PS(d3,zero)) );
+	s = SLMATH_SELECT_PS( edge01, safe_div4(d1,SLMATH_SUB_PS(d1,d3)), s );
+	t = SLMATH_ANDNOT_PS( edge01, t );
+
+	const m128_t vertex1 = SLMATH_AND_PS( SLMATH_CMPGE_PS(d3,zero), SLMATH_CMPLE_PS(d4,d3) );
+	s = SLMATH_SELECT_PS( vertex1, one, s );
+	t = SLMATH_ANDNOT_PS( vertex1, t );
+
+	const m128_t vertex0 = SLMATH_AND_PS( SLMATH_CMPLE_PS(d1,zero), SLMATH_CMPLE_PS(d2,zero) );
+	s = SLMATH_ANDNOT_PS( vertex0, s );
+	t = SLMATH_ANDNOT_PS( vertex0, t );
+
+	// squared distance from p to v0 + ab*s + ac*t
+	const m128_t dx = SLMATH_SUB_PS( apx, SLMATH_ADD_PS(SLMATH_MUL_PS(abx,s), SLMATH_MUL_PS(acx,t)) );
+	const m128_t dy = SLMATH_SUB_PS( apy, SLMATH_ADD_PS(SLMATH_MUL_PS(aby,s), SLMATH_MUL_PS(acy,t)) );
+	const m128_t dz = SLMATH_SUB_PS( apz, SLMATH_ADD_PS(SLMATH_MUL_PS(abz,s), SLMATH_MUL_PS(acz,t)) );
+	SLMATH_STOREU_PS( dist2, dot4(dx,dy,dz,dx,dy,dz) );
+	SLMATH_STOREU_PS( u, s );
+	SLMATH_STOREU_PS( v, t );
+}
+
+bool closest_point_triangles( const vec3& p, const vec3* vertices, const unsigned int* indices, size_t n, float maxdist, closest_point_hit* hit )
+{
+	SLMATH_VEC_ASSERT( maxdist >= 0.f );
+
+	float best2 = maxdist*maxdist;
+	bool found = false;
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const vec3& v0 = vertices[indices ? indices[i*3] : i*3];
+		const vec3& v1 = vertices[indices ? indices[i*3+1] : i*3+1];
+		const vec3& v2 = vertices[indices ? indices[i*3+2] : i*3+2];
+		float u, v;
+		const vec3 c = closest_point_triangle( p, v0, v1, v2, &u, &v );
+		const vec3 d = c - p;
+		const float d2 = dot( d, d );
+		if ( d2 < best2 || (!found && d2 <= best2) )
+		{
+			best2 = d2;
+			found = true;
+			if (hit)
+			{
+				hit->point = c;
+				hit->u = u;
+				hit->v = v;
+				hit->index = i;
+			}
+		}
+	}
+	if ( found && hit )
+		hit->distance = sqrtf( best2 );
+	return found;
+}
+
+/** Clips interval [t0,t1] where the ray is inside a solid to the ray range, and stores the entry point. */
+static inline bool clip_ray_interval( const ray& r, float t0, float t1, float* t )
+{
+	if ( !(t0 <= t1) || t1 < r.tmin || t0 > r.tmax || r.tmin > r.tmax )
+		return false;
+	if (t)
+		*t = max( t0, r.tmin );
+	return true;
+}
+
+/**
+ * Finds interval [t0,t1] where point oc+d*t is inside sphere at origin with squared radius r2.
+ * Zero direction gives infinite interval if the point is inside.
+ */
+static bool origin_sphere_interval( const vec3& oc, const vec3& d, float r2, float* t0, float* t1 )
+{
+	const float a = dot( d, d );
+	const float c = dot( oc, oc ) - r2;
+	if ( !(a > 0.f) )
+	{
+		*t0 = -FLT_MAX;
+		*t1 = FLT_MAX;
+		return c <= 0.f;
+	}
+
+	// discriminant from the distance of the closest point to the center, avoids cancellation of b*b-a*c
+	const float b = dot( oc, d );
+	const vec3 l = oc - d*(b/a);
+	const float h = a * (r2 - dot(l,l));
+	if ( h < 0.f )
+		return false;
+	const float sq = sqrtf( h );
+	*t0 = (-b - sq) / a;
+	*t1 = (-b + sq) / a;
+	return true;
+}
+
+bool intersect_ray_sphere( const ray& r, const vec3& center, float radius, float* t )
+{
+	float t0, t1;
+	if ( !origin_sphere_interval(r.origin()-center, r.direction(), radius*radius, &t0, &t1) )
+		return false;
+	return clip_ray_interval( r, t0, t1, t );
+}
+
+bool intersect_ray_plane( const ray& r, const vec4& plane, float* t )
+{
+	const vec3 n( plane.x, plane.y, plane.z );
+	const float denom = dot( n, r.direction() );
+	if ( denom == 0.f )
+		return false;
+	const float s = -(dot(n,r.origin()) + plane.w) / denom;
+	return clip_ray_interval( r, s, s, t );
+}
+
+bool intersect_ray_capsule( const ray& r, const vec3& p0, const vec3& p1, float radius, float* t )
+{
+	// capsule is convex, so the interval inside it is the union of the intervals inside the end spheres and the cylinder
+	const vec3& o = r.origin();
+	const vec3& d = r.direction();
+	const float r2 = radius*radius;
+	float lo = FLT_MAX;
+	float hi = -FLT_MAX;
+	float t0, t1;
+	if ( origin_sphere_interval(o-p0, d, r2, &t0, &t1) )
+	{
+		lo = min( lo, t0 );
+		hi = max( hi, t1 );
+	}
+	if ( origin_sphere_interval(o-p1, d, r2, &t0, &t1) )
+	{
+		lo = min( lo, t0 );
+		hi = max( hi, t1 );
+	}
+
+	const vec3 ba = p1 - p0;
+	const vec3 oa = o - p0;
+	const float baba = dot( ba, ba );
+	if ( baba > 0.f )
+	{
+		// infinite cylinder is a sphere at origin after removing the components along the axis
+		const float bard = dot( ba, d );
+		const float baoa = dot( ba, oa );
+		if ( origin_sphere_interval(oa - ba*(baoa/baba), d - ba*(bard/baba), r2, &t0, &t1) )
+		{
+			// clip between the end planes
+			float y0 = -FLT_MAX;
+			float y1 = FLT_MAX;
+			if ( bard != 0.f )
+			{
+				const float ya = -baoa / bard;
+				const float yb = (baba - baoa) / bard;
+				y0 = min( ya, yb );
+				y1 = max( ya, yb );
+			}
+			else if ( baoa < 0.f || baoa > baba )
+			{
+				y1 = -FLT_MAX;
+			}
+			t0 = max( t0, y0 );
+			t1 = min( t1, y1 );
+			if ( t0 <= t1 )
+			{
+				lo = min( lo, t0 );
+				hi = max( hi, t1 );
+			}
+		}
+	}
+	return clip_ray_interval( r, lo, hi, t );
+}
+
+bool intersect_ray_obb( const ray& r, const mat4& invtm, const vec3& boxmin, const vec3& boxmax, float* t )
+{
+	const vec3 o = (invtm * vec4(r.origin(),1.f)).xyz();
+	const vec3 d = (invtm * vec4(r.direction(),0.f)).xyz();
+	float t0 = -FLT_MAX;
+	float t1 = FLT_MAX;
+	for ( size_t i = 0 ; i < 3 ; ++i )
+	{
+		// parallel to the slab, origin decides and the slab doesn't bound the interval
+		if ( d[i] == 0.f )
+		{
+			if ( o[i] < boxmin[i] || o[i] > boxmax[i] )
+				return false;
+			continue;
+		}
+		const float inv = 1.f/d[i];
+		const float ta = (boxmin[i] - o[i]) * inv;
+		const float tb = (boxmax[i] - o[i]) * inv;
+		t0 = max( t0, min(ta,tb) );
+		t1 = min( t1, max(ta,tb) );
+	}
+	return clip_ray_interval( r, t0, t1, t );
+}
+
+void ray4::set( size_t i, const vec3& origin, const vec3& direction, float tmin0, float tmax0 )
+{
+	assert( i < SIZE );
+	for ( size_t a = 0 ; a < 3 ; ++a )
+	{
+		reinterpret_cast<float*>(&o[a])[i] = origin[a];
+		reinterpret_cast<float*>(&d[a])[i] = direction[a];
+	}
+	reinterpret_cast<float*>(&tmin)[i] = tmin0;
+	reinterpret_cast<float*>(&tmax)[i] = tmax0;
+}
+
+void ray4::clear( size_t i )
+{
+	const vec3 zero( 0.f );
+	set( i, zero, zero, FLT_MAX, -FLT_MAX );
+}
+
+/** Clips intervals [t0,t1] where the rays are inside a solid to the ray ranges, stores the entry points and returns mask of hits. */
+static inline int clip_ray4_interval( const ray4& r, m128_t valid, m128_t t0, m128_t t1, float* t )
+{
+	valid = SLMATH_AND_PS( valid, SLMATH_CMPLE_PS(t0,t1) );
+	valid = SLMATH_AND_PS( valid, SLMATH_CMPGE_PS(t1,r.tmin) );
+	valid = SLMATH_AND_PS( valid, SLMATH_CMPLE_PS(t0,r.tmax) );
+	valid = SLMATH_AND_PS( valid, SLMATH_CMPLE_PS(r.tmin,r.tmax) );
+	SLMATH_STOREU_PS( t, SLMATH_MAX_PS(t0,r.tmin) );
+	return SLMATH_MOVEMASK_PS( valid );
+}
+
+/** SIMD version of origin_sphere_interval, returns mask of rays which have non-empty interval. */
+static inline m128_t origin_sphere_interval4( const m128_t* oc, const m128_t* d, m128_t r2, m128_t* t0, m128_t* t1 )
+{
+	const m128_t zero = SLMATH_SETZERO_PS();
+	const float maxf = FLT_MAX;
+	const m128_t inf = SLMATH_LOAD_PS1( &maxf );
+	const m128_t a = dot4( d[0], d[1], d[2], d[0], d[1], d[2] );
+	const m128_t b = dot4( oc[0], oc[1], oc[2], d[0], d[1], d[2] );
+	const m128_t c = SLMATH_SUB_PS( dot4(oc[0],oc[1],oc[2],oc[0],oc[1],oc[2]), r2 );
+	const m128_t moving = SLMATH_CMPGT_PS( a, zero );
+	const m128_t ba = SLMATH_DIV_PS( b, a );
+	const m128_t lx = SLMATH_SUB_PS( oc[0], SLMATH_MUL_PS(d[0],ba) );
+	const m128_t ly = SLMATH_SUB_PS( oc[1], SLMATH_MUL_PS(d[1],ba) );
+	const m128_t lz = SLMATH_SUB_PS( oc[2], SLMATH_MUL_PS(d[2],ba) );
+	const m128_t h = SLMATH_MUL_PS( a, SLMATH_SUB_PS(r2, dot4(lx,ly,lz,lx,ly,lz)) );
+	const m128_t sq = SLMATH_SQRT_PS( SLMATH_MAX_PS(h,zero) );
+	const m128_t nb = SLMATH_SUB_PS( zero, b );
+	*t0 = SLMATH_SELECT_PS( moving, SLMATH_DIV_PS(SLMATH_SUB_PS(nb,sq),a), SLMATH_SUB_PS(zero,inf) );
+	*t1 = SLMATH_SELECT_PS( moving, SLMATH_DIV_PS(SLMATH_ADD_PS(nb,sq),a), inf );
+	return SLMATH_OR_PS( SLMATH_AND_PS(moving, SLMATH_CMPGE_PS(h,zero)), SLMATH_ANDNOT_PS(moving, SLMATH_CMPLE_PS(c,zero)) );
+}
+
+int intersect_ray4_sphere( const ray4& r, const vec3& center, float radius, float* t )
+{
+	const float r2f = radius*radius;
+	const m128_t oc[3] = { SLMATH_SUB_PS(r.o[0],SLMATH_LOAD_PS1(&center.x)), SLMATH_SUB_PS(r.o[1],SLMATH_LOAD_PS1(&center.y)), SLMATH_SUB_PS(r.o[2],SLMATH_LOAD_PS1(&center.z)) };
+	m128_t t0, t1;
+	const m128_t valid = origin_sphere_interval4( oc, r.d, SLMATH_LOAD_PS1(&r2f), &t0, &t1 );
+	return clip_ray4_interval( r, valid, t0, t1, t );
+}
+
+int intersect_ray4_plane( const ray4& r, const vec4& plane, float* t )
+{
+	const m128_t nx = SLMATH_LOAD_PS1( &plane.x );
+	const m128_t ny = SLMATH_LOAD_PS1( &plane.y );
+	const m128_t nz = SLMATH_LOAD_PS1( &plane.z );
+	const m128_t denom = dot4( nx, ny, nz, r.d[0], r.d[1], r.d[2] );
+	const m128_t num = SLMATH_ADD_PS( dot4(nx,ny,nz,r.o[0],r.o[1],r.o[2]), SLMATH_LOAD_PS1(&plane.w) );
+	const m128_t valid = SLMATH_CMPNEQ_PS( denom, SLMATH_SETZERO_PS() );
+	const m128_t s = SLMATH_DIV_PS( SLMATH_SUB_PS(SLMATH_SETZERO_PS(),num), denom );
+	return clip_ray4_interval( r, valid, s, s, t );
+}
+
+int intersect_ray4_capsule( const ray4& r, const vec3& p0, const vec3& p1, float radius, float* t )
+{
+	const float r2f = radius*radius;
+	const float maxf = FLT_MAX;
+	const m128_t r2 = SLMATH_LOAD_PS1( &r2f );
+	const m128_t inf = SLMATH_LOAD_PS1( &maxf );
+	const m128_t zero = SLMATH_SETZERO_PS();
+	m128_t lo = inf;
+	m128_t hi = SLMATH_SUB_PS( zero, inf );
+	m128_t t0, t1;
+
+	const m128_t oa[3] = { SLMATH_SUB_PS(r.o[0],SLMATH_LOAD_PS1(&p0.x)), SLMATH_SUB_PS(r.o[1],SLMATH_LOAD_PS1(&p0.y)), SLMATH_SUB_PS(r.o[2],SLMATH_LOAD_PS1(&p0.z)) };
+	m128_t valid = origin_sphere_interval4( oa, r.d, r2, &t0, &t1 );
+	lo = SLMATH_SELECT_PS( valid, SLMATH_MIN_PS(lo,t0), lo );
+	hi = SLMATH_SELECT_PS( valid, SLMATH_MAX_PS(hi,t1), hi );
+
+	const m128_t ob[3] = { SLMATH_SUB_PS(r.o[0],SLMATH_LOAD_PS1(&p1.x)), SLMATH_SUB_PS(r.o[1],SLMATH_LOAD_PS1(&p1.y)), SLMATH_SUB_PS(r.o[2],SLMATH_LOAD_PS1(&p1.z)) };
+	valid = origin_sphere_interval4( ob, r.d, r2, &t0, &t1 );
+	lo = SLMATH_SELECT_PS( valid, SLMATH_MIN_PS(lo,t0), lo );
+	hi = SLMATH_SELECT_PS( valid, SLMATH_MAX_PS(hi,t1), hi );
+
+	const vec3 ba = p1 - p0;
+	const float babaf = dot( ba, ba );
+	if ( babaf > 0.f )
+	{
+		const m128_t bax = SLMATH_LOAD_PS1( &ba.x );
+		const m128_t bay = SLMATH_LOAD_PS1( &ba.y );
+		const m128_t baz = SLMATH_LOAD_PS1( &ba.z );
+		const m128_t baba = SLMATH_LOAD_PS1( &babaf );
+		const m128_t bard = dot4( bax, bay, baz, r.d[0], r.d[1], r.d[2] );
+		const m128_t baoa = dot4( bax, bay, baz, oa[0], oa[1], oa[2] );
+		const m128_t ko = SLMATH_DIV_PS( baoa, baba );
+		const m128_t kd = SLMATH_DIV_PS( bard, baba );
+		const m128_t op[3] = { SLMATH_SUB_PS(oa[0],SLMATH_MUL_PS(bax,ko)), SLMATH_SUB_PS(oa[1],SLMATH_MUL_PS(bay,ko)), SLMATH_SUB_PS(oa[2],SLMATH_MUL_PS(baz,ko)) };
+		const m128_t dp[3] = { SLMATH_SUB_PS(r.d[0],SLMATH_MUL_PS(bax,kd)), SLMATH_SUB_PS(r.d[1],SLMATH_MUL_PS(bay,kd)), SLMATH_SUB_PS(r.d[2],SLMATH_MUL_PS(baz,kd)) };
+		valid = origin_sphere_interval4( op, dp, r2, &t0, &t1 );
+
+		// clip between the end planes
+		const m128_t axial = SLMATH_CMPNEQ_PS( bard, zero );
+		const m128_t ya = SLMATH_DIV_PS( SLMATH_SUB_PS(zero,baoa), bard );
+		const m128_t yb = SLMATH_DIV_PS( SLMATH_SUB_PS(baba,baoa), bard );
+		const m128_t between = SLMATH_AND_PS( SLMATH_CMPGE_PS(baoa,zero), SLMATH_CMPLE_PS(baoa,baba) );
+		valid = SLMATH_AND_PS( valid, SLMATH_OR_PS(axial,between) );
+		t0 = SLMATH_SELECT_PS( axial, SLMATH_MAX_PS(t0,SLMATH_MIN_PS(ya,yb)), t0 );
+		t1 = SLMATH_SELECT_PS( axial, SLMATH_MIN_PS(t1,SLMATH_MAX_PS(ya,yb)), t1 );
+		valid = SLMATH_AND_PS( valid, SLMATH_CMPLE_PS(t0,t1) );
+		lo = SLMATH_SELECT_PS( valid, SLMATH_MIN_PS(lo,t0), lo );
+		hi = SLMATH_SELECT_PS( valid, SLMATH_MAX_PS(hi,t1), hi );
+	}
+	return clip_ray4_interval( r, SLMATH_CMPLE_PS(lo,hi), lo, hi, t );
+}
+
+int intersect_ray4_obb( const ray4& r, const mat4& invtm, const vec3& boxmin, const vec3& boxmax, float* t )
+{
+	const float maxf = FLT_MAX;
+	const m128_t inf = SLMATH_LOAD_PS1( &maxf );
+	const m128_t zero = SLMATH_SETZERO_PS();
+	m128_t t0 = SLMATH_SUB_PS( zero, inf );
+	m128_t t1 = inf;
+	m128_t valid = SLMATH_CMPEQ_PS( zero, zero );
+	for ( size_t i = 0 ; i < 3 ; ++i )
+	{
+		// row i of the transform applied to origins and directions
+		const m128_t m0 = SLMATH_LOAD_PS1( &invtm[0][i] );
+		const m128_t m1 = SLMATH_LOAD_PS1( &invtm[1][i] );
+		const m128_t m2 = SLMATH_LOAD_PS1( &invtm[2][i] );
+		const m128_t o = SLMATH_ADD_PS( dot4(m0,m1,m2,r.o[0],r.o[1],r.o[2]), SLMATH_LOAD_PS1(&invtm[3][i]) );
+		const m128_t d = dot4( m0, m1, m2, r.d[0], r.d[1], r.d[2] );
+
+		// rays parallel to the slab hit only if the origin is inside it, and the slab doesn't bound their interval
+		const float onef = 1.f;
+		const m128_t one = SLMATH_LOAD_PS1( &onef );
+		const m128_t bmin = SLMATH_LOAD_PS1( &boxmin[i] );
+		const m128_t bmax = SLMATH_LOAD_PS1( &boxmax[i] );
+		const m128_t nz = SLMATH_CMPNEQ_PS( d, zero );
+		const m128_t inside = SLMATH_AND_PS( SLMATH_CMPGE_PS(o,bmin), SLMATH_CMPLE_PS(o,bmax) );
+		valid = SLMATH_AND_PS( valid, SLMATH_OR_PS(nz,inside) );
+		const m128_t inv = SLMATH_DIV_PS( one, SLMATH_SELECT_PS(nz,d,one) );
+		const m128_t ta = SLMATH_MUL_PS( SLMATH_SUB_PS(bmin,o), inv );
+		const m128_t tb = SLMATH_MUL_PS( SLMATH_SUB_PS(bmax,o), inv );
+		t0 = SLMATH_SELECT_PS( nz, SLMATH_MAX_PS(t0,SLMATH_MIN_PS(ta,tb)), t0 );
+		t1 = SLMATH_SELECT_PS( nz, SLMATH_MIN_PS(t1,SLMATH_MAX_PS(ta,tb)), t1 );
+	}
+	return clip_ray4_interval( r, valid, t0, t1, t );
+}
+
 SLMATH_END()
 
 // This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,315 @@
+#include <slm/kd_tree.h>
+#include <slm/morton.h>
+
+SLMATH_BEGIN()
+
+/** Range of points, either waiting to be split or to be visited in a query. */
+class kd_tree_range
+{
+public:
+	size_t	begin;
+	size_t	end;
+	float	dist2;
+};
+
+/** Swaps points i and j together with their indices. */
+static inline void swap_points( vec3* points, size_t* indices, size_t i, size_t j )
+{
+	const vec3 p = points[i]; points[i] = points[j]; points[j] = p;
+	const size_t k = indices[i]; indices[i] = indices[j]; indices[j] = k;
+}
+
+/** Reorders points[begin..end) so that the nth point has its sorted position along the axis, smaller before and larger after it. */
+static void select_point( vec3* points, size_t* indices, size_t begin, size_t end, size_t nth, int axis )
+{
+	while ( end-begin > 1 )
+	{
+		// median of three as pivot, partitioned with Lomuto scheme
+		const size_t mid = begin + (end-begin)/2;
+		if ( points[mid][axis] < points[begin][axis] )
+			swap_points( points, indices, mid, begin );
+		if ( points[end-1][axis] < points[begin][axis] )
+			swap_points( points, indices, end-1, begin );
+		if ( points[end-1][axis] < points[mid][axis] )
+			swap_points( points, indices, end-1, mid );
+		swap_points( points, indices, mid, end-1 );
+		const float pivot = points[end-1][axis];
+
+		size_t store = begin;
+		for ( size_t i = begin ; i < end-1 ; ++i )
+		{
+			if ( points[i][axis] < pivot )
+				swap_points( points, indices, i, store++ );
+		}
+		swap_points( points, indices, store, end-1 );
+
+		if ( nth == store )
+			return;
+		if ( nth < store )
+			end = store;
+		else
+			begin = store+1;
+	}
+}
+
+kd_tree::kd_tree()
+{
+}
+
+void kd_tree::build( const vec3* points, size_t n )
+{
+	m_points.resize( n );
+	m_indices.resize( n );
+	m_axis.resize( n );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		m_points[i] = points[i];
+		m_indices[i] = i;
+		m_axis[i] = 0;
+	}
+
+	kd_tree_range stack[STACK_SIZE];
+	size_t sp = 0;
+	stack[sp].begin = 0;
+	stack[sp].end = n;
+	stack[sp++].dist2 = 0.f;
+	while ( sp > 0 )
+	{
+		const kd_tree_range r = stack[--sp];
+		if ( r.end-r.begin <= LEAF_SIZE )
+			continue;
+
+		// split at the median along the axis of largest extent
+		vec3 bmin = m_points[r.begin];
+		vec3 bmax = bmin;
+		for ( size_t i = r.begin+1 ; i < r.end ; ++i )
+		{
+			bmin = min( bmin, m_points[i] );
+			bmax = max( bmax, m_points[i] );
+		}
+		const vec3 ext = bmax - bmin;
+		const int axis = (ext.x > ext.y ? (ext.x > ext.z ? 0 : 2) : (ext.y > ext.z ? 1 : 2));
+		const size_t mid = r.begin + (r.end-r.begin)/2;
+		select_point( m_points.begin(), m_indices.begin(), r.begin, r.end, mid, axis );
+		m_axis[mid] = (unsigned char)axis;
+
+		SLMATH_VEC_ASSERT( sp+2 <= STACK_SIZE );
+		stack[sp].begin = r.begin;
+		stack[sp].end = mid;
+		stack[sp++].dist2 = 0.f;
+		stack[sp].begin = mid+1;
+		stack[sp].end = r.end;
+		stack[sp++].dist2 = 0.f;
+	}
+}
+
+size_t kd_tree::query_radius( const vec3& p, float radius, size_t* out, size_t maxout ) const
+{
+	SLMATH_VEC_ASSERT( radius >= 0.f );
+
+	const float r2 = radius*radius;
+	size_t count = 0;
+
+	kd_tree_range stack[STACK_SIZE];
+	size_t sp = 0;
+	stack[sp].begin = 0;
+	stack[sp].end = m_points.size();
+	stack[sp++].dist2 = 0.f;
+	while ( sp > 0 )
+	{
+		const kd_tree_range r = stack[--sp];
+		if ( r.dist2 > r2 )
+			continue;
+
+		if ( r.end-r.begin <= LEAF_SIZE )
+		{
+			for ( size_t j = r.begin ; j < r.end ; ++j )
+			{
+				const vec3 d = m_points[j] - p;
+				if ( dot(d,d) <= r2 )
+				{
+					if ( count < maxout )
+						out[count] = m_indices[j];
+					++count;
+				}
+			}
+			continue;
+		}
+
+		const size_t mid = r.begin + (r.end-r.begin)/2;
+		const vec3 d = m_points[mid] - p;
+		if ( dot(d,d) <= r2 )
+		{
+			if ( count < maxout )
+				out[count] = m_indices[mid];
+			++count;
+		}
+
+		// distance to the split plane bounds distance to the far side
+		const float diff = p[m_axis[mid]] - m_points[mid][m_axis[mid]];
+		const float far2 = max( r.dist2, diff*diff );
+		SLMATH_VEC_ASSERT( sp+2 <= STACK_SIZE );
+		stack[sp].begin = (diff < 0.f ? mid+1 : r.begin);
+		stack[sp].end = (diff < 0.f ? r.end : mid);
+		stack[sp++].dist2 = far2;
+		stack[sp].begin = (diff < 0.f ? r.begin : mid+1);
+		stack[sp].end = (diff < 0.f ? mid : r.end);
+		stack[sp++].dist2 = r.dist2;
+	}
+	return count;
+}
+
+/** Inserts point to candidate list of k nearest points sorted by squared distance, if it is closer than the current candidates. */
+static inline void insert_nearest( size_t index, float d2, size_t k, size_t* count, size_t* out, float* dist2 )
+{
+	if ( *count == k && d2 >= dist2[k-1] )
+		return;
+
+	size_t i = (*count < k ? (*count)++ : k-1);
+	for ( ; i > 0 && dist2[i-1] > d2 ; --i )
+	{
+		dist2[i] = dist2[i-1];
+		out[i] = out[i-1];
+	}
+	dist2[i] = d2;
+	out[i] = index;
+}
+
+/** Largest k for which query_nearest keeps squared distances on the stack when they are not returned. */
+static const size_t KD_TREE_STACK_K = 64;
+
+size_t kd_tree::query_nearest( const vec3& p, size_t k, size_t* out, float* outdist ) const
+{
+	if ( outdist )
+	{
+		const size_t count = query_nearest_dist2( p, k, out, outdist );
+		for ( size_t i = 0 ; i < count ; ++i )
+			outdist[i] = sqrtf( outdist[i] );
+		return count;
+	}
+
+	if ( k <= KD_TREE_STACK_K )
+	{
+		float dist2[KD_TREE_STACK_K];
+		return query_nearest_dist2( p, k, out, dist2 );
+	}
+	vector_simd<float> dist2;
+	dist2.resize( k );
+	return query_nearest_dist2( p, k, out, dist2.begin() );
+}
+
+size_t kd_tree::query_nearest_dist2( const vec3& p, size_t k, size_t* out, float* dist2 ) const
+{
+	const size_t n = m_points.size();
+	if ( k > n )
+		k = n;
+	if ( 0 == k )
+		return 0;
+
+	// out and dist2 hold best candidates so far sorted by squared distance
+	size_t count = 0;
+
+	kd_tree_range stack[STACK_SIZE];
+	size_t sp = 0;
+	stack[sp].begin = 0;
+	stack[sp].end = n;
+	stack[sp++].dist2 = 0.f;
+	while ( sp > 0 )
+	{
+		const kd_tree_range r = stack[--sp];
+		if ( count == k && r.dist2 >= dist2[k-1] )
+			continue;
+
+		if ( r.end-r.begin <= LEAF_SIZE )
+		{
+			for ( size_t j = r.begin ; j < r.end ; ++j )
+			{
+				const vec3 d = m_points[j] - p;
+				insert_nearest( m_indices[j], dot(d,d), k, &count, out, dist2 );
+			}
+			continue;
+		}
+
+		const size_t mid = r.begin + (r.end-r.begin)/2;
+		const vec3 d = m_points[mid] - p;
+		insert_nearest( m_indices[mid], dot(d,d), k, &count, out, dist2 );
+
+		// near side is popped first, so the far side is usually culled
+		const float diff = p[m_axis[mid]] - m_points[mid][m_axis[mid]];
+		const float far2 = max( r.dist2, diff*diff );
+		SLMATH_VEC_ASSERT( sp+2 <= STACK_SIZE );
+		stack[sp].begin = (diff < 0.f ? mid+1 : r.begin);
+		stack[sp].end = (diff < 0.f ? r.end : mid);
+		stack[sp++].dist2 = far2;
+		stack[sp].begin = (diff < 0.f ? r.begin : mid+1);
+		stack[sp].end = (diff < 0.f ? mid : r.end);
+		stack[sp++].dist2 = r.dist2;
+	}
+	return count;
+}
+
+/** Stores to order indices of queries[first..first+count) sorted by Morton code within their bounds. */
+static void morton_query_order( const vec3* queries, size_t first, size_t count, vector_simd<unsigned int>* order )
+{
+	order->resize( count );
+	if ( 0 == count )
+		return;
+
+	vec3 bmin = queries[first];
+	vec3 bmax = bmin;
+	for ( size_t i = first+1 ; i < first+count ; ++i )
+	{
+		bmin = min( bmin, queries[i] );
+		bmax = max( bmax, queries[i] );
+	}
+
+	vector_simd<unsigned int> codes;
+	vector_simd<unsigned int> tempcodes;
+	vector_simd<unsigned int> temporder;
+	codes.resize( count );
+	tempcodes.resize( count );
+	temporder.resize( count );
+	morton_codes30( queries+first, count, bmin, bmax, codes.begin() );
+	for ( size_t i = 0 ; i < count ; ++i )
+		(*order)[i] = (unsigned int)(first+i);
+	radix_sort( codes.begin(), order->begin(), count, tempcodes.begin(), temporder.begin() );
+}
+
+void kd_tree::query_nearest_batch( const vec3* queries, size_t first, size_t count, size_t k, size_t* out, float* outdist ) const
+{
+	vector_simd<unsigned int> order;
+	morton_query_order( queries, first, count, &order );
+	if ( outdist )
+	{
+		for ( size_t i = 0 ; i < count ; ++i )
+		{
+			const size_t q = order[i];
+			query_nearest( queries[q], k, out + q*k, outdist + q*k );
+		}
+		return;
+	}
+
+	// squared distances are not returned, so all queries share one scratch array
+	vector_simd<float> dist2;
+	dist2.resize( k );
+	for ( size_t i = 0 ; i < count ; ++i )
+	{
+		const size_t q = order[i];
+		query_nearest_dist2( queries[q], k, out + q*k, dist2.begin() );
+	}
+}
+
+void kd_tree::query_radius_batch( const vec3* queries, size_t first, size_t count, float radius, size_t maxout, size_t* out, size_t* counts ) const
+{
+	vector_simd<unsigned int> order;
+	morton_query_order( queries, first, count, &order );
+	for ( size_t i = 0 ; i < count ; ++i )
+	{
+		const size_t q = order[i];
+		counts[q] = query_radius( queries[q], radius, out + q*maxout, maxout );
+	}
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,318 @@
+#include <slm/loose_octree.h>
+#include <slm/intersect_stats.h>
+
+SLMATH_BEGIN()
+
+/** Cell of the octree, as level and coordinates within the level. */
+class loose_octree_cell
+{
+public:
+	unsigned int	level;
+	unsigned int	x;
+	unsigned int	y;
+	unsigned int	z;
+};
+
+/** Box test of frustum queries. */
+class loose_octree_frustum_test
+{
+public:
+	const frustum*	f;
+
+	bool operator()( const vec3& boxmin, const vec3& boxmax ) const		{return intersect_frustum_box( *f, boxmin, boxmax );}
+};
+
+/** Box test of ray queries. */
+class loose_octree_ray_test
+{
+public:
+	const ray*		r;
+
+	bool operator()( const vec3& boxmin, const vec3& boxmax ) const		{return intersect_ray_box( *r, boxmin, boxmax, 0 );}
+};
+
+/** Box test of sphere queries. */
+class loose_octree_sphere_test
+{
+public:
+	vec3			center;
+	float			radius2;
+
+	bool operator()( const vec3& boxmin, const vec3& boxmax ) const
+	{
+		const vec3 d = center - clamp( center, boxmin, boxmax );
+		return dot(d,d) <= radius2;
+	}
+};
+
+loose_octree::loose_octree( const vec3& boundsmin, float size, size_t depth ) :
+	m_boundsmin( boundsmin ),
+	m_size( size ),
+	m_depth( depth ),
+	m_count( 0 )
+{
+	SLMATH_VEC_ASSERT( size > FLT_MIN );
+	SLMATH_VEC_ASSERT( depth >= 1 && depth <= MAX_DEPTH );
+
+	size_t offset = 0;
+	for ( size_t level = 0 ; level < depth ; ++level )
+	{
+		m_leveloffset[level] = offset;
+		offset += size_t(1) << (3*level);
+	}
+	m_leveloffset[depth] = offset;
+
+	m_head.resize( offset );
+	m_subtree.resize( offset );
+	for ( size_t i = 0 ; i < offset ; ++i )
+	{
+		m_head[i] = NONE;
+		m_subtree[i] = 0;
+	}
+}
+
+size_t loose_octree::find_cell( const vec3& boxmin, const vec3& boxmax ) const
+{
+	// objects centered outside the root don't fit in any cell
+	const vec3 center = (boxmin + boxmax)*.5f - m_boundsmin;
+	if ( center.x < 0.f || center.y < 0.f || center.z < 0.f || center.x >= m_size || center.y >= m_size || center.z >= m_size )
+		return 0;
+
+	// deepest level where the object is at most as large as the cell, so fits in the loose bounds
+	const vec3 ext = boxmax - boxmin;
+	const float extent = max( ext.x, max(ext.y,ext.z) );
+	size_t level = m_depth-1;
+	if ( extent > 0.f )
+	{
+		int e;
+		frexpf( m_size/extent, &e );
+		if ( e-1 < int(level) )
+			level = (e-1 < 0 ? 0 : size_t(e-1));
+	}
+
+	const size_t n = size_t(1) << level;
+	const float inv = float(n) / m_size;
+	const size_t x = min( size_t(center.x*inv), n-1 );
+	const size_t y = min( size_t(center.y*inv), n-1 );
+	const size_t z = min( size_t(center.z*inv), n-1 );
+	return m_leveloffset[level] + (z*n + y)*n + x;
+}
+
+/** Returns level and coordinates of the cell index. */
+static loose_octree_cell get_cell( const size_t* leveloffset, size_t depth, size_t cell )
+{
+	size_t level = 0;
+	while ( level+1 < depth && cell >= leveloffset[level+1] )
+		++level;
+
+	const size_t n = size_t(1) << level;
+	const size_t i = cell - leveloffset[level];
+	loose_octree_cell c;
+	c.level = (unsigned int)level;
+	c.x = (unsigned int)(i % n);
+	c.y = (unsigned int)((i / n) % n);
+	c.z = (unsigned int)(i / (n*n));
+	return c;
+}
+
+bool loose_octree::fits_cell( size_t cell, const vec3& boxmin, const vec3& boxmax ) const
+{
+	// object fits if it is at most as large as the cell and inside the loose bounds
+	const loose_octree_cell c = get_cell( m_leveloffset, m_depth, cell );
+	const float s = m_size / float(size_t(1) << c.level);
+	const vec3 ext = boxmax - boxmin;
+	if ( max(ext.x, max(ext.y,ext.z)) > s )
+		return false;
+
+	const vec3 cellmin = m_boundsmin + vec3( float(c.x), float(c.y), float(c.z) )*s;
+	const vec3 loosemin = cellmin - vec3(s*.5f);
+	const vec3 loosemax = cellmin + vec3(s*1.5f);
+	return boxmin.x >= loosemin.x && boxmin.y >= loosemin.y && boxmin.z >= loosemin.z &&
+		boxmax.x <= loosemax.x && boxmax.y <= loosemax.y && boxmax.z <= loosemax.z;
+}
+
+/** Adds delta to object counts of the cell and all its parents. */
+static void add_subtree_count( unsigned int* subtree, const size_t* leveloffset, size_t depth, size_t cell, int delta )
+{
+	const loose_octree_cell c = get_cell( leveloffset, depth, cell );
+	size_t level = c.level;
+	size_t x = c.x;
+	size_t y = c.y;
+	size_t z = c.z;
+	for ( ;; )
+	{
+		const size_t ln = size_t(1) << level;
+		subtree[leveloffset[level] + (z*ln + y)*ln + x] += delta;
+		if ( 0 == level )
+			break;
+		--level;
+		x >>= 1;
+		y >>= 1;
+		z >>= 1;
+	}
+}
+
+void loose_octree::link( size_t id, size_t cell )
+{
+	const unsigned int head = m_head[cell];
+	m_cell[id] = (unsigned int)cell;
+	m_prev[id] = NONE;
+	m_next[id] = head;
+	if ( head != unsigned(NONE) )
+		m_prev[head] = (unsigned int)id;
+	m_head[cell] = (unsigned int)id;
+	add_subtree_count( m_subtree.begin(), m_leveloffset, m_depth, cell, 1 );
+}
+
+void loose_octree::unlink( size_t id )
+{
+	const unsigned int cell = m_cell[id];
+	const unsigned int prev = m_prev[id];
+	const unsigned int next = m_next[id];
+	if ( prev != unsigned(NONE) )
+		m_next[prev] = next;
+	else
+		m_head[cell] = next;
+	if ( next != unsigned(NONE) )
+		m_prev[next] = prev;
+	m_cell[id] = NONE;
+	add_subtree_count( m_subtree.begin(), m_leveloffset, m_depth, cell, -1 );
+}
+
+void loose_octree::insert( size_t id, const vec3& boxmin, const vec3& boxmax )
+{
+	SLMATH_VEC_ASSERT( !contains(id) );
+	SLMATH_VEC_ASSERT( id < NONE );
+
+	const size_t n = m_cell.size();
+	if ( id >= n )
+	{
+		m_cell.resize( id+1 );
+		m_next.resize( id+1 );
+		m_prev.resize( id+1 );
+		m_boxmin.resize( id+1 );
+		m_boxmax.resize( id+1 );
+		for ( size_t i = n ; i <= id ; ++i )
+			m_cell[i] = NONE;
+	}
+
+	m_boxmin[id] = boxmin;
+	m_boxmax[id] = boxmax;
+	link( id, find_cell(boxmin,boxmax) );
+	++m_count;
+}
+
+void loose_octree::update( size_t id, const vec3& boxmin, const vec3& boxmax )
+{
+	SLMATH_VEC_ASSERT( contains(id) );
+
+	m_boxmin[id] = boxmin;
+	m_boxmax[id] = boxmax;
+	if ( fits_cell(m_cell[id], boxmin, boxmax) )
+		return;
+
+	const size_t cell = find_cell( boxmin, boxmax );
+	if ( cell != m_cell[id] )
+	{
+		unlink( id );
+		link( id, cell );
+	}
+}
+
+void loose_octree::remove( size_t id )
+{
+	SLMATH_VEC_ASSERT( contains(id) );
+
+	unlink( id );
+	--m_count;
+}
+
+template <class T> size_t loose_octree::query( const T& test, size_t* out, size_t maxout ) const
+{
+	size_t count = 0;
+	loose_octree_cell stack[7*MAX_DEPTH+1];
+	size_t sp = 0;
+	stack[sp].level = stack[sp].x = stack[sp].y = stack[sp].z = 0;
+	++sp;
+	SLMATH_STATS_ADD( queries, 1 );
+
+	while ( sp > 0 )
+	{
+		const loose_octree_cell c = stack[--sp];
+		const size_t n = size_t(1) << c.level;
+		const size_t cell = m_leveloffset[c.level] + (c.z*n + c.y)*n + c.x;
+
+		// root contains also the objects outside it, so it is never culled
+		if ( c.level > 0 )
+		{
+			const float s = m_size / float(n);
+			const vec3 cellmin = m_boundsmin + vec3( float(c.x), float(c.y), float(c.z) )*s;
+			SLMATH_STATS_ADD( box_tests, 1 );
+			if ( !test(cellmin - vec3(s*.5f), cellmin + vec3(s*1.5f)) )
+			{
+				SLMATH_STATS_ADD( early_outs, 1 );
+				continue;
+			}
+		}
+
+		SLMATH_STATS_ADD( node_visits, 1 );
+
+		for ( unsigned int id = m_head[cell] ; id != unsigned(NONE) ; id = m_next[id] )
+		{
+			SLMATH_STATS_ADD( box_tests, 1 );
+			if ( test(m_boxmin[id], m_boxmax[id]) )
+			{
+				if ( count < maxout )
+					out[count] = id;
+				++count;
+			}
+		}
+
+		if ( c.level+1 < m_depth )
+		{
+			const size_t cn = n*2;
+			for ( unsigned int k = 0 ; k < 8 ; ++k )
+			{
+				loose_octree_cell child;
+				child.level = c.level+1;
+				child.x = c.x*2 + (k&1);
+				child.y = c.y*2 + ((k>>1)&1);
+				child.z = c.z*2 + (k>>2);
+				if ( 0 != m_subtree[m_leveloffset[child.level] + (child.z*cn + child.y)*cn + child.x] )
+				{
+					SLMATH_VEC_ASSERT( sp < sizeof(stack)/sizeof(stack[0]) );
+					stack[sp++] = child;
+				}
+			}
+		}
+	}
+	return count;
+}
+
+size_t loose_octree::query_frustum( const frustum& f, size_t* out, size_t maxout ) const
+{
+	loose_octree_frustum_test test;
+	test.f = &f;
+	return query( test, out, maxout );
+}
+
+size_t loose_octree::query_ray( const ray& r, size_t* out, size_t maxout ) const
+{
+	loose_octree_ray_test test;
+	test.r = &r;
+	return query( test, out, maxout );
+}
+
+size_t loose_octree::query_sphere( const vec3& center, float radius, size_t* out, size_t maxout ) const
+{
+	SLMATH_VEC_ASSERT( radius >= 0.f );
+
+	loose_octree_sphere_test test;
+	test.center = center;
+	test.radius2 = radius*radius;
+	return query( test, out, maxout );
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,201 @@
+#include <slm/mat3.h>
+#include <slm/quat.h>
+
+SLMATH_BEGIN()
+
+mat3::mat3( float d )
+{
+	store( 0, SLMATH_SET_PS( d, 0.f, 0.f, 0.f ) );
+	store( 1, SLMATH_SET_PS( 0.f, d, 0.f, 0.f ) );
+	store( 2, SLMATH_SET_PS( 0.f, 0.f, d, 0.f ) );
+}
+
+mat3::mat3( const mat4& m )
+{
+	const float* const p = m.begin();
+	store( 0, SLMATH_SET_PS( p[0], p[1], p[2], 0.f ) );
+	store( 1, SLMATH_SET_PS( p[4], p[5], p[6], 0.f ) );
+	store( 2, SLMATH_SET_PS( p[8], p[9], p[10], 0.f ) );
+}
+
+mat3::mat3( const quat& q )
+{
+	const float sqw = q.w*q.w;
+	const float sqx = q.x*q.x;
+	const float sqy = q.y*q.y;
+	const float sqz = q.z*q.z;
+	const float qlen = sqx + sqy + sqz + sqw;
+
+	SLMATH_VEC_ASSERT( qlen > FLT_MIN );
+	const float invs = 1.f / qlen; // only needed if not normalized
+	const float xy = q.x*q.y;
+	const float zw = q.z*q.w;
+	const float xz = q.x*q.z;
+	const float yw = q.y*q.w;
+	const float yz = q.y*q.z;
+	const float xw = q.x*q.w;
+
+	store( 0, SLMATH_SET_PS( (sqx-sqy-sqz+sqw)*invs, 2.f*(xy+zw)*invs, 2.f*(xz-yw)*invs, 0.f ) );
+	store( 1, SLMATH_SET_PS( 2.f*(xy-zw)*invs, (-sqx+sqy-sqz+sqw)*invs, 2.f*(yz+xw)*invs, 0.f ) );
+	store( 2, SLMATH_SET_PS( 2.f*(xz+yw)*invs, 2.f*(yz-xw)*invs, (-sqx-sqy+sqz+sqw)*invs, 0.f ) );
+}
+
+mat3::mat3( float a, const vec3& v )
+{
+	SLMATH_VEC_ASSERT( length(v) > FLT_MIN );
+
+	float s, c;
+	sincos( a, &s, &c );
+
+	const float		t = 1.f - c;
+	const vec3		n = normalize( v );
+	const float		x = n.x;
+	const float		y = n.y;
+	const float		z = n.z;
+
+	store( 0, SLMATH_SET_PS( t*x*x + c, t*x*y + z*s, t*x*z - y*s, 0.f ) );
+	store( 1, SLMATH_SET_PS( t*x*y - z*s, t*y*y + c, t*y*z + x*s, 0.f ) );
+	store( 2, SLMATH_SET_PS( t*x*z + y*s, t*y*z - x*s, t*z*z + c, 0.f ) );
+}
+
+mat3::mat3( const vec3& c0, const vec3& c1, const vec3& c2 )
+{
+	set( 0, c0 );
+	set( 1, c1 );
+	set( 2, c2 );
+}
+
+mat3& mat3::operator+=( const mat3& o )
+{
+	store( 0, SLMATH_ADD_PS( load(0), o.load(0) ) );
+	store( 1, SLMATH_ADD_PS( load(1), o.load(1) ) );
+	store( 2, SLMATH_ADD_PS( load(2), o.load(2) ) );
+	return *this;
+}
+
+mat3& mat3::operator-=( const mat3& o )
+{
+	store( 0, SLMATH_SUB_PS( load(0), o.load(0) ) );
+	store( 1, SLMATH_SUB_PS( load(1), o.load(1) ) );
+	store( 2, SLMATH_SUB_PS( load(2), o.load(2) ) );
+	return *this;
+}
+
+mat3& mat3::operator*=( float s )
+{
+	m128_t s128 = SLMATH_LOAD_PS1(&s);
+	store( 0, SLMATH_MUL_PS( load(0), s128 ) );
+	store( 1, SLMATH_MUL_PS( load(1), s128 ) );
+	store( 2, SLMATH_MUL_PS( load(2), s128 ) );
+	return *this;
+}
+
+mat3& mat3::operator*=( const mat3& o )
+{
+	return *this = *this * o;
+}
+
+bool mat3::operator==( const mat3& o ) const
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+	SLMATH_VEC_ASSERT( check(o) );
+
+	for ( size_t i = 0 ; i < 3 ; ++i )
+		if ( get(i) != o[i] )
+			return false;
+	return true;
+}
+
+bool mat3::operator!=( const mat3& o ) const
+{
+	return !(*this == o);
+}
+
+mat3 mat3::operator+( const mat3& o ) const
+{
+	mat3 res;
+	res.store( 0, SLMATH_ADD_PS( load(0), o.load(0) ) );
+	res.store( 1, SLMATH_ADD_PS( load(1), o.load(1) ) );
+	res.store( 2, SLMATH_ADD_PS( load(2), o.load(2) ) );
+	return res;
+}
+
+mat3 mat3::operator-( const mat3& o ) const
+{
+	mat3 res;
+	res.store( 0, SLMATH_SUB_PS( load(0), o.load(0) ) );
+	res.store( 1, SLMATH_SUB_PS( load(1), o.load(1) ) );
+	res.store( 2, SLMATH_SUB_PS( load(2), o.load(2) ) );
+	return res;
+}
+
+mat3 mat3::operator-() const
+{
+	mat3 res;
+	m128_t zero = SLMATH_SETZERO_PS();
+	res.store( 0, SLMATH_SUB_PS( zero, load(0) ) );
+	res.store( 1, SLMATH_SUB_PS( zero, load(1) ) );
+	res.store( 2, SLMATH_SUB_PS( zero, load(2) ) );
+	return res;
+}
+
+mat3 mat3::operator*( float s ) const
+{
+	mat3 res;
+	m128_t s128 = SLMATH_LOAD_PS1(&s);
+	res.store( 0, SLMATH_MUL_PS( load(0), s128 ) );
+	res.store( 1, SLMATH_MUL_PS( load(1), s128 ) );
+	res.store( 2, SLMATH_MUL_PS( load(2), s128 ) );
+	return res;
+}
+
+mat3 mat3::operator*( const mat3& o ) const
+{
+	mat3 res;
+
+	// W-components of the columns are 0, so they stay 0 in the result
+	#define VTMP(i,j) SLMATH_MUL_PS( load(i), SLMATH_LOAD_PS1(of+j*4+i) )
+	const float* const of = o.begin();
+	res.store( 0, SLMATH_ADD_PS( SLMATH_ADD_PS(VTMP(0,0),VTMP(1,0)), VTMP(2,0) ) );
+	res.store( 1, SLMATH_ADD_PS( SLMATH_ADD_PS(VTMP(0,1),VTMP(1,1)), VTMP(2,1) ) );
+	res.store( 2, SLMATH_ADD_PS( SLMATH_ADD_PS(VTMP(0,2),VTMP(1,2)), VTMP(2,2) ) );
+	#undef VTMP
+
+	SLMATH_VEC_ASSERT( check(res) );
+	return res;
+}
+
+mat3 transpose( const mat3& m )
+{
+	return mat3( vec3(m[0].x,m[1].x,m[2].x), vec3(m[0].y,m[1].y,m[2].y), vec3(m[0].z,m[1].z,m[2].z) );
+}
+
+float det( const mat3& m )
+{
+	const float res = dot( m[0], cross(m[1],m[2]) );
+	SLMATH_VEC_ASSERT( check(res) );
+	return res;
+}
+
+mat3 inverse_transpose( const mat3& m )
+{
+	SLMATH_VEC_ASSERT( check(m) );
+
+	// cofactor matrix is made of cross products of the columns
+	const vec3 c0 = cross( m[1], m[2] );
+	const vec3 c1 = cross( m[2], m[0] );
+	const vec3 c2 = cross( m[0], m[1] );
+	const float d = dot( m[0], c0 );
+	SLMATH_VEC_ASSERT( d > FLT_MIN || d < -FLT_MIN ); // invertible?
+
+	return mat3( c0, c1, c2 ) * (1.f/d);
+}
+
+mat3 inverse( const mat3& m )
+{
+	return transpose( inverse_transpose(m) );
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
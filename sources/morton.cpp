@@ -0,0 +1,125 @@
+#include <slm/morton.h>
+#include <string.h>
+
+SLMATH_BEGIN()
+
+/**
+ * Normalizes points to the box and quantizes them to range [0,maxq] per axis.
+ * @param q [out] Receives quantized coordinates of the points, array [3*n].
+ */
+static void morton_quantize( const vec3* points, size_t n, const vec3& boxmin, const vec3& boxmax, float maxq, unsigned int* q )
+{
+	float scale[3];
+	for ( size_t a = 0 ; a < 3 ; ++a )
+	{
+		const float ext = boxmax[a] - boxmin[a];
+		scale[a] = (ext > FLT_MIN ? maxq / ext : 0.f);
+	}
+
+	const float zero = 0.f;
+	const m128_t zero4 = SLMATH_LOAD_PS1( &zero );
+	const m128_t maxq4 = SLMATH_LOAD_PS1( &maxq );
+	SLMATH_ALIGN16 float out[3][4];
+	for ( size_t i = 0 ; i < n ; i += 4 )
+	{
+		// last group repeats its final point in the unused lanes
+		const size_t i1 = (i+1 < n ? i+1 : n-1);
+		const size_t i2 = (i+2 < n ? i+2 : n-1);
+		const size_t i3 = (i+3 < n ? i+3 : n-1);
+		for ( size_t a = 0 ; a < 3 ; ++a )
+		{
+			const m128_t p = SLMATH_SET_PS( points[i][a], points[i1][a], points[i2][a], points[i3][a] );
+			const m128_t s = SLMATH_MUL_PS( SLMATH_SUB_PS(p, SLMATH_LOAD_PS1(&boxmin[a])), SLMATH_LOAD_PS1(&scale[a]) );
+			SLMATH_STOREU_PS( out[a], SLMATH_MIN_PS(SLMATH_MAX_PS(s,zero4),maxq4) );
+		}
+
+		const size_t count = (n-i < 4 ? n-i : 4);
+		for ( size_t k = 0 ; k < count ; ++k )
+		{
+			q[(i+k)*3] = (unsigned int)out[0][k];
+			q[(i+k)*3+1] = (unsigned int)out[1][k];
+			q[(i+k)*3+2] = (unsigned int)out[2][k];
+		}
+	}
+}
+
+void morton_codes30( const vec3* points, size_t n, const vec3& boxmin, const vec3& boxmax, unsigned int* codes )
+{
+	// quantize in batches to keep the temporary on the stack
+	unsigned int q[3*256];
+	for ( size_t i = 0 ; i < n ; i += 256 )
+	{
+		const size_t count = (n-i < 256 ? n-i : 256);
+		morton_quantize( points+i, count, boxmin, boxmax, 1023.f, q );
+		for ( size_t k = 0 ; k < count ; ++k )
+			codes[i+k] = morton_encode30( q[k*3], q[k*3+1], q[k*3+2] );
+	}
+}
+
+void morton_codes63( const vec3* points, size_t n, const vec3& boxmin, const vec3& boxmax, unsigned long long* codes )
+{
+	unsigned int q[3*256];
+	for ( size_t i = 0 ; i < n ; i += 256 )
+	{
+		const size_t count = (n-i < 256 ? n-i : 256);
+		morton_quantize( points+i, count, boxmin, boxmax, 2097151.f, q );
+		for ( size_t k = 0 ; k < count ; ++k )
+			codes[i+k] = morton_encode63( q[k*3], q[k*3+1], q[k*3+2] );
+	}
+}
+
+/** Radix sort of keys of type K, see radix_sort. */
+template <class K> static void radix_sort_keys( K* keys, unsigned int* values, size_t n, K* tempkeys, unsigned int* tempvalues )
+{
+	K* srckeys = keys;
+	unsigned int* srcvalues = values;
+	K* dstkeys = tempkeys;
+	unsigned int* dstvalues = tempvalues;
+
+	for ( size_t shift = 0 ; shift < sizeof(K)*8 ; shift += 8 )
+	{
+		size_t count[256];
+		memset( count, 0, sizeof(count) );
+		for ( size_t i = 0 ; i < n ; ++i )
+			++count[(srckeys[i] >> shift) & 0xFF];
+		if ( n > 0 && count[(srckeys[0] >> shift) & 0xFF] == n )
+			continue;
+
+		size_t offset = 0;
+		for ( size_t d = 0 ; d < 256 ; ++d )
+		{
+			const size_t c = count[d];
+			count[d] = offset;
+			offset += c;
+		}
+		for ( size_t i = 0 ; i < n ; ++i )
+		{
+			const size_t j = count[(srckeys[i] >> shift) & 0xFF]++;
+			dstkeys[j] = srckeys[i];
+			dstvalues[j] = srcvalues[i];
+		}
+
+		K* const tk = srckeys; srckeys = dstkeys; dstkeys = tk;
+		unsigned int* const tv = srcvalues; srcvalues = dstvalues; dstvalues = tv;
+	}
+
+	if ( srckeys != keys )
+	{
+		memcpy( keys, srckeys, n*sizeof(K) );
+		memcpy( values, srcvalues, n*sizeof(unsigned int) );
+	}
+}
+
+void radix_sort( unsigned int* keys, unsigned int* values, size_t n, unsigned int* tempkeys, unsigned int* tempvalues )
+{
+	radix_sort_keys( keys, values, n, tempkeys, tempvalues );
+}
+
+void radix_sort( unsigned long long* keys, unsigned int* values, size_t n, unsigned long long* tempkeys, unsigned int* tempvalues )
+{
+	radix_sort_keys( keys, values, n, tempkeys, tempvalues );
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,313 @@
+#include <slm/octahedral.h>
+
+SLMATH_BEGIN()
+
+/** Quantized octahedral coordinates of four vectors. */
+class oct_fields
+{
+public:
+	unsigned int	u[4];
+	unsigned int	v[4];
+};
+
+/** Projects four unit vectors to the octahedral square and scales the coordinates to 0..maxq, without rounding. */
+static void oct_project4( const vec3* v, float maxq, float* tu, float* tv )
+{
+	const float signf = -0.f;
+	const float onef = 1.f;
+	const float scalef = .5f * maxq;
+	const m128_t sign = SLMATH_LOAD_PS1( &signf );
+	const m128_t zero = SLMATH_SETZERO_PS();
+	const m128_t one = SLMATH_LOAD_PS1( &onef );
+	const m128_t scale = SLMATH_LOAD_PS1( &scalef );
+	const m128_t maxv = SLMATH_LOAD_PS1( &maxq );
+
+	const m128_t x = SLMATH_SET_PS( v[0].x, v[1].x, v[2].x, v[3].x );
+	const m128_t y = SLMATH_SET_PS( v[0].y, v[1].y, v[2].y, v[3].y );
+	const m128_t z = SLMATH_SET_PS( v[0].z, v[1].z, v[2].z, v[3].z );
+
+	// project to octahedron |x|+|y|+|z|=1
+	const m128_t ax = SLMATH_ANDNOT_PS( sign, x );
+	const m128_t ay = SLMATH_ANDNOT_PS( sign, y );
+	const m128_t az = SLMATH_ANDNOT_PS( sign, z );
+	const m128_t inv = SLMATH_DIV_PS( one, SLMATH_ADD_PS(SLMATH_ADD_PS(ax,ay),az) );
+	const m128_t px = SLMATH_MUL_PS( x, inv );
+	const m128_t py = SLMATH_MUL_PS( y, inv );
+
+	// fold lower half over the diagonals, keeping signs of x and y (zero counts as positive)
+	const m128_t fx = SLMATH_OR_PS( SLMATH_SUB_PS(one,SLMATH_ANDNOT_PS(sign,py)), SLMATH_AND_PS(x,sign) );
+	const m128_t fy = SLMATH_OR_PS( SLMATH_SUB_PS(one,SLMATH_ANDNOT_PS(sign,px)), SLMATH_AND_PS(y,sign) );
+	const m128_t lower = SLMATH_CMPLT_PS( z, zero );
+	const m128_t ox = SLMATH_SELECT_PS( lower, fx, px );
+	const m128_t oy = SLMATH_SELECT_PS( lower, fy, py );
+
+	SLMATH_STOREU_PS( tu, SLMATH_MIN_PS( SLMATH_MAX_PS( SLMATH_MUL_PS(SLMATH_ADD_PS(ox,one),scale), zero ), maxv ) );
+	SLMATH_STOREU_PS( tv, SLMATH_MIN_PS( SLMATH_MAX_PS( SLMATH_MUL_PS(SLMATH_ADD_PS(oy,one),scale), zero ), maxv ) );
+}
+
+/** Unpacks four vectors from quantized octahedral coordinates in range 0..maxq. */
+static void oct_unpack4( const oct_fields& in, float maxq, vec3* out )
+{
+	const float signf = -0.f;
+	const float onef = 1.f;
+	const float scalef = 2.f / maxq;
+	const m128_t sign = SLMATH_LOAD_PS1( &signf );
+	const m128_t zero = SLMATH_SETZERO_PS();
+	const m128_t one = SLMATH_LOAD_PS1( &onef );
+	const m128_t scale = SLMATH_LOAD_PS1( &scalef );
+
+	m128_t x = SLMATH_SUB_PS( SLMATH_MUL_PS( SLMATH_SET_PS(float(in.u[0]),float(in.u[1]),float(in.u[2]),float(in.u[3])), scale ), one );
+	m128_t y = SLMATH_SUB_PS( SLMATH_MUL_PS( SLMATH_SET_PS(float(in.v[0]),float(in.v[1]),float(in.v[2]),float(in.v[3])), scale ), one );
+	const m128_t z = SLMATH_SUB_PS( SLMATH_SUB_PS( one, SLMATH_ANDNOT_PS(sign,x) ), SLMATH_ANDNOT_PS(sign,y) );
+
+	// unfold lower half: move x and y towards zero by the amount z is below zero
+	const m128_t t = SLMATH_MAX_PS( SLMATH_SUB_PS(zero,z), zero );
+	x = SLMATH_SUB_PS( x, SLMATH_OR_PS(t,SLMATH_AND_PS(x,sign)) );
+	y = SLMATH_SUB_PS( y, SLMATH_OR_PS(t,SLMATH_AND_PS(y,sign)) );
+
+	const m128_t len = SLMATH_SQRT_PS( SLMATH_ADD_PS( SLMATH_ADD_PS(SLMATH_MUL_PS(x,x),SLMATH_MUL_PS(y,y)), SLMATH_MUL_PS(z,z) ) );
+	const m128_t inv = SLMATH_DIV_PS( one, len );
+	float xf[4];
+	float yf[4];
+	float zf[4];
+	SLMATH_STOREU_PS( xf, SLMATH_MUL_PS(x,inv) );
+	SLMATH_STOREU_PS( yf, SLMATH_MUL_PS(y,inv) );
+	SLMATH_STOREU_PS( zf, SLMATH_MUL_PS(z,inv) );
+	for ( size_t k = 0 ; k < 4 ; ++k )
+		out[k] = vec3( xf[k], yf[k], zf[k] );
+}
+
+/**
+ * Packs four unit vectors to quantized octahedral coordinates in range 0..maxq.
+ * Precise packing tries both roundings of both coordinates and keeps the one closest to the original direction.
+ */
+static void oct_pack4( const vec3* v, float maxq, bool precise, oct_fields* out )
+{
+	float tu[4];
+	float tv[4];
+	oct_project4( v, maxq, tu, tv );
+
+	if ( !precise )
+	{
+		for ( size_t k = 0 ; k < 4 ; ++k )
+		{
+			out->u[k] = (unsigned int)( tu[k] + .5f );
+			out->v[k] = (unsigned int)( tv[k] + .5f );
+		}
+		return;
+	}
+
+	const unsigned int maxi = (unsigned int)maxq;
+	for ( size_t k = 0 ; k < 4 ; ++k )
+	{
+		// the four candidates are unpacked together with SIMD
+		const unsigned int u0 = (unsigned int)tu[k];
+		const unsigned int v0 = (unsigned int)tv[k];
+		const unsigned int u1 = ( u0 < maxi ? u0+1 : u0 );
+		const unsigned int v1 = ( v0 < maxi ? v0+1 : v0 );
+		oct_fields c;
+		c.u[0] = u0; c.v[0] = v0;
+		c.u[1] = u1; c.v[1] = v0;
+		c.u[2] = u0; c.v[2] = v1;
+		c.u[3] = u1; c.v[3] = v1;
+		vec3 r[4];
+		oct_unpack4( c, maxq, r );
+
+		// squared distance resolves small angles better than dot product
+		size_t best = 0;
+		float bestd = dot( v[k]-r[0], v[k]-r[0] );
+		for ( size_t i = 1 ; i < 4 ; ++i )
+		{
+			const float d = dot( v[k]-r[i], v[k]-r[i] );
+			if ( d < bestd )
+			{
+				bestd = d;
+				best = i;
+			}
+		}
+		out->u[k] = c.u[best];
+		out->v[k] = c.v[best];
+	}
+}
+
+/** Copies up to four vectors to v4, padding the rest with z-axis. */
+static inline const vec3* load_vec4( const vec3* v, size_t n, vec3* v4 )
+{
+	if ( n >= 4 )
+		return v;
+	for ( size_t k = 0 ; k < 4 ; ++k )
+		v4[k] = ( k < n ? v[k] : vec3(0,0,1) );
+	return v4;
+}
+
+// even number of steps so that zero is exact and axis vectors survive packing unchanged
+static const float OCT16_MAX = 254.f;
+static const float OCT24_MAX = 4094.f;
+static const float OCT32_MAX = 65534.f;
+
+static inline void oct_store( unsigned short* out, unsigned int u, unsigned int v )
+{
+	*out = (unsigned short)( u | (v << 8) );
+}
+
+static inline void oct_store( oct24* out, unsigned int u, unsigned int v )
+{
+	const unsigned int x = u | (v << 12);
+	out->v[0] = (unsigned char)( x & 0xFF );
+	out->v[1] = (unsigned char)( (x >> 8) & 0xFF );
+	out->v[2] = (unsigned char)( x >> 16 );
+}
+
+static inline void oct_store( unsigned int* out, unsigned int u, unsigned int v )
+{
+	*out = u | (v << 16);
+}
+
+static inline void oct_load( unsigned short in, unsigned int* u, unsigned int* v )
+{
+	*u = in & 0xFF;
+	*v = (unsigned int)in >> 8;
+}
+
+static inline void oct_load( const oct24& in, unsigned int* u, unsigned int* v )
+{
+	const unsigned int x = (unsigned int)in.v[0] | ((unsigned int)in.v[1] << 8) | ((unsigned int)in.v[2] << 16);
+	*u = x & 0xFFF;
+	*v = x >> 12;
+}
+
+static inline void oct_load( unsigned int in, unsigned int* u, unsigned int* v )
+{
+	*u = in & 0xFFFF;
+	*v = in >> 16;
+}
+
+/** Packs array of unit vectors four at a time and stores them in packed format T. */
+template <class T> static void oct_pack( const vec3* v, size_t n, T* out, float maxq, bool precise )
+{
+	for ( size_t i = 0 ; i < n ; i += 4 )
+	{
+		const size_t count = ( n-i < 4 ? n-i : 4 );
+		vec3 v4[4];
+		oct_fields f;
+		oct_pack4( load_vec4(v+i,count,v4), maxq, precise, &f );
+		for ( size_t k = 0 ; k < count ; ++k )
+			oct_store( out+i+k, f.u[k], f.v[k] );
+	}
+}
+
+/** Unpacks array of vectors in packed format T four at a time. */
+template <class T> static void oct_unpack( const T* v, size_t n, vec3* out, float maxq )
+{
+	for ( size_t i = 0 ; i < n ; i += 4 )
+	{
+		const size_t count = ( n-i < 4 ? n-i : 4 );
+		oct_fields f;
+		for ( size_t k = 0 ; k < 4 ; ++k )
+			f.u[k] = f.v[k] = 0;
+		for ( size_t k = 0 ; k < count ; ++k )
+			oct_load( v[i+k], &f.u[k], &f.v[k] );
+
+		vec3 r[4];
+		oct_unpack4( f, maxq, r );
+		for ( size_t k = 0 ; k < count ; ++k )
+			out[i+k] = r[k];
+	}
+}
+
+unsigned short pack_oct16( const vec3& v )
+{
+	unsigned short out;
+	oct_pack( &v, 1, &out, OCT16_MAX, false );
+	return out;
+}
+
+oct24 pack_oct24( const vec3& v )
+{
+	oct24 out;
+	oct_pack( &v, 1, &out, OCT24_MAX, false );
+	return out;
+}
+
+unsigned int pack_oct32( const vec3& v )
+{
+	unsigned int out;
+	oct_pack( &v, 1, &out, OCT32_MAX, false );
+	return out;
+}
+
+unsigned short pack_oct16_precise( const vec3& v )
+{
+	unsigned short out;
+	oct_pack( &v, 1, &out, OCT16_MAX, true );
+	return out;
+}
+
+oct24 pack_oct24_precise( const vec3& v )
+{
+	oct24 out;
+	oct_pack( &v, 1, &out, OCT24_MAX, true );
+	return out;
+}
+
+unsigned int pack_oct32_precise( const vec3& v )
+{
+	unsigned int out;
+	oct_pack( &v, 1, &out, OCT32_MAX, true );
+	return out;
+}
+
+vec3 unpack_oct16( unsigned short v )
+{
+	vec3 out;
+	oct_unpack( &v, 1, &out, OCT16_MAX );
+	return out;
+}
+
+vec3 unpack_oct24( const oct24& v )
+{
+	vec3 out;
+	oct_unpack( &v, 1, &out, OCT24_MAX );
+	return out;
+}
+
+vec3 unpack_oct32( unsigned int v )
+{
+	vec3 out;
+	oct_unpack( &v, 1, &out, OCT32_MAX );
+	return out;
+}
+
+void pack_oct16( const vec3* v, size_t n, unsigned short* out, bool precise )
+{
+	oct_pack( v, n, out, OCT16_MAX, precise );
+}
+
+void pack_oct24( const vec3* v, size_t n, oct24* out, bool precise )
+{
+	oct_pack( v, n, out, OCT24_MAX, precise );
+}
+
+void pack_oct32( const vec3* v, size_t n, unsigned int* out, bool precise )
+{
+	oct_pack( v, n, out, OCT32_MAX, precise );
+}
+
+void unpack_oct16( const unsigned short* v, size_t n, vec3* out )
+{
+	oct_unpack( v, n, out, OCT16_MAX );
+}
+
+void unpack_oct24( const oct24* v, size_t n, vec3* out )
+{
+	oct_unpack( v, n, out, OCT24_MAX );
+}
+
+void unpack_oct32( const unsigned int* v, size_t n, vec3* out )
+{
+	oct_unpack( v, n, out, OCT32_MAX );
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
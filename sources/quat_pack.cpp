@@ -0,0 +1,286 @@
+#include <slm/quat_pack.h>
+#include <string.h>
+
+SLMATH_BEGIN()
+
+/** Smallest-three fields of four quaternions: index of the largest component and the other three components quantized. */
+class quat_pack_fields
+{
+public:
+	unsigned int	index[4];
+	unsigned int	v[3][4];
+};
+
+/** Largest of the smallest three components of a unit quaternion is 1/sqrt(2). */
+static const float QUAT_PACK_RANGE = 0.70710678f;
+
+/**
+ * Packs four unit quaternions to smallest-three fields with components quantized to 0..maxq.
+ * Single and batch functions use this same code path so they give bitwise identical results.
+ */
+static void pack_quat4( const quat* q, float maxq, quat_pack_fields* out )
+{
+	const float signf = -0.f;
+	const float zerof = 0.f;
+	const float onef = 1.f;
+	const float twof = 2.f;
+	const float threef = 3.f;
+	const float scalef = maxq / (2.f*QUAT_PACK_RANGE);
+	const m128_t sign = SLMATH_LOAD_PS1( &signf );
+	const m128_t zero = SLMATH_SETZERO_PS();
+	const m128_t range = SLMATH_LOAD_PS1( &QUAT_PACK_RANGE );
+	const m128_t scale = SLMATH_LOAD_PS1( &scalef );
+	const m128_t maxv = SLMATH_LOAD_PS1( &maxq );
+
+	m128_t x = SLMATH_SET_PS( q[0].x, q[1].x, q[2].x, q[3].x );
+	m128_t y = SLMATH_SET_PS( q[0].y, q[1].y, q[2].y, q[3].y );
+	m128_t z = SLMATH_SET_PS( q[0].z, q[1].z, q[2].z, q[3].z );
+	m128_t w = SLMATH_SET_PS( q[0].w, q[1].w, q[2].w, q[3].w );
+
+	// largest absolute component and its index per lane, index as float so it can be selected with float masks
+	m128_t best = SLMATH_ANDNOT_PS( sign, x );
+	m128_t largest = x;
+	m128_t index = SLMATH_LOAD_PS1( &zerof );
+	m128_t gt = SLMATH_CMPGT_PS( SLMATH_ANDNOT_PS(sign,y), best );
+	best = SLMATH_SELECT_PS( gt, SLMATH_ANDNOT_PS(sign,y), best );
+	largest = SLMATH_SELECT_PS( gt, y, largest );
+	index = SLMATH_SELECT_PS( gt, SLMATH_LOAD_PS1(&onef), index );
+	gt = SLMATH_CMPGT_PS( SLMATH_ANDNOT_PS(sign,z), best );
+	best = SLMATH_SELECT_PS( gt, SLMATH_ANDNOT_PS(sign,z), best );
+	largest = SLMATH_SELECT_PS( gt, z, largest );
+	index = SLMATH_SELECT_PS( gt, SLMATH_LOAD_PS1(&twof), index );
+	gt = SLMATH_CMPGT_PS( SLMATH_ANDNOT_PS(sign,w), best );
+	largest = SLMATH_SELECT_PS( gt, w, largest );
+	index = SLMATH_SELECT_PS( gt, SLMATH_LOAD_PS1(&threef), index );
+
+	// q and -q are the same rotation, so flip the quaternion to make the dropped component positive
+	const m128_t flip = SLMATH_AND_PS( SLMATH_CMPLT_PS(largest,zero), sign );
+	x = SLMATH_XOR_PS( x, flip );
+	y = SLMATH_XOR_PS( y, flip );
+	z = SLMATH_XOR_PS( z, flip );
+	w = SLMATH_XOR_PS( w, flip );
+
+	// remaining components in order with the largest one dropped
+	const m128_t m0 = SLMATH_CMPEQ_PS( index, zero );
+	const m128_t m1 = SLMATH_CMPLE_PS( index, SLMATH_LOAD_PS1(&onef) );
+	const m128_t m2 = SLMATH_CMPLE_PS( index, SLMATH_LOAD_PS1(&twof) );
+	m128_t v[3];
+	v[0] = SLMATH_SELECT_PS( m0, y, x );
+	v[1] = SLMATH_SELECT_PS( m1, z, y );
+	v[2] = SLMATH_SELECT_PS( m2, w, z );
+
+	float indexf[4];
+	SLMATH_STOREU_PS( indexf, index );
+	for ( size_t k = 0 ; k < 4 ; ++k )
+		out->index[k] = (unsigned int)indexf[k];
+
+	for ( size_t j = 0 ; j < 3 ; ++j )
+	{
+		const m128_t t = SLMATH_MIN_PS( SLMATH_MAX_PS( SLMATH_MUL_PS(SLMATH_ADD_PS(v[j],range),scale), zero ), maxv );
+		float tf[4];
+		SLMATH_STOREU_PS( tf, t );
+		for ( size_t k = 0 ; k < 4 ; ++k )
+			out->v[j][k] = (unsigned int)( tf[k] + .5f );
+	}
+}
+
+/** Unpacks four quaternions from smallest-three fields with components quantized to 0..maxq. */
+static void unpack_quat4( const quat_pack_fields& in, float maxq, quat* out )
+{
+	const float scalef = 2.f*QUAT_PACK_RANGE / maxq;
+	const float onef = 1.f;
+	const m128_t range = SLMATH_LOAD_PS1( &QUAT_PACK_RANGE );
+	const m128_t scale = SLMATH_LOAD_PS1( &scalef );
+
+	m128_t v[3];
+	for ( size_t j = 0 ; j < 3 ; ++j )
+		v[j] = SLMATH_SUB_PS( SLMATH_MUL_PS( SLMATH_SET_PS(float(in.v[j][0]),float(in.v[j][1]),float(in.v[j][2]),float(in.v[j][3])), scale ), range );
+	const m128_t d = SLMATH_ADD_PS( SLMATH_ADD_PS( SLMATH_MUL_PS(v[0],v[0]), SLMATH_MUL_PS(v[1],v[1]) ), SLMATH_MUL_PS(v[2],v[2]) );
+	const m128_t largest = SLMATH_SQRT_PS( SLMATH_MAX_PS( SLMATH_SUB_PS(SLMATH_LOAD_PS1(&onef),d), SLMATH_SETZERO_PS() ) );
+
+	float vf[3][4];
+	float lf[4];
+	for ( size_t j = 0 ; j < 3 ; ++j )
+		SLMATH_STOREU_PS( vf[j], v[j] );
+	SLMATH_STOREU_PS( lf, largest );
+	for ( size_t k = 0 ; k < 4 ; ++k )
+	{
+		float* const c = &out[k].x;
+		const unsigned int index = in.index[k];
+		size_t j = 0;
+		for ( unsigned int i = 0 ; i < 4 ; ++i )
+			c[i] = ( i == index ? lf[k] : vf[j++][k] );
+	}
+}
+
+/** Packs smallest-three fields of lane k to 32 bits. */
+static inline unsigned int pack_bits32( const quat_pack_fields& f, size_t k )
+{
+	return (f.index[k] << 30) | (f.v[0][k] << 20) | (f.v[1][k] << 10) | f.v[2][k];
+}
+
+/** Unpacks 32 bits to smallest-three fields of lane k. */
+static inline void unpack_bits32( unsigned int v, quat_pack_fields* f, size_t k )
+{
+	f->index[k] = v >> 30;
+	f->v[0][k] = (v >> 20) & 1023;
+	f->v[1][k] = (v >> 10) & 1023;
+	f->v[2][k] = v & 1023;
+}
+
+/** Packs smallest-three fields of lane k to 48 bits. */
+static inline quat48 pack_bits48( const quat_pack_fields& f, size_t k )
+{
+	const unsigned long long v = ((unsigned long long)f.index[k] << 45) | ((unsigned long long)f.v[0][k] << 30) | ((unsigned long long)f.v[1][k] << 15) | f.v[2][k];
+	quat48 out;
+	out.v[0] = (unsigned short)( v & 0xFFFF );
+	out.v[1] = (unsigned short)( (v >> 16) & 0xFFFF );
+	out.v[2] = (unsigned short)( v >> 32 );
+	return out;
+}
+
+/** Unpacks 48 bits to smallest-three fields of lane k. */
+static inline void unpack_bits48( const quat48& in, quat_pack_fields* f, size_t k )
+{
+	const unsigned long long v = (unsigned long long)in.v[0] | ((unsigned long long)in.v[1] << 16) | ((unsigned long long)in.v[2] << 32);
+	f->index[k] = (unsigned int)( v >> 45 ) & 3;
+	f->v[0][k] = (unsigned int)( v >> 30 ) & 32767;
+	f->v[1][k] = (unsigned int)( v >> 15 ) & 32767;
+	f->v[2][k] = (unsigned int)v & 32767;
+}
+
+/** Copies up to four quaternions to q4, padding the rest with identity. */
+static inline const quat* load_quat4( const quat* q, size_t n, quat* q4 )
+{
+	if ( n >= 4 )
+		return q;
+	for ( size_t k = 0 ; k < 4 ; ++k )
+		q4[k] = ( k < n ? q[k] : quat(0,0,0,1) );
+	return q4;
+}
+
+// even number of steps so that zero is exact and identity and axis rotations survive packing unchanged
+static const float QUAT32_MAX = 1022.f;
+static const float QUAT48_MAX = 32766.f;
+
+float rotation_error( const quat& a, const quat& b )
+{
+	// chord length is more accurate than acos of dot product for small angles
+	const quat d = ( dot(a,b) < 0.f ? a+b : a-b );
+	const float h = .5f * sqrtf( dot(d,d) );
+	return 4.f * asinf( h < 1.f ? h : 1.f );
+}
+
+unsigned int pack_quat32( const quat& q )
+{
+	unsigned int v;
+	pack_quat32( &q, 1, &v, 0 );
+	return v;
+}
+
+quat unpack_quat32( unsigned int v )
+{
+	quat q;
+	unpack_quat32( &v, 1, &q );
+	return q;
+}
+
+quat48 pack_quat48( const quat& q )
+{
+	quat48 v;
+	pack_quat48( &q, 1, &v, 0 );
+	return v;
+}
+
+quat unpack_quat48( const quat48& v )
+{
+	quat q;
+	unpack_quat48( &v, 1, &q );
+	return q;
+}
+
+void pack_quat32( const quat* q, size_t n, unsigned int* out, float* maxerror )
+{
+	float err = 0.f;
+	for ( size_t i = 0 ; i < n ; i += 4 )
+	{
+		const size_t count = ( n-i < 4 ? n-i : 4 );
+		quat q4[4];
+		quat_pack_fields f;
+		pack_quat4( load_quat4(q+i,count,q4), QUAT32_MAX, &f );
+		for ( size_t k = 0 ; k < count ; ++k )
+			out[i+k] = pack_bits32( f, k );
+
+		if ( maxerror )
+		{
+			quat r[4];
+			unpack_quat4( f, QUAT32_MAX, r );
+			for ( size_t k = 0 ; k < count ; ++k )
+				err = max( err, rotation_error(q[i+k],r[k]) );
+		}
+	}
+	if ( maxerror )
+		*maxerror = err;
+}
+
+void unpack_quat32( const unsigned int* v, size_t n, quat* out )
+{
+	for ( size_t i = 0 ; i < n ; i += 4 )
+	{
+		const size_t count = ( n-i < 4 ? n-i : 4 );
+		quat_pack_fields f;
+		memset( &f, 0, sizeof(f) );
+		for ( size_t k = 0 ; k < count ; ++k )
+			unpack_bits32( v[i+k], &f, k );
+
+		quat r[4];
+		unpack_quat4( f, QUAT32_MAX, r );
+		for ( size_t k = 0 ; k < count ; ++k )
+			out[i+k] = r[k];
+	}
+}
+
+void pack_quat48( const quat* q, size_t n, quat48* out, float* maxerror )
+{
+	float err = 0.f;
+	for ( size_t i = 0 ; i < n ; i += 4 )
+	{
+		const size_t count = ( n-i < 4 ? n-i : 4 );
+		quat q4[4];
+		quat_pack_fields f;
+		pack_quat4( load_quat4(q+i,count,q4), QUAT48_MAX, &f );
+		for ( size_t k = 0 ; k < count ; ++k )
+			out[i+k] = pack_bits48( f, k );
+
+		if ( maxerror )
+		{
+			quat r[4];
+			unpack_quat4( f, QUAT48_MAX, r );
+			for ( size_t k = 0 ; k < count ; ++k )
+				err = max( err, rotation_error(q[i+k],r[k]) );
+		}
+	}
+	if ( maxerror )
+		*maxerror = err;
+}
+
+void unpack_quat48( const quat48* v, size_t n, quat* out )
+{
+	for ( size_t i = 0 ; i < n ; i += 4 )
+	{
+		const size_t count = ( n-i < 4 ? n-i : 4 );
+		quat_pack_fields f;
+		memset( &f, 0, sizeof(f) );
+		for ( size_t k = 0 ; k < count ; ++k )
+			unpack_bits48( v[i+k], &f, k );
+
+		quat r[4];
+		unpack_quat4( f, QUAT48_MAX, r );
+		for ( size_t k = 0 ; k < count ; ++k )
+			out[i+k] = r[k];
+	}
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -7,6 +7,9 @@
 	#else
 		#pragma message( "slm: Not SSE2 SIMD instructions" )
 	#endif
+	#if defined(SLMATH_SSE2_MSVC) && defined(SLMATH_AVX)
+		#pragma message( "slm: Using AVX instructions for double types" )
+	#endif
 	#ifdef SLMATH_MSVC_HAS_INTRIN_H
 		#pragma message( "slm: Using <intrin.h>" )
 	#else
@@ -20,6 +23,7 @@
 #ifdef SLMATH_SSE2_MSVC
 #ifdef SLMATH_MSVC_HAS_INTRIN_H
 #include <intrin.h>
+#include <immintrin.h>
 #else // SLMATH_MSVC_HAS_INTRIN_H
 
 extern "C" void __cpuid(int cpuinfo[4], int mode)
@@ -43,6 +47,9 @@ extern "C" void __cpuid(int cpuinfo[4], int mode)
 }
 
 #endif // SLMATH_MSVC_HAS_INTRIN_H
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define SLMATH_GCC_CPUID
 #endif // SLMATH_SSE2_MSVC
 
 SLMATH_BEGIN()
@@ -59,9 +66,51 @@ bool isSSE2CPU()
 #endif
 }
 
+bool isAVXCPU()
+{
+#if defined(SLMATH_SSE2_MSVC) && defined(SLMATH_MSVC_HAS_INTRIN_H)
+	int cpuinfo[4];
+	__cpuid(cpuinfo, 1);
+	bool avx = (cpuinfo[2] & (1<<28)) != 0;
+	bool osxsave = (cpuinfo[2] & (1<<27)) != 0;
+	// OS must also save YMM registers on context switch
+	return avx && osxsave && (_xgetbv(0) & 6) == 6;
+#else
+	return false;
+#endif
+}
+
+bool isF16CCPU()
+{
+#if defined(SLMATH_SSE2_MSVC) && defined(SLMATH_MSVC_HAS_INTRIN_H)
+	int cpuinfo[4];
+	__cpuid(cpuinfo, 1);
+	bool f16c = (cpuinfo[2] & (1<<29)) != 0;
+	// F16C uses VEX encoding, so it needs the same OS support as AVX
+	return f16c && isAVXCPU();
+#elif defined(SLMATH_GCC_CPUID)
+	unsigned int eax, ebx, ecx, edx;
+	if ( !__get_cpuid(1, &eax, &ebx, &ecx, &edx) )
+		return false;
+	bool f16c = (ecx & (1<<29)) != 0;
+	bool avx = (ecx & (1<<28)) != 0;
+	bool osxsave = (ecx & (1<<27)) != 0;
+	if ( !(f16c && avx && osxsave) )
+		return false;
+	// xgetbv by opcode, so it builds without -mxsave
+	unsigned int xcr0, xcr0hi;
+	__asm__ __volatile__( ".byte 0x0f, 0x01, 0xd0" : "=a"(xcr0), "=d"(xcr0hi) : "c"(0) );
+	return (xcr0 & 6) == 6;
+#else
+	return false;
+#endif
+}
+
 bool isValidCPU()
 {
-#ifdef SLMATH_SSE2_MSVC
+#if defined(SLMATH_SSE2_MSVC) && defined(SLMATH_AVX)
+	return isSSE2CPU() && isAVXCPU();
+#elif defined(SLMATH_SSE2_MSVC)
 	return isSSE2CPU();
 #else
 	return true;
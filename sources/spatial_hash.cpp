@@ -0,0 +1,251 @@
+#include <slm/spatial_hash.h>
+
+SLMATH_BEGIN()
+
+spatial_hash::spatial_hash( float cellsize, size_t tablesize ) :
+	m_cellsize( cellsize ),
+	m_invcellsize( 1.f/cellsize ),
+	m_mask( 0 )
+{
+	SLMATH_VEC_ASSERT( cellsize > FLT_MIN );
+
+	size_t n = 1;
+	while ( n < tablesize )
+		n <<= 1;
+	m_mask = n-1;
+
+	m_cellstart.resize( n+1 );
+	for ( size_t i = 0 ; i <= n ; ++i )
+		m_cellstart[i] = 0;
+	for ( size_t i = 0 ; i < 3 ; ++i )
+		m_boundsmin[i] = m_boundsmax[i] = 0;
+}
+
+/** Largest cell coordinate magnitude, leaves headroom so cell arithmetic in queries can't overflow int. */
+static const float SPATIAL_HASH_MAX_CELL = 536870912.f;
+
+/** Returns cell coordinate of scaled position, clamped so the conversion to int is defined. */
+static inline int cell_coord( float v )
+{
+	const float c = floorf( v );
+	return int( !(c > -SPATIAL_HASH_MAX_CELL) ? -SPATIAL_HASH_MAX_CELL : c < SPATIAL_HASH_MAX_CELL ? c : SPATIAL_HASH_MAX_CELL );
+}
+
+inline void spatial_hash::cell( const vec3& p, int* c ) const
+{
+	c[0] = cell_coord( p.x*m_invcellsize );
+	c[1] = cell_coord( p.y*m_invcellsize );
+	c[2] = cell_coord( p.z*m_invcellsize );
+}
+
+inline size_t spatial_hash::bucket( int x, int y, int z ) const
+{
+	return ( (unsigned(x)*73856093u) ^ (unsigned(y)*19349663u) ^ (unsigned(z)*83492791u) ) & m_mask;
+}
+
+void spatial_hash::build( const vec3* points, size_t n )
+{
+	const size_t tablesize = m_mask+1;
+	m_indices.resize( n );
+	m_points.resize( n );
+	m_buckets.resize( n );
+	for ( size_t i = 0 ; i <= tablesize ; ++i )
+		m_cellstart[i] = 0;
+
+	// count points per bucket
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		int c[3];
+		cell( points[i], c );
+		const size_t b = bucket( c[0], c[1], c[2] );
+		m_buckets[i] = b;
+		++m_cellstart[b];
+
+		for ( size_t k = 0 ; k < 3 ; ++k )
+		{
+			if ( 0 == i || c[k] < m_boundsmin[k] )
+				m_boundsmin[k] = c[k];
+			if ( 0 == i || c[k] > m_boundsmax[k] )
+				m_boundsmax[k] = c[k];
+		}
+	}
+
+	// exclusive prefix sum gives first slot of each bucket
+	size_t sum = 0;
+	for ( size_t i = 0 ; i < tablesize ; ++i )
+	{
+		const size_t count = m_cellstart[i];
+		m_cellstart[i] = sum;
+		sum += count;
+	}
+	m_cellstart[tablesize] = sum;
+
+	// scatter, using start of each bucket as cursor, so afterwards it points to the end of the bucket
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const size_t slot = m_cellstart[m_buckets[i]]++;
+		m_indices[slot] = i;
+		m_points[slot] = points[i];
+	}
+	for ( size_t i = tablesize ; i > 0 ; --i )
+		m_cellstart[i] = m_cellstart[i-1];
+	m_cellstart[0] = 0;
+}
+
+size_t spatial_hash::query_radius( const vec3& p, float radius, size_t* out, size_t maxout ) const
+{
+	SLMATH_VEC_ASSERT( radius >= 0.f );
+
+	const float r2 = radius*radius;
+	const size_t n = m_indices.size();
+	size_t count = 0;
+
+	int c0[3], c1[3];
+	cell( p - vec3(radius), c0 );
+	cell( p + vec3(radius), c1 );
+	for ( size_t k = 0 ; k < 3 ; ++k )
+	{
+		c0[k] = max( c0[k], m_boundsmin[k] );
+		c1[k] = min( c1[k], m_boundsmax[k] );
+		if ( c0[k] > c1[k] )
+			return 0;
+	}
+
+	// very large query compared to number of points, just test them all
+	const double cells = double(c1[0]-c0[0]+1) * double(c1[1]-c0[1]+1) * double(c1[2]-c0[2]+1);
+	if ( cells > double(n) )
+	{
+		for ( size_t j = 0 ; j < n ; ++j )
+		{
+			const vec3 d = m_points[j] - p;
+			if ( dot(d,d) <= r2 )
+			{
+				if ( count < maxout )
+					out[count] = m_indices[j];
+				++count;
+			}
+		}
+		return count;
+	}
+
+	for ( int z = c0[2] ; z <= c1[2] ; ++z )
+	{
+		for ( int y = c0[1] ; y <= c1[1] ; ++y )
+		{
+			for ( int x = c0[0] ; x <= c1[0] ; ++x )
+			{
+				const size_t b = bucket( x, y, z );
+				for ( size_t j = m_cellstart[b] ; j < m_cellstart[b+1] ; ++j )
+				{
+					const vec3 d = m_points[j] - p;
+					if ( dot(d,d) > r2 )
+						continue;
+
+					// other cells can hash to the same bucket, report points only from their own cell
+					int c[3];
+					cell( m_points[j], c );
+					if ( c[0] != x || c[1] != y || c[2] != z )
+						continue;
+
+					if ( count < maxout )
+						out[count] = m_indices[j];
+					++count;
+				}
+			}
+		}
+	}
+	return count;
+}
+
+size_t spatial_hash::query_nearest( const vec3& p, size_t k, size_t* out, float* outdist ) const
+{
+	const size_t n = m_indices.size();
+	if ( k > n )
+		k = n;
+	if ( 0 == k )
+		return 0;
+
+	// out and dist2 hold best candidates so far sorted by squared distance
+	vector_simd<float> dist2buf;
+	if ( !outdist )
+		dist2buf.resize( k );
+	float* const dist2 = (outdist ? outdist : dist2buf.begin());
+	size_t count = 0;
+
+	// start from the first shell of cells which overlaps bounds of the points
+	int c[3];
+	cell( p, c );
+	int s0 = 0;
+	for ( size_t i = 0 ; i < 3 ; ++i )
+		s0 = max( s0, max(m_boundsmin[i]-c[i], c[i]-m_boundsmax[i]) );
+
+	for ( int s = s0 ; ; ++s )
+	{
+		// visit cells at Chebyshev distance s from the center cell
+		for ( int dz = -s ; dz <= s ; ++dz )
+		{
+			for ( int dy = -s ; dy <= s ; ++dy )
+			{
+				const bool face = (dz == -s || dz == s || dy == -s || dy == s);
+				const int step = (face || 0 == s ? 1 : 2*s);
+				for ( int dx = -s ; dx <= s ; dx += step )
+				{
+					const int x = c[0]+dx;
+					const int y = c[1]+dy;
+					const int z = c[2]+dz;
+					if ( x < m_boundsmin[0] || x > m_boundsmax[0] || y < m_boundsmin[1] || y > m_boundsmax[1] || z < m_boundsmin[2] || z > m_boundsmax[2] )
+						continue;
+
+					const size_t b = bucket( x, y, z );
+					for ( size_t j = m_cellstart[b] ; j < m_cellstart[b+1] ; ++j )
+					{
+						const vec3 d = m_points[j] - p;
+						const float d2 = dot(d,d);
+						if ( count == k && d2 >= dist2[k-1] )
+							continue;
+
+						int pc[3];
+						cell( m_points[j], pc );
+						if ( pc[0] != x || pc[1] != y || pc[2] != z )
+							continue;
+
+						// insertion sort to candidate list
+						size_t i = (count < k ? count++ : k-1);
+						for ( ; i > 0 && dist2[i-1] > d2 ; --i )
+						{
+							dist2[i] = dist2[i-1];
+							out[i] = out[i-1];
+						}
+						dist2[i] = d2;
+						out[i] = m_indices[j];
+					}
+				}
+			}
+		}
+
+		// cells further away are at least s cells from the query point
+		if ( count == k )
+		{
+			const float mind = float(s) * m_cellsize;
+			if ( dist2[k-1] <= mind*mind )
+				break;
+		}
+
+		// stop when shell covers all points
+		if ( c[0]-s <= m_boundsmin[0] && c[0]+s >= m_boundsmax[0] &&
+			c[1]-s <= m_boundsmin[1] && c[1]+s >= m_boundsmax[1] &&
+			c[2]-s <= m_boundsmin[2] && c[2]+s >= m_boundsmax[2] )
+			break;
+	}
+
+	if ( outdist )
+	{
+		for ( size_t i = 0 ; i < count ; ++i )
+			outdist[i] = sqrtf( outdist[i] );
+	}
+	return count;
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,169 @@
+#include <slm/sweep_and_prune.h>
+
+SLMATH_BEGIN()
+
+/** Number of padding entries after the sorted bounds, so that the last boxes can be loaded four at a time. */
+static const size_t SWEEP_PADDING = 4;
+
+sweep_and_prune::sweep_and_prune( int axis ) :
+	m_axis( axis )
+{
+	SLMATH_VEC_ASSERT( axis >= 0 && axis < 3 );
+}
+
+/** Sifts element i down the heap of n elements keyed by key. */
+static void sift_down( float* key, unsigned int* order, size_t i, size_t n )
+{
+	for (;;)
+	{
+		size_t c = i*2+1;
+		if ( c >= n )
+			break;
+		if ( c+1 < n && key[c+1] > key[c] )
+			++c;
+		if ( !(key[c] > key[i]) )
+			break;
+		const float k = key[i]; key[i] = key[c]; key[c] = k;
+		const unsigned int o = order[i]; order[i] = order[c]; order[c] = o;
+		i = c;
+	}
+}
+
+/** Sorts from scratch with heap sort, used when there is no previous order to start from. */
+static void heap_sort( float* key, unsigned int* order, size_t n )
+{
+	for ( size_t i = n/2 ; i > 0 ; --i )
+		sift_down( key, order, i-1, n );
+	for ( size_t i = n ; i > 1 ; --i )
+	{
+		const float k = key[0]; key[0] = key[i-1]; key[i-1] = k;
+		const unsigned int o = order[0]; order[0] = order[i-1]; order[i-1] = o;
+		sift_down( key, order, 0, i-1 );
+	}
+}
+
+/** Sorts with insertion sort, which is close to linear time when the order from the previous update is nearly right. */
+static void insertion_sort( float* key, unsigned int* order, size_t n )
+{
+	for ( size_t i = 1 ; i < n ; ++i )
+	{
+		const float k = key[i];
+		const unsigned int o = order[i];
+		size_t j = i;
+		for ( ; j > 0 && key[j-1] > k ; --j )
+		{
+			key[j] = key[j-1];
+			order[j] = order[j-1];
+		}
+		key[j] = k;
+		order[j] = o;
+	}
+}
+
+void sweep_and_prune::update( const vec3* boxmin, const vec3* boxmax, size_t n )
+{
+	const int a0 = m_axis;
+	const int a1 = (a0 == 2 ? 0 : a0+1);
+	const int a2 = (a1 == 2 ? 0 : a1+1);
+
+	const bool resort = (n != m_order.size() || m_min[0].size() != n+SWEEP_PADDING);
+	if ( resort )
+	{
+		m_order.resize( n );
+		for ( size_t i = 0 ; i < n ; ++i )
+			m_order[i] = (unsigned int)i;
+		m_key.resize( n );
+		for ( size_t k = 0 ; k < 3 ; ++k )
+		{
+			m_min[k].resize( n+SWEEP_PADDING );
+			m_max[k].resize( n+SWEEP_PADDING );
+		}
+	}
+
+	// sort keys in the previous order
+	float* const key = m_key.begin();
+	unsigned int* const order = m_order.begin();
+	for ( size_t i = 0 ; i < n ; ++i )
+		key[i] = boxmin[order[i]][a0];
+	if ( resort )
+		heap_sort( key, order, n );
+	else
+		insertion_sort( key, order, n );
+
+	// gather bounds in sorted order, axis 0 is the sort axis
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const vec3& bmin = boxmin[order[i]];
+		const vec3& bmax = boxmax[order[i]];
+		m_min[0][i] = key[i];
+		m_max[0][i] = bmax[a0];
+		m_min[1][i] = bmin[a1];
+		m_max[1][i] = bmax[a1];
+		m_min[2][i] = bmin[a2];
+		m_max[2][i] = bmax[a2];
+	}
+	for ( size_t i = n ; i < n+SWEEP_PADDING ; ++i )
+	{
+		for ( size_t k = 0 ; k < 3 ; ++k )
+		{
+			m_min[k][i] = FLT_MAX;
+			m_max[k][i] = -FLT_MAX;
+		}
+	}
+}
+
+size_t sweep_and_prune::find_pairs( box_pair* pairs, size_t maxpairs ) const
+{
+	const size_t n = m_order.size();
+	const unsigned int* const order = m_order.begin();
+	const float* const min0 = m_min[0].begin();
+	const float* const min1 = m_min[1].begin();
+	const float* const max1 = m_max[1].begin();
+	const float* const min2 = m_min[2].begin();
+	const float* const max2 = m_max[2].begin();
+	size_t count = 0;
+
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const m128_t imax0 = SLMATH_LOAD_PS1( &m_max[0][i] );
+		const m128_t imin1 = SLMATH_LOAD_PS1( &min1[i] );
+		const m128_t imax1 = SLMATH_LOAD_PS1( &max1[i] );
+		const m128_t imin2 = SLMATH_LOAD_PS1( &min2[i] );
+		const m128_t imax2 = SLMATH_LOAD_PS1( &max2[i] );
+
+		// sweep forward until boxes start after the end of box i along sort axis
+		for ( size_t j = i+1 ; j < n ; j += 4 )
+		{
+			const m128_t overlap0 = SLMATH_CMPLE_PS( SLMATH_LOADU_PS(min0+j), imax0 );
+			const int mask0 = SLMATH_MOVEMASK_PS( overlap0 );
+			if ( 0 == mask0 )
+				break;
+
+			const m128_t overlap1 = SLMATH_AND_PS( SLMATH_CMPLE_PS(SLMATH_LOADU_PS(min1+j),imax1), SLMATH_CMPGE_PS(SLMATH_LOADU_PS(max1+j),imin1) );
+			const m128_t overlap2 = SLMATH_AND_PS( SLMATH_CMPLE_PS(SLMATH_LOADU_PS(min2+j),imax2), SLMATH_CMPGE_PS(SLMATH_LOADU_PS(max2+j),imin2) );
+			int mask = SLMATH_MOVEMASK_PS( SLMATH_AND_PS(overlap0, SLMATH_AND_PS(overlap1,overlap2)) );
+			for ( size_t k = 0 ; mask ; ++k, mask >>= 1 )
+			{
+				if ( (mask & 1) && j+k < n )
+				{
+					if ( count < maxpairs )
+					{
+						const unsigned int a = order[i];
+						const unsigned int b = order[j+k];
+						pairs[count].a = (a < b ? a : b);
+						pairs[count].b = (a < b ? b : a);
+					}
+					++count;
+				}
+			}
+
+			if ( 0xF != mask0 )
+				break;
+		}
+	}
+	return count;
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -0,0 +1,82 @@
+#include <slm/trs.h>
+
+SLMATH_BEGIN()
+
+trs trs::operator*( const trs& o ) const
+{
+	SLMATH_VEC_ASSERT( check(*this) );
+	SLMATH_VEC_ASSERT( check(o) );
+	return trs( transform_point(*this,o.translation), rotation*o.rotation, scale*o.scale );
+}
+
+trs inverse( const trs& x )
+{
+	SLMATH_VEC_ASSERT( check(x) );
+	SLMATH_VEC_ASSERT( x.scale.x != 0.f && x.scale.y != 0.f && x.scale.z != 0.f );
+
+	const quat r = conjugate( x.rotation );
+	const vec3 s = vec3(1.f,1.f,1.f) / x.scale;
+	return trs( -(s * rotate(r,x.translation)), r, s );
+}
+
+trs mix( const trs& a, const trs& b, float u )
+{
+	const quat br = ( dot(a.rotation,b.rotation) < 0.f ? -b.rotation : b.rotation );
+	return trs( mix(a.translation,b.translation,u), slerp(a.rotation,br,u), mix(a.scale,b.scale,u) );
+}
+
+mat4 to_mat4( const trs& x )
+{
+	mat4 m( x.rotation );
+	m[0] *= x.scale.x;
+	m[1] *= x.scale.y;
+	m[2] *= x.scale.z;
+	m[3] = vec4( x.translation, 1.f );
+	return m;
+}
+
+void to_mat4( const trs* x, size_t n, mat4* out )
+{
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		// rotation matrix of unit quaternion without normalization, columns scaled
+		const quat& q = x[i].rotation;
+		const vec3& s = x[i].scale;
+		const vec3& t = x[i].translation;
+		SLMATH_VEC_ASSERT( fabsf(norm_squared(q)-1.f) < 1e-3f );
+
+		const float xx = q.x*q.x;
+		const float yy = q.y*q.y;
+		const float zz = q.z*q.z;
+		const float xy = q.x*q.y;
+		const float xz = q.x*q.z;
+		const float yz = q.y*q.z;
+		const float wx = q.w*q.x;
+		const float wy = q.w*q.y;
+		const float wz = q.w*q.z;
+
+		m128_t* const m = out[i].m128();
+		m[0] = SLMATH_SET_PS( (1.f-2.f*(yy+zz))*s.x, 2.f*(xy+wz)*s.x, 2.f*(xz-wy)*s.x, 0.f );
+		m[1] = SLMATH_SET_PS( 2.f*(xy-wz)*s.y, (1.f-2.f*(xx+zz))*s.y, 2.f*(yz+wx)*s.y, 0.f );
+		m[2] = SLMATH_SET_PS( 2.f*(xz+wy)*s.z, 2.f*(yz-wx)*s.z, (1.f-2.f*(xx+yy))*s.z, 0.f );
+		m[3] = SLMATH_SET_PS( t.x, t.y, t.z, 1.f );
+	}
+}
+
+void compose_hierarchy( const trs* local, const int* parents, size_t n, trs* world )
+{
+	SLMATH_VEC_ASSERT( local != world );
+
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		SLMATH_VEC_ASSERT( parents[i] < (int)i );
+		if ( parents[i] < 0 )
+			world[i] = local[i];
+		else
+			world[i] = world[parents[i]] * local[i];
+	}
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
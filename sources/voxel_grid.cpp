@@ -0,0 +1,111 @@
+#include <slm/voxel_grid.h>
+
+SLMATH_BEGIN()
+
+voxel_grid::voxel_grid( const vec3& origin, float voxelsize, size_t sx, size_t sy, size_t sz ) :
+	m_origin( origin ),
+	m_voxelsize( voxelsize )
+{
+	SLMATH_VEC_ASSERT( voxelsize > FLT_MIN );
+	SLMATH_VEC_ASSERT( sx > 0 && sy > 0 && sz > 0 );
+
+	m_size[0] = sx;
+	m_size[1] = sy;
+	m_size[2] = sz;
+	m_bits.resize( (sx*sy*sz+31)/32 );
+	clear();
+}
+
+void voxel_grid::clear()
+{
+	for ( size_t i = 0 ; i < m_bits.size() ; ++i )
+		m_bits[i] = 0;
+}
+
+/**
+ * Returns range of voxels [*v0,*v1] touching coordinate range [lo,hi] along one axis, relative to grid origin.
+ * @return false if the range is outside the grid.
+ */
+static bool voxel_range( float lo, float hi, float invsize, size_t n, size_t* v0, size_t* v1 )
+{
+	// voxels touching the range at their faces are included
+	const float f0 = ceilf( lo*invsize ) - 1.f;
+	const float f1 = floorf( hi*invsize );
+	if ( f1 < 0.f || f0 >= float(n) )
+		return false;
+	*v0 = (f0 < 0.f ? 0 : size_t(f0));
+	*v1 = (f1 >= float(n) ? n-1 : size_t(f1));
+	return true;
+}
+
+void voxel_grid::voxelize( const vec3* vertices, const unsigned int* indices, size_t first, size_t count )
+{
+	const float invsize = 1.f / m_voxelsize;
+	const float halfsize = m_voxelsize * .5f;
+	const m128_t half = SLMATH_LOAD_PS1( &halfsize );
+	const float lanef[4] = {.5f, 1.5f, 2.5f, 3.5f};
+	const m128_t lane = SLMATH_LOADU_PS( lanef );
+	const m128_t size4 = SLMATH_LOAD_PS1( &m_voxelsize );
+
+	for ( size_t i = first ; i < first+count ; ++i )
+	{
+		const vec3& v0 = vertices[indices ? indices[i*3] : i*3];
+		const vec3& v1 = vertices[indices ? indices[i*3+1] : i*3+1];
+		const vec3& v2 = vertices[indices ? indices[i*3+2] : i*3+2];
+		const vec3 tmin = min( v0, min(v1,v2) ) - m_origin;
+		const vec3 tmax = max( v0, max(v1,v2) ) - m_origin;
+
+		size_t x0, x1, y0, y1, z0, z1;
+		if ( !voxel_range(tmin.x, tmax.x, invsize, m_size[0], &x0, &x1) ||
+			!voxel_range(tmin.y, tmax.y, invsize, m_size[1], &y0, &y1) ||
+			!voxel_range(tmin.z, tmax.z, invsize, m_size[2], &z0, &z1) )
+			continue;
+
+		// test rows of four voxels along X-axis against the triangle
+		const intersect_triangle_box_triangle tri( v0, v1, v2 );
+		for ( size_t z = z0 ; z <= z1 ; ++z )
+		{
+			const float czf = m_origin.z + (float(z)+.5f)*m_voxelsize;
+			const m128_t cz = SLMATH_LOAD_PS1( &czf );
+			for ( size_t y = y0 ; y <= y1 ; ++y )
+			{
+				const float cyf = m_origin.y + (float(y)+.5f)*m_voxelsize;
+				const m128_t cy = SLMATH_LOAD_PS1( &cyf );
+				for ( size_t x = x0 ; x <= x1 ; x += 4 )
+				{
+					const float xf = float(x);
+					const m128_t cx = SLMATH_ADD_PS( SLMATH_LOAD_PS1(&m_origin.x), SLMATH_MUL_PS(SLMATH_ADD_PS(SLMATH_LOAD_PS1(&xf),lane),size4) );
+					int mask = intersect_triangle_box4( tri, cx, cy, cz, half, half, half );
+					if ( x1-x < 3 )
+						mask &= (1 << (x1-x+1)) - 1;
+					for ( size_t k = 0 ; mask ; ++k, mask >>= 1 )
+						if ( mask & 1 )
+							set( x+k, y, z );
+				}
+			}
+		}
+	}
+}
+
+void voxel_grid::merge( const voxel_grid& other )
+{
+	SLMATH_VEC_ASSERT( other.m_size[0] == m_size[0] && other.m_size[1] == m_size[1] && other.m_size[2] == m_size[2] );
+
+	for ( size_t i = 0 ; i < m_bits.size() ; ++i )
+		m_bits[i] |= other.m_bits[i];
+}
+
+size_t voxel_grid::count() const
+{
+	size_t n = 0;
+	for ( size_t i = 0 ; i < m_bits.size() ; ++i )
+	{
+		for ( unsigned int w = m_bits[i] ; w ; w &= w-1 )
+			++n;
+	}
+	return n;
+}
+
+SLMATH_END()
+
+// This file is part of 'slm' C++ library. Copyright (C) 2009-2018 Jani Kajala (kajala@gmail.com). Licensed under BSD/MIT license
@@ -1,4 +1,5 @@
 #include <slm/slmath.h>
+#include <slm/vec_expr.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -186,6 +187,1648 @@ bool test_vector_sse( char* testid )
 	return true;
 }
 
+bool test_intersect( char* testid )
+{
+	// watertight: rays through the shared diagonal and the corners of a quad must not leak
+	const vec3 quad[4] = { vec3(0,0,0), vec3(1,0,0), vec3(1,1,0), vec3(0,1,0) };
+	for ( int i = 0 ; i <= 16 ; ++i )
+	{
+		const vec3 o( float(i)/16.f, float(i)/16.f, 1.f );
+		const vec3 d( 0, 0, -2.f );
+		float t0 = -1.f, t1 = -1.f;
+		const bool hit0 = intersect_line_triangle_watertight( o, d, quad[0], quad[1], quad[2], &t0, 0, 0 );
+		const bool hit1 = intersect_line_triangle_watertight( o, d, quad[0], quad[2], quad[3], &t1, 0, 0 );
+		TEST( hit0 || hit1 );
+		TEST( fabsf((hit0 ? t0 : t1) - .5f) < 1e-6f );
+	}
+
+	// barycentrics match Moller-Trumbore convention
+	float t, u, v;
+	TEST( intersect_line_triangle_watertight( vec3(.25f,.5f,1), vec3(0,0,-2), vec3(0,0,0), vec3(1,0,0), vec3(0,1,0), &t, &u, &v ) );
+	TEST( fabsf(t-.5f) < 1e-6f && fabsf(u-.25f) < 1e-6f && fabsf(v-.5f) < 1e-6f );
+	TEST( !intersect_line_triangle_watertight( vec3(.25f,.5f,1), vec3(0,0,-.5f), vec3(0,0,0), vec3(1,0,0), vec3(0,1,0), &t, &u, &v ) );
+
+	// triangle4 matches scalar version
+	for ( int n = 0 ; n < 100 ; ++n )
+	{
+		triangle4 tris;
+		vec3 tv[4][3];
+		for ( int i = 0 ; i < 4 ; ++i )
+		{
+			for ( int k = 0 ; k < 3 ; ++k )
+				tv[i][k] = vec3( random_float()*2.f-1.f, random_float()*2.f-1.f, random_float()*2.f-1.f );
+			tris.set( i, tv[i][0], tv[i][1], tv[i][2] );
+		}
+		if ( n % 4 == 0 )
+			tris.clear( 3 );
+
+		const vec3 o( random_float()*.5f-.25f, random_float()*.5f-.25f, -2.f );
+		const vec3 d( random_float()*.5f-.25f, random_float()*.5f-.25f, 4.f );
+		const intersect_line_triangle_line line( o, d );
+		int nearest = -1;
+		float tnearest = 2.f;
+		for ( int i = 0 ; i < (n%4 == 0 ? 3 : 4) ; ++i )
+		{
+			if ( intersect_line_triangle_watertight( line, tv[i][0], tv[i][1], tv[i][2], 0.f, 1.f, &t, 0, 0 ) && t < tnearest )
+			{
+				tnearest = t;
+				nearest = i;
+			}
+		}
+		const int nearest4 = intersect_line_triangle4( line, tris, 0.f, 1.f, &t, &u, &v );
+		TEST( nearest4 == nearest );
+		if ( nearest >= 0 && nearest4 == nearest )
+		{
+			TEST( fabsf(t-tnearest) < 1e-5f );
+			const vec3 p = tv[nearest][0] + (tv[nearest][1]-tv[nearest][0])*u + (tv[nearest][2]-tv[nearest][0])*v;
+			TEST( distance(p, o+d*t) < 1e-4f );
+		}
+	}
+	return true;
+}
+
+bool test_frustum( char* testid )
+{
+	const mat4 proj = perspective_fov_rh( radians(90.f), 1.f, 1.f, 100.f );
+	const mat4 view = look_at_rh( vec3(0,0,10), vec3(0,0,0), vec3(0,1,0) );
+	const frustum f( proj * view );
+	TEST( intersect_frustum_sphere( f, vec3(0,0,0), 1.f ) );
+	TEST( !intersect_frustum_sphere( f, vec3(0,0,20), 1.f ) );
+	TEST( intersect_frustum_sphere( f, vec3(0,0,9.5f), 1.f ) );
+	TEST( !intersect_frustum_sphere( f, vec3(0,0,-95.f), 2.f ) );
+	TEST( !intersect_frustum_sphere( f, vec3(30,0,0), 1.f ) );
+	TEST( intersect_frustum_box( f, vec3(-1,-1,-1), vec3(1,1,1) ) );
+	TEST( !intersect_frustum_box( f, vec3(30,-1,-1), vec3(31,1,1) ) );
+	TEST( intersect_frustum_box( f, vec3(5,-1,-1), vec3(15,1,1) ) );
+
+	// batch versions match single object tests
+	const size_t n = 103;
+	float x[n], y[n], z[n], r[n], ex[n], ey[n], ez[n];
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		x[i] = random_float()*80.f-40.f;
+		y[i] = random_float()*80.f-40.f;
+		z[i] = random_float()*160.f-120.f;
+		r[i] = random_float()*5.f;
+		ex[i] = x[i] + random_float()*10.f;
+		ey[i] = y[i] + random_float()*10.f;
+		ez[i] = z[i] + random_float()*10.f;
+	}
+	size_t visible[n];
+	unsigned int mask[(n+31)/32];
+	size_t count = cull_spheres( f, x, y, z, r, n, visible );
+	cull_spheres_mask( f, x, y, z, r, n, mask );
+	size_t k = 0;
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const bool vis = intersect_frustum_sphere( f, vec3(x[i],y[i],z[i]), r[i] );
+		TEST( vis == (0 != (mask[i>>5] & (1u<<(i&31)))) );
+		if ( vis )
+			TEST( k < count && visible[k++] == i );
+	}
+	TEST( k == count && count > 0 && count < n );
+
+	count = cull_boxes( f, x, y, z, ex, ey, ez, n, visible );
+	cull_boxes_mask( f, x, y, z, ex, ey, ez, n, mask );
+	k = 0;
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const bool vis = intersect_frustum_box( f, vec3(x[i],y[i],z[i]), vec3(ex[i],ey[i],ez[i]) );
+		TEST( vis == (0 != (mask[i>>5] & (1u<<(i&31)))) );
+		if ( vis )
+			TEST( k < count && visible[k++] == i );
+	}
+	TEST( k == count && count > 0 && count < n );
+	return true;
+}
+
+bool test_ray_query( char* testid )
+{
+	// three parallel quads (as triangle pairs) at z=1,2,3
+	vec3 verts[12];
+	unsigned int indices[18];
+	for ( int i = 0 ; i < 3 ; ++i )
+	{
+		const float z = float(3-i);
+		verts[i*4+0] = vec3(-1,-1,z);
+		verts[i*4+1] = vec3( 1,-1,z);
+		verts[i*4+2] = vec3( 1, 1,z);
+		verts[i*4+3] = vec3(-1, 1,z);
+		const unsigned int quad[6] = {0,1,2, 0,2,3};
+		for ( int k = 0 ; k < 6 ; ++k )
+			indices[i*6+k] = quad[k] + unsigned(i)*4;
+	}
+
+	ray_hit hit;
+	ray r( vec3(.5f,.25f,0), vec3(0,0,1) );
+	TEST( intersect_ray_triangles( r, RAY_CLOSEST_HIT, verts, indices, 6, &hit ) );
+	TEST( fabsf(hit.t-1.f) < 1e-6f && hit.index/2 == 2 );
+	TEST( fabsf(r.tmax-1.f) < 1e-6f );
+
+	ray r2( vec3(.5f,.25f,0), vec3(0,0,1), 1.5f, 10.f );
+	TEST( intersect_ray_triangles( r2, RAY_CLOSEST_HIT, verts, indices, 6, &hit ) );
+	TEST( fabsf(hit.t-2.f) < 1e-6f && hit.index/2 == 1 );
+
+	ray r3( vec3(.5f,.25f,0), vec3(0,0,1) );
+	TEST( intersect_ray_triangles( r3, RAY_ANY_HIT, verts, indices, 6, &hit ) );
+	TEST( hit.index/2 == 0 && r3.tmax == FLT_MAX );
+
+	ray r4( vec3(.5f,.25f,0), vec3(0,0,1), 0.f, .5f );
+	TEST( !intersect_ray_triangles( r4, RAY_ANY_HIT, verts, indices, 6, &hit ) );
+
+	// triangle4 blocks give the same answer
+	triangle4 blocks[2];
+	for ( size_t i = 0 ; i < 8 ; ++i )
+	{
+		if ( i < 6 )
+			blocks[i/4].set( i%4, verts[indices[i*3]], verts[indices[i*3+1]], verts[indices[i*3+2]] );
+		else
+			blocks[i/4].clear( i%4 );
+	}
+	ray r5( vec3(-.5f,.25f,-1), vec3(0,0,2) );
+	TEST( intersect_ray_triangle4s( r5, RAY_CLOSEST_HIT, blocks, 2, &hit ) );
+	TEST( fabsf(hit.t-1.f) < 1e-6f && hit.index/2 == 2 );
+
+	// boxes
+	const vec3 boxes[6] = { vec3(-1,-1,5), vec3(1,1,6), vec3(-1,-1,2), vec3(1,1,3), vec3(-1,-1,-3), vec3(1,1,-2) };
+	ray r6( vec3(0,0,0), vec3(0,0,1) );
+	TEST( intersect_ray_boxes( r6, RAY_CLOSEST_HIT, boxes, 3, &hit ) );
+	TEST( hit.index == 1 && fabsf(hit.t-2.f) < 1e-6f );
+	ray r7( vec3(0,0,0), vec3(0,0,1), 0.f, 1.f );
+	TEST( !intersect_ray_boxes( r7, RAY_ANY_HIT, boxes, 3, &hit ) );
+	float tnear;
+	ray r8( vec3(0,0,2.5f), vec3(0,0,1) );
+	TEST( intersect_ray_box( r8, boxes[2], boxes[3], &tnear ) && tnear == 0.f );
+	TEST( intersect_line_box( vec3(0,0,0), vec3(0,0,3), boxes[2], boxes[3] ) );
+	TEST( !intersect_line_box( vec3(0,0,0), vec3(0,0,1.5f), boxes[2], boxes[3] ) );
+	return true;
+}
+
+bool test_spatial_hash( char* testid )
+{
+	const size_t n = 500;
+	vec3 points[n];
+	for ( size_t i = 0 ; i < n ; ++i )
+		points[i] = vec3( random_float()*20.f-10.f, random_float()*20.f-10.f, random_float()*4.f-2.f );
+
+	spatial_hash grid( 1.f, 64 );
+	grid.build( points, n );
+	TEST( grid.size() == n );
+
+	for ( size_t q = 0 ; q < 20 ; ++q )
+	{
+		const vec3 p( random_float()*24.f-12.f, random_float()*24.f-12.f, random_float()*6.f-3.f );
+
+		// radius query matches brute force
+		const float radius = random_float()*3.f;
+		size_t found[n];
+		const size_t count = grid.query_radius( p, radius, found, n );
+		size_t expected = 0;
+		for ( size_t i = 0 ; i < n ; ++i )
+			expected += (distance(points[i],p) <= radius ? 1 : 0);
+		TEST( count == expected );
+		for ( size_t i = 0 ; i < count && i < n ; ++i )
+			TEST( distance(points[found[i]],p) <= radius );
+
+		// k nearest matches brute force
+		const size_t k = 7;
+		size_t nearest[k];
+		float dist[k];
+		TEST( grid.query_nearest( p, k, nearest, dist ) == k );
+		for ( size_t i = 0 ; i < k ; ++i )
+		{
+			size_t closer = 0;
+			for ( size_t j = 0 ; j < n ; ++j )
+				closer += (distance(points[j],p) < dist[i] ? 1 : 0);
+			TEST( closer <= i );
+			TEST( fabsf(distance(points[nearest[i]],p) - dist[i]) < 1e-5f );
+		}
+	}
+
+	// far away query and more neighbours than points
+	size_t all[n+1];
+	TEST( grid.query_nearest( vec3(1000,0,0), n+1, all, 0 ) == n );
+	TEST( grid.query_radius( vec3(1000,0,0), 1.f, all, n ) == 0 );
+	TEST( grid.query_radius( vec3(0,0,0), 100.f, all, 10 ) == n );
+
+	// cell coordinates beyond int range are clamped to border cells
+	const vec3 farpts[5] = { vec3(0,0,0), vec3(2e-3f,0,0), vec3(1e7f,0,0), vec3(-1e7f,5,0), vec3(3e9f,-3e9f,1e9f) };
+	spatial_hash fine( 1e-3f, 8 );
+	fine.build( farpts, 5 );
+	TEST( fine.query_radius( vec3(1e7f,0,0), 1.f, all, n ) == 1 && all[0] == 2 );
+	TEST( fine.query_radius( vec3(3e9f,-3e9f,1e9f), 1.f, all, n ) == 1 && all[0] == 4 );
+	TEST( fine.query_radius( vec3(0,0,0), .01f, all, n ) == 2 );
+	TEST( fine.query_radius( vec3(0,0,0), 1e10f, all, n ) == 5 );
+	float fardist[2];
+	TEST( fine.query_nearest( vec3(1e-3f,0,0), 2, all, fardist ) == 2 && fardist[1] < 2e-3f );
+	return true;
+}
+
+bool test_sweep_and_prune( char* testid )
+{
+	const size_t n = 300;
+	vec3 boxmin[n], boxmax[n];
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		boxmin[i] = vec3( random_float()*50.f, random_float()*10.f, random_float()*10.f );
+		boxmax[i] = boxmin[i] + vec3( random_float()*2.f, random_float()*2.f, random_float()*2.f );
+	}
+
+	sweep_and_prune sap( 0 );
+	const size_t maxpairs = n*n/2;
+	box_pair* pairs = new box_pair[maxpairs];
+	for ( int frame = 0 ; frame < 3 ; ++frame )
+	{
+		sap.update( boxmin, boxmax, n );
+		TEST( sap.size() == n );
+		const size_t count = sap.find_pairs( pairs, maxpairs );
+
+		size_t expected = 0;
+		for ( size_t i = 0 ; i < n ; ++i )
+			for ( size_t j = i+1 ; j < n ; ++j )
+				if ( boxmin[i].x <= boxmax[j].x && boxmin[j].x <= boxmax[i].x &&
+					boxmin[i].y <= boxmax[j].y && boxmin[j].y <= boxmax[i].y &&
+					boxmin[i].z <= boxmax[j].z && boxmin[j].z <= boxmax[i].z )
+					++expected;
+		TEST( count == expected && count > 0 );
+
+		for ( size_t i = 0 ; i < count && i < maxpairs ; ++i )
+		{
+			const box_pair& p = pairs[i];
+			TEST( p.a < p.b && p.b < n );
+			TEST( max(boxmin[p.a],boxmin[p.b]) == min(max(boxmin[p.a],boxmin[p.b]),min(boxmax[p.a],boxmax[p.b])) );
+		}
+
+		// limited output buffer still reports total count
+		TEST( sap.find_pairs( pairs, 3 ) == count );
+
+		// move boxes a bit for the next frame
+		for ( size_t i = 0 ; i < n ; ++i )
+		{
+			const vec3 d( random_float()-.5f, random_float()-.5f, random_float()-.5f );
+			boxmin[i] += d;
+			boxmax[i] += d;
+		}
+	}
+
+	// empty first update, then growing from empty
+	sweep_and_prune empty( 1 );
+	empty.update( boxmin, boxmax, 0 );
+	TEST( empty.size() == 0 && empty.find_pairs( pairs, maxpairs ) == 0 );
+	empty.update( boxmin, boxmax, 2 );
+	TEST( empty.size() == 2 );
+
+	delete[] pairs;
+	return true;
+}
+
+bool test_bvh( char* testid )
+{
+	// random triangle soup, small triangles scattered in a box
+	const size_t n = 300;
+	vec3 verts[n*3];
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const vec3 c( random_float()*20.f-10.f, random_float()*20.f-10.f, random_float()*20.f-10.f );
+		for ( size_t k = 0 ; k < 3 ; ++k )
+			verts[i*3+k] = c + vec3( random_float()*2.f-1.f, random_float()*2.f-1.f, random_float()*2.f-1.f );
+	}
+
+	bvh tree;
+	tree.build( verts, 0, n );
+	TEST( tree.size() == n );
+	TEST( sizeof(bvh_node) == 64 );
+
+	// quantized child bounds contain the triangles of the leaves
+	for ( size_t i = 0 ; i < tree.node_count() ; ++i )
+	{
+		const bvh_node& node = tree.nodes()[i];
+		for ( size_t c = 0 ; c < bvh_node::SIZE ; ++c )
+		{
+			if ( !bvh_node::is_leaf(node.child[c]) )
+				continue;
+			const vec3 bmin = node.child_min( c );
+			const vec3 bmax = node.child_max( c );
+			const size_t b = bvh_node::leaf_block( node.child[c] );
+			for ( size_t k = 0 ; k < triangle4::SIZE ; ++k )
+			{
+				const unsigned int tri = tree.triangle_indices()[b*triangle4::SIZE+k];
+				if ( tri == 0xFFFFFFFFu )
+					continue;
+				for ( size_t j = 0 ; j < 3 ; ++j )
+				{
+					const vec3& v = verts[tri*3+j];
+					TEST( v.x >= bmin.x && v.y >= bmin.y && v.z >= bmin.z && v.x <= bmax.x && v.y <= bmax.y && v.z <= bmax.z );
+				}
+			}
+		}
+	}
+
+	// closest and any hit queries match brute force
+	for ( size_t q = 0 ; q < 200 ; ++q )
+	{
+		const vec3 o( random_float()*30.f-15.f, random_float()*30.f-15.f, random_float()*30.f-15.f );
+		const vec3 target( random_float()*20.f-10.f, random_float()*20.f-10.f, random_float()*20.f-10.f );
+		const vec3 d = (q%10 == 0 ? vec3(0,0,1) : target - o);
+
+		ray_hit hit1, hit2;
+		ray r1( o, d );
+		ray r2( o, d );
+		const bool found1 = intersect_ray_triangles( r1, RAY_CLOSEST_HIT, verts, 0, n, &hit1 );
+		const bool found2 = intersect_ray_bvh( r2, RAY_CLOSEST_HIT, tree, &hit2 );
+		TEST( found1 == found2 );
+		if ( found1 )
+			TEST( hit1.index == hit2.index && fabsf(hit1.t-hit2.t) <= 1e-5f*hit1.t );
+
+		ray r3( o, d );
+		TEST( intersect_ray_bvh( r3, RAY_ANY_HIT, tree, &hit2 ) == found1 );
+		if ( found1 )
+		{
+			ray r4( o, d, 0.f, hit1.t*.999f );
+			const bool blocked = intersect_ray_triangles( r4, RAY_ANY_HIT, verts, 0, n, 0 );
+			ray r5( o, d, 0.f, hit1.t*.999f );
+			TEST( intersect_ray_bvh( r5, RAY_ANY_HIT, tree, 0 ) == blocked );
+		}
+	}
+
+	// hierarchy attached to a saved image gives the same answers
+	vector_simd<char> image;
+	image.resize( tree.image_size() );
+	TEST( tree.save_image( image.begin(), image.size()-1 ) == 0 );
+	TEST( tree.save_image( image.begin(), image.size() ) == image.size() );
+	bvh loaded;
+	TEST( loaded.load_image( image.begin(), image.size() ) );
+	TEST( loaded.size() == n && loaded.node_count() == tree.node_count() && loaded.block_count() == tree.block_count() );
+	TEST( (const char*)loaded.nodes() >= image.begin() && (const char*)loaded.nodes() < image.end() );
+	for ( size_t q = 0 ; q < 50 ; ++q )
+	{
+		const vec3 o( random_float()*30.f-15.f, random_float()*30.f-15.f, random_float()*30.f-15.f );
+		const vec3 d = vec3( random_float()*20.f-10.f, random_float()*20.f-10.f, random_float()*20.f-10.f ) - o;
+		ray_hit hit1, hit2;
+		ray r1( o, d );
+		ray r2( o, d );
+		const bool found = intersect_ray_bvh( r1, RAY_CLOSEST_HIT, tree, &hit1 );
+		TEST( intersect_ray_bvh( r2, RAY_CLOSEST_HIT, loaded, &hit2 ) == found );
+		if ( found )
+			TEST( hit1.index == hit2.index && hit1.t == hit2.t );
+	}
+
+	// truncated or corrupt images are rejected
+	bvh_node* const root = (bvh_node*)( image.begin() + ((const char*)loaded.nodes() - image.begin()) );
+	TEST( !loaded.load_image( image.begin(), image.size()-1 ) );
+	TEST( loaded.size() == 0 && loaded.node_count() == 1 );
+	image[0] ^= 1;
+	TEST( !loaded.load_image( image.begin(), image.size() ) );
+	image[0] ^= 1;
+	TEST( loaded.load_image( image.begin(), image.size() ) );
+
+	// so are images with node references outside the arrays or back to a parent
+	const unsigned int child0 = root->child[0];
+	root->child[0] = bvh_node::make_leaf( tree.block_count() );
+	TEST( !loaded.load_image( image.begin(), image.size() ) );
+	root->child[0] = bvh_node::make_inner( tree.node_count() );
+	TEST( !loaded.load_image( image.begin(), image.size() ) );
+	root->child[0] = child0;
+	const unsigned int child1 = root[1].child[0];
+	root[1].child[0] = bvh_node::make_inner( 1 );
+	TEST( !loaded.load_image( image.begin(), image.size() ) );
+	root[1].child[0] = child1;
+	TEST( loaded.load_image( image.begin(), image.size() ) );
+
+	// axis parallel ray with origin on a quantized plane touches the child
+	bvh_node node;
+	memset( &node, 0, sizeof(node) );
+	for ( size_t a = 0 ; a < 3 ; ++a )
+	{
+		node.scale[a] = 1.f;
+		node.qmax[a][0] = 2;
+	}
+	node.child[0] = bvh_node::make_leaf( 0 );
+	float tnear[bvh_node::SIZE];
+	TEST( intersect_ray_bvh_node( ray(vec3(-1,0,1), vec3(1,0,0)), node, tnear ) == 1 && tnear[0] == 1.f );
+	TEST( intersect_ray_bvh_node( ray(vec3(0,1,-1), vec3(0,0,1)), node, tnear ) == 1 && tnear[0] == 1.f );
+
+	// empty hierarchy
+	bvh empty;
+	empty.build( verts, 0, 0 );
+	ray r( vec3(0,0,0), vec3(0,0,1) );
+	TEST( !intersect_ray_bvh( r, RAY_CLOSEST_HIT, empty, 0 ) );
+	return true;
+}
+
+bool test_closest_point( char* testid )
+{
+	// closest point on triangle is never further than sampled points of the triangle
+	for ( size_t q = 0 ; q < 100 ; ++q )
+	{
+		vec3 tv[3];
+		for ( size_t k = 0 ; k < 3 ; ++k )
+			tv[k] = vec3( random_float()*4.f-2.f, random_float()*4.f-2.f, random_float()*4.f-2.f );
+		const vec3 p( random_float()*8.f-4.f, random_float()*8.f-4.f, random_float()*8.f-4.f );
+
+		float u, v;
+		const vec3 c = closest_point_triangle( p, tv[0], tv[1], tv[2], &u, &v );
+		TEST( u >= 0.f && v >= 0.f && u+v <= 1.f+1e-5f );
+		TEST( length(tv[0] + (tv[1]-tv[0])*u + (tv[2]-tv[0])*v - c) < 1e-5f );
+		const float dist = length( c - p );
+		for ( int i = 0 ; i <= 20 ; ++i )
+			for ( int j = 0 ; i+j <= 20 ; ++j )
+				TEST( dist <= length(tv[0] + (tv[1]-tv[0])*(i/20.f) + (tv[2]-tv[0])*(j/20.f) - p) + 1e-5f );
+
+		// SIMD version gives the same result in every lane
+		triangle4 block;
+		for ( size_t k = 0 ; k < triangle4::SIZE ; ++k )
+			block.set( k, tv[k%3], tv[(k+1)%3], tv[(k+2)%3] );
+		float d2[4], u4[4], v4[4];
+		closest_point_triangle4( p, block, d2, u4, v4 );
+		for ( size_t k = 0 ; k < triangle4::SIZE ; ++k )
+		{
+			TEST( fabsf(sqrtf(d2[k]) - dist) < 1e-4f );
+			const vec3 c4 = block.vertex(k,0) + (block.vertex(k,1)-block.vertex(k,0))*u4[k] + (block.vertex(k,2)-block.vertex(k,0))*v4[k];
+			TEST( length(c4-c) < 1e-4f );
+		}
+	}
+
+	// degenerate triangle
+	const vec3 c = closest_point_triangle( vec3(0,1,0), vec3(-1,0,0), vec3(0,0,0), vec3(1,0,0), 0, 0 );
+	TEST( length(c) < 1e-6f );
+
+	// nearest surface in bvh matches brute force
+	const size_t n = 200;
+	vec3 verts[n*3];
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const vec3 center( random_float()*20.f-10.f, random_float()*20.f-10.f, random_float()*20.f-10.f );
+		for ( size_t k = 0 ; k < 3 ; ++k )
+			verts[i*3+k] = center + vec3( random_float()*2.f-1.f, random_float()*2.f-1.f, random_float()*2.f-1.f );
+	}
+	bvh tree;
+	tree.build( verts, 0, n );
+	for ( size_t q = 0 ; q < 100 ; ++q )
+	{
+		const vec3 p( random_float()*30.f-15.f, random_float()*30.f-15.f, random_float()*30.f-15.f );
+		const float maxdist = (q%2 ? FLT_MAX : random_float()*3.f);
+		closest_point_hit hit1, hit2;
+		const bool found1 = closest_point_triangles( p, verts, 0, n, maxdist, &hit1 );
+		const bool found2 = closest_point_bvh( p, tree, maxdist, &hit2 );
+		TEST( found1 == found2 || fabsf((found1 ? hit1 : hit2).distance-maxdist) < 1e-4f );
+		if ( found1 && found2 )
+		{
+			TEST( fabsf(hit1.distance-hit2.distance) < 1e-4f );
+			TEST( length(hit1.point-hit2.point) < 1e-3f || hit1.index != hit2.index );
+		}
+	}
+	return true;
+}
+
+bool test_voxelize( char* testid )
+{
+	// basic triangle-box cases
+	const vec3 bmin( 0, 0, 0 );
+	const vec3 bmax( 1, 1, 1 );
+	TEST( intersect_triangle_box( vec3(.2f,.2f,.5f), vec3(.8f,.2f,.5f), vec3(.5f,.8f,.5f), bmin, bmax ) );
+	TEST( intersect_triangle_box( vec3(-5,-5,.5f), vec3(5,-5,.5f), vec3(0,5,.5f), bmin, bmax ) );
+	TEST( !intersect_triangle_box( vec3(2,0,0), vec3(3,0,0), vec3(2,1,0), bmin, bmax ) );
+	TEST( intersect_triangle_box( vec3(1,0,0), vec3(3,0,0), vec3(1,1,0), bmin, bmax ) );
+	// bounds overlap but triangle plane passes by the corner
+	TEST( !intersect_triangle_box( vec3(1.3f,1.3f,-1), vec3(1.3f,-1,1.3f), vec3(-1,1.3f,1.3f), vec3(0,0,0), vec3(.5f,.5f,.5f) ) );
+
+	// SIMD array version matches scalar
+	const size_t nboxes = 23;
+	float bx[6][nboxes];
+	for ( size_t i = 0 ; i < nboxes ; ++i )
+	{
+		for ( size_t k = 0 ; k < 3 ; ++k )
+		{
+			bx[k][i] = random_float()*4.f-2.f;
+			bx[k+3][i] = bx[k][i] + random_float();
+		}
+	}
+	for ( size_t q = 0 ; q < 20 ; ++q )
+	{
+		vec3 tv[3];
+		for ( size_t k = 0 ; k < 3 ; ++k )
+			tv[k] = vec3( random_float()*4.f-2.f, random_float()*4.f-2.f, random_float()*4.f-2.f );
+		unsigned int mask[1];
+		intersect_triangle_boxes_mask( tv[0], tv[1], tv[2], bx[0], bx[1], bx[2], bx[3], bx[4], bx[5], nboxes, mask );
+		for ( size_t i = 0 ; i < nboxes ; ++i )
+			TEST( (0 != (mask[0] & (1u<<i))) == intersect_triangle_box(tv[0], tv[1], tv[2], vec3(bx[0][i],bx[1][i],bx[2][i]), vec3(bx[3][i],bx[4][i],bx[5][i])) );
+	}
+
+	// voxelized grid matches per voxel tests, and merging partial grids gives the same result
+	const size_t n = 20;
+	vec3 verts[n*3];
+	for ( size_t i = 0 ; i < n*3 ; ++i )
+		verts[i] = vec3( random_float()*14.f-2.f, random_float()*12.f-2.f, random_float()*10.f-2.f );
+	const vec3 origin( 0, 0, 0 );
+	voxel_grid grid( origin, 1.f, 11, 9, 7 );
+	grid.voxelize( verts, 0, 0, n );
+	voxel_grid part1( origin, 1.f, 11, 9, 7 );
+	voxel_grid part2( origin, 1.f, 11, 9, 7 );
+	part1.voxelize( verts, 0, 0, n/2 );
+	part2.voxelize( verts, 0, n/2, n-n/2 );
+	part1.merge( part2 );
+	TEST( part1.count() == grid.count() && grid.count() > 0 );
+	for ( size_t z = 0 ; z < grid.size_z() ; ++z )
+	{
+		for ( size_t y = 0 ; y < grid.size_y() ; ++y )
+		{
+			for ( size_t x = 0 ; x < grid.size_x() ; ++x )
+			{
+				bool touched = false;
+				for ( size_t i = 0 ; i < n && !touched ; ++i )
+					touched = intersect_triangle_box( verts[i*3], verts[i*3+1], verts[i*3+2], vec3(float(x),float(y),float(z)), vec3(float(x+1),float(y+1),float(z+1)) );
+				TEST( grid.get(x,y,z) == touched );
+				TEST( part1.get(x,y,z) == touched );
+			}
+		}
+	}
+	grid.clear();
+	TEST( grid.count() == 0 );
+	return true;
+}
+
+bool test_ray_primitives( char* testid )
+{
+	float t;
+	const vec3 zero( 0, 0, 0 );
+	const vec3 z( 0, 0, 1 );
+	const vec3 x( 1, 0, 0 );
+
+	// sphere, entry point or tmin if inside
+	TEST( intersect_ray_sphere( ray(vec3(0,0,-5),z), zero, 1.f, &t ) && fabsf(t-4.f) < 1e-5f );
+	TEST( intersect_ray_sphere( ray(zero,z), zero, 1.f, &t ) && t == 0.f );
+	TEST( !intersect_ray_sphere( ray(vec3(0,0,-5),z,0.f,3.f), zero, 1.f, &t ) );
+	TEST( !intersect_ray_sphere( ray(vec3(0,0,5),z), zero, 1.f, &t ) );
+	TEST( !intersect_ray_sphere( ray(vec3(0,2,-5),z), zero, 1.f, &t ) );
+
+	// plane
+	TEST( intersect_ray_plane( ray(zero,z), vec4(0,0,1,-2), &t ) && fabsf(t-2.f) < 1e-6f );
+	TEST( !intersect_ray_plane( ray(zero,x), vec4(0,0,1,-2), &t ) );
+	TEST( !intersect_ray_plane( ray(zero,-z), vec4(0,0,1,-2), &t ) );
+
+	// capsule: side, end cap, near end of side, inside
+	const vec3 p0( 0, 0, 0 );
+	const vec3 p1( 0, 0, 4 );
+	TEST( intersect_ray_capsule( ray(vec3(-5,0,2),x), p0, p1, 1.f, &t ) && fabsf(t-4.f) < 1e-5f );
+	TEST( intersect_ray_capsule( ray(vec3(0,0,-5),z), p0, p1, 1.f, &t ) && fabsf(t-4.f) < 1e-5f );
+	TEST( intersect_ray_capsule( ray(vec3(-5,0,4.5f),x), p0, p1, 1.f, &t ) && fabsf(t-(5.f-sqrtf(.75f))) < 1e-5f );
+	TEST( intersect_ray_capsule( ray(vec3(0,.5f,1),x), p0, p1, 1.f, &t ) && t == 0.f );
+	TEST( !intersect_ray_capsule( ray(vec3(-5,0,5.5f),x), p0, p1, 1.f, &t ) );
+	TEST( !intersect_ray_capsule( ray(vec3(-5,2,2),x), p0, p1, 1.f, &t ) );
+
+	// box rotated 45 degrees and moved along X-axis
+	const mat4 tm = translation( vec3(10,0,0) ) * rotation_z( radians(45.f) );
+	const mat4 invtm = inverse( tm );
+	TEST( intersect_ray_obb( ray(zero,x), invtm, vec3(-1), vec3(1), &t ) && fabsf(t-(10.f-sqrtf(2.f))) < 1e-4f );
+	TEST( !intersect_ray_obb( ray(vec3(0,1.5f,0),x), invtm, vec3(-1), vec3(1), &t ) );
+	TEST( intersect_ray_obb( ray(vec3(10,0,0),z), invtm, vec3(-1), vec3(1), &t ) && t == 0.f );
+
+	// ray parallel to a slab with origin on its face plane hits, just outside it misses, also in packets
+	const mat4 id = translation( zero );
+	TEST( intersect_ray_obb( ray(vec3(0,1,-5),z,-10.f,10.f), id, vec3(-1), vec3(1), &t ) && fabsf(t-4.f) < 1e-5f );
+	TEST( intersect_ray_obb( ray(vec3(0,1,0),z,-10.f,10.f), id, vec3(-1), vec3(1), &t ) && fabsf(t+1.f) < 1e-5f );
+	TEST( !intersect_ray_obb( ray(vec3(0,1e-40f,0),z,-10.f,10.f), id, vec3(-1), vec3(1,0,1), &t ) );
+	ray4 slabs;
+	slabs.set( 0, vec3(0,1,-5), z, -10.f, 10.f );
+	slabs.set( 1, vec3(0,1,0), z, -10.f, 10.f );
+	slabs.set( 2, vec3(0,1e-40f,0), z, -10.f, 10.f );
+	slabs.clear( 3 );
+	float slabt[4];
+	TEST( intersect_ray4_obb( slabs, id, vec3(-1), vec3(1,0,1), slabt ) == 0 );
+	TEST( intersect_ray4_obb( slabs, id, vec3(-1), vec3(1), slabt ) == 7 && fabsf(slabt[0]-4.f) < 1e-5f && fabsf(slabt[1]+1.f) < 1e-5f && fabsf(slabt[2]+1.f) < 1e-5f );
+
+	// packets give the same results as single rays
+	for ( size_t q = 0 ; q < 50 ; ++q )
+	{
+		ray4 packet;
+		vec3 o[4], d[4];
+		float tmin[4], tmax[4];
+		for ( size_t i = 0 ; i < 4 ; ++i )
+		{
+			o[i] = vec3( random_float()*10.f-5.f, random_float()*10.f-5.f, random_float()*10.f-5.f );
+			d[i] = vec3( random_float()*2.f-1.f, random_float()*2.f-1.f, random_float()*2.f-1.f );
+			if ( q%5 == 0 )
+				d[i] = vec3( 0, 0, random_float()-.5f );
+			tmin[i] = random_float();
+			tmax[i] = tmin[i] + random_float()*10.f;
+			packet.set( i, o[i], d[i], tmin[i], tmax[i] );
+		}
+		if ( q%7 == 0 )
+			packet.clear( 3 );
+
+		const vec3 c( random_float()*4.f-2.f, random_float()*4.f-2.f, random_float()*4.f-2.f );
+		const vec3 c2 = c + vec3( random_float()*4.f-2.f, random_float()*4.f-2.f, random_float()*4.f-2.f );
+		const float radius = random_float()*2.f;
+		const vec4 plane( normalize(c2-c), random_float()*2.f-1.f );
+		const mat4 boxtm = inverse( translation(c) * rotation_x(random_float()*6.f) * rotation_y(random_float()*6.f) );
+
+		float t4[4][4];
+		const int mask[4] = {
+			intersect_ray4_sphere( packet, c, radius, t4[0] ),
+			intersect_ray4_plane( packet, plane, t4[1] ),
+			intersect_ray4_capsule( packet, c, c2, radius, t4[2] ),
+			intersect_ray4_obb( packet, boxtm, vec3(-1), vec3(1), t4[3] ) };
+		for ( size_t i = 0 ; i < 4 ; ++i )
+		{
+			if ( q%7 == 0 && 3 == i )
+			{
+				TEST( 0 == (mask[0] & 8) && 0 == (mask[1] & 8) && 0 == (mask[2] & 8) && 0 == (mask[3] & 8) );
+				continue;
+			}
+			ray r( o[i], d[i], tmin[i], tmax[i] );
+			float t1[4];
+			const bool hit[4] = {
+				intersect_ray_sphere( r, c, radius, &t1[0] ),
+				intersect_ray_plane( r, plane, &t1[1] ),
+				intersect_ray_capsule( r, c, c2, radius, &t1[2] ),
+				intersect_ray_obb( r, boxtm, vec3(-1), vec3(1), &t1[3] ) };
+			for ( size_t k = 0 ; k < 4 ; ++k )
+			{
+				TEST( hit[k] == (0 != (mask[k] & (1<<i))) );
+				if ( hit[k] )
+					TEST( fabsf(t1[k]-t4[k][i]) <= 1e-4f*max(1.f,t1[k]) );
+			}
+
+			// capsule entry point is on the surface
+			if ( hit[2] && t1[2] > tmin[i] )
+			{
+				const vec3 p = r.at( t1[2] );
+				const vec3 ba = c2 - c;
+				const float h = clamp( dot(p-c,ba)/dot(ba,ba), 0.f, 1.f );
+				TEST( fabsf(length(p - (c + ba*h)) - radius) < 1e-3f );
+			}
+		}
+	}
+	return true;
+}
+
+bool test_loose_octree( char* testid )
+{
+	const size_t n = 300;
+	vec3 bmin[n], bmax[n];
+	loose_octree tree( vec3(-16,-16,-16), 32.f, 5 );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		// mostly small objects, some large, some outside the root
+		const float size = (i%10 == 0 ? random_float()*20.f : random_float()*2.f);
+		const float range = (i%17 == 0 ? 40.f : 30.f);
+		bmin[i] = vec3( random_float()*range-range*.5f, random_float()*range-range*.5f, random_float()*range-range*.5f );
+		bmax[i] = bmin[i] + vec3( size, random_float()*size, size*.5f );
+		tree.insert( i, bmin[i], bmax[i] );
+	}
+	TEST( tree.size() == n );
+
+	for ( size_t step = 0 ; step < 3 ; ++step )
+	{
+		// move some objects a little, some far, remove and reinsert some
+		for ( size_t i = 0 ; i < n ; ++i )
+		{
+			const vec3 move = (i%3 == 0 ? vec3(random_float()*10.f-5.f) : vec3(random_float()*.2f-.1f, 0.f, random_float()*.2f-.1f));
+			bmin[i] += move;
+			bmax[i] += move;
+			tree.update( i, bmin[i], bmax[i] );
+		}
+		tree.remove( step );
+		TEST( !tree.contains(step) && tree.size() == n-1 );
+
+		size_t found[n];
+		bool flags[n];
+		for ( size_t q = 0 ; q < 10 ; ++q )
+		{
+			// sphere query
+			const vec3 c( random_float()*30.f-15.f, random_float()*30.f-15.f, random_float()*30.f-15.f );
+			const float radius = random_float()*6.f;
+			size_t count = tree.query_sphere( c, radius, found, n );
+			memset( flags, 0, sizeof(flags) );
+			for ( size_t i = 0 ; i < count ; ++i )
+				flags[found[i]] = true;
+			size_t expected = 0;
+			for ( size_t i = 0 ; i < n ; ++i )
+			{
+				const vec3 d = c - clamp( c, bmin[i], bmax[i] );
+				const bool inside = (i != step && dot(d,d) <= radius*radius);
+				TEST( flags[i] == inside );
+				expected += inside;
+			}
+			TEST( count == expected );
+
+			// ray query
+			ray r( c, vec3(random_float()-.5f, random_float()-.5f, random_float()-.5f), 0.f, random_float()*50.f );
+			count = tree.query_ray( r, found, n );
+			memset( flags, 0, sizeof(flags) );
+			for ( size_t i = 0 ; i < count ; ++i )
+				flags[found[i]] = true;
+			for ( size_t i = 0 ; i < n ; ++i )
+				TEST( flags[i] == (i != step && intersect_ray_box(r, bmin[i], bmax[i], 0)) );
+
+			// frustum query
+			const frustum f( perspective_fov_rh(radians(60.f), 1.f, .5f, 20.f) * look_at_rh(c, vec3(0,0,0), vec3(0,1,0)) );
+			count = tree.query_frustum( f, found, 10 );
+			size_t visible = 0;
+			for ( size_t i = 0 ; i < n ; ++i )
+				visible += (i != step && intersect_frustum_box(f, bmin[i], bmax[i]));
+			TEST( count == visible );
+		}
+		tree.insert( step, bmin[step], bmax[step] );
+	}
+
+	// object moving over the cell border stays in its cell while inside the loose bounds
+	loose_octree small( vec3(0,0,0), 8.f, 3 );
+	small.insert( 0, vec3(1.5f), vec3(1.9f) );
+	size_t found = 0;
+	for ( float x = 1.5f ; x < 4.f ; x += .25f )
+	{
+		small.update( 0, vec3(x,1.5f,1.5f), vec3(x+.4f,1.9f,1.9f) );
+		TEST( small.query_sphere(vec3(x+.2f,1.7f,1.7f), .1f, &found, 1) == 1 && found == 0 );
+		TEST( small.query_sphere(vec3(x-.5f,1.7f,1.7f), .1f, &found, 1) == 0 );
+	}
+	return true;
+}
+
+bool test_morton( char* testid )
+{
+	// bits are interleaved X highest
+	TEST( morton_encode30(1,0,0) == 4 && morton_encode30(0,1,0) == 2 && morton_encode30(0,0,1) == 1 );
+	TEST( morton_encode30(1023,1023,1023) == 0x3FFFFFFFu );
+	TEST( morton_encode63(2097151,2097151,2097151) == 0x7FFFFFFFFFFFFFFFull );
+	TEST( morton_encode63(1023,0,5) == (unsigned long long)morton_encode30(1023,0,5) );
+
+	// batch codes match scalar quantization, also for the partial last group
+	const size_t n = 1000;
+	vec3 pts[n];
+	for ( size_t i = 0 ; i < n ; ++i )
+		pts[i] = vec3( random_float()*4.f-2.f, random_float()*4.f-2.f, random_float()*4.f-2.f );
+	unsigned int codes[n];
+	unsigned long long codes63[n];
+	morton_codes30( pts, n-3, vec3(-1.f), vec3(1.f), codes );
+	morton_codes63( pts, n-3, vec3(-1.f), vec3(1.f), codes63 );
+	for ( size_t i = 0 ; i < n-3 ; ++i )
+	{
+		const vec3 q = clamp( (pts[i] + vec3(1.f)) * .5f, vec3(0.f), vec3(1.f) );
+		TEST( codes[i] == morton_encode30( unsigned(q.x*1023.f), unsigned(q.y*1023.f), unsigned(q.z*1023.f) ) );
+		TEST( codes63[i] == morton_encode63( unsigned(q.x*2097151.f), unsigned(q.y*2097151.f), unsigned(q.z*2097151.f) ) );
+	}
+
+	// radix sort is ascending and stable
+	unsigned int keys[n], values[n], tempkeys[n], tempvalues[n];
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		keys[i] = (i%3 == 0 ? codes[i%(n-3)] : (unsigned int)(random_float()*1000.f) << 16);
+		values[i] = (unsigned int)i;
+	}
+	radix_sort( keys, values, n, tempkeys, tempvalues );
+	for ( size_t i = 1 ; i < n ; ++i )
+		TEST( keys[i-1] < keys[i] || (keys[i-1] == keys[i] && values[i-1] < values[i]) );
+	unsigned long long tempkeys63[n];
+	radix_sort( codes63, values, n-3, tempkeys63, tempvalues );
+	for ( size_t i = 1 ; i < n-3 ; ++i )
+		TEST( codes63[i-1] <= codes63[i] );
+
+	// linear bvh gives the same hits as brute force
+	const size_t ntri = 300;
+	vec3 verts[ntri*3];
+	for ( size_t i = 0 ; i < ntri ; ++i )
+	{
+		const vec3 c( random_float()*20.f-10.f, random_float()*20.f-10.f, random_float()*20.f-10.f );
+		for ( size_t k = 0 ; k < 3 ; ++k )
+			verts[i*3+k] = c + vec3( random_float()*2.f-1.f, random_float()*2.f-1.f, random_float()*2.f-1.f );
+	}
+	bvh tree;
+	tree.build_lbvh( verts, 0, ntri );
+	TEST( tree.size() == ntri );
+	for ( size_t q = 0 ; q < 200 ; ++q )
+	{
+		const vec3 o( random_float()*30.f-15.f, random_float()*30.f-15.f, random_float()*30.f-15.f );
+		const vec3 d = vec3( random_float()*20.f-10.f, random_float()*20.f-10.f, random_float()*20.f-10.f ) - o;
+		ray_hit hit1, hit2;
+		ray r1( o, d );
+		ray r2( o, d );
+		const bool found1 = intersect_ray_triangles( r1, RAY_CLOSEST_HIT, verts, 0, ntri, &hit1 );
+		const bool found2 = intersect_ray_bvh( r2, RAY_CLOSEST_HIT, tree, &hit2 );
+		TEST( found1 == found2 );
+		if ( found1 )
+			TEST( hit1.index == hit2.index && fabsf(hit1.t-hit2.t) <= 1e-5f*hit1.t );
+	}
+
+	// identical centroids are split in the middle
+	vec3 same[64*3];
+	for ( size_t i = 0 ; i < 64*3 ; ++i )
+		same[i] = vec3( float(i%3), float((i+1)%3), 0.f );
+	tree.build_lbvh( same, 0, 64 );
+	TEST( tree.block_count() == 16 );
+	return true;
+}
+
+bool test_intersect_stats( char* testid )
+{
+	vec3 verts[30*3];
+	for ( size_t i = 0 ; i < 30*3 ; ++i )
+		verts[i] = vec3( random_float()*10.f, random_float()*10.f, random_float()*10.f );
+	bvh tree;
+	tree.build( verts, 0, 30 );
+
+	intersect_stats& stats = thread_intersect_stats();
+	stats.clear();
+	const intersect_stats before = stats;
+	ray r( vec3(-1.f), vec3(1.f) );
+	intersect_ray_bvh( r, RAY_CLOSEST_HIT, tree, 0 );
+	intersect_ray_triangles( r, RAY_CLOSEST_HIT, verts, 0, 30, 0 );
+	intersect_stats query = stats;
+	query -= before;
+
+#ifdef SLMATH_STATS
+	TEST( query.queries == 2 );
+	TEST( query.node_visits >= 1 && query.box_tests >= bvh_node::SIZE );
+	TEST( query.triangle_tests >= 30 );
+
+	// any hit query counts only the boxes tested before the early out
+	const vec3 boxes[4*2] = {vec3(0.f),vec3(1.f), vec3(2.f),vec3(3.f), vec3(4.f),vec3(5.f), vec3(6.f),vec3(7.f)};
+	ray anyray( vec3(-1.f), vec3(1.f) );
+	const size_t boxtests = stats.box_tests;
+	TEST( intersect_ray_boxes(anyray, RAY_ANY_HIT, boxes, 4, 0) );
+	TEST( stats.box_tests - boxtests == 1 );
+#else
+	TEST( query.queries == 0 && query.node_visits == 0 && query.box_tests == 0 && query.triangle_tests == 0 && query.early_outs == 0 );
+#endif
+
+	intersect_stats total;
+	total.clear();
+	total += query;
+	total += query;
+	TEST( total.queries == query.queries*2 && total.triangle_tests == query.triangle_tests*2 );
+	return true;
+}
+
+bool test_kd_tree( char* testid )
+{
+	const size_t n = 2000;
+	vector_simd<vec3> pts;
+	pts.resize( n );
+	for ( size_t i = 0 ; i < n ; ++i )
+		pts[i] = vec3( random_float()*10.f, random_float()*10.f, random_float()*2.f );
+	pts[7] = pts[3];
+
+	kd_tree tree;
+	tree.build( pts.begin(), n );
+	TEST( tree.size() == n );
+
+	// nearest and radius queries match brute force
+	const size_t k = 5;
+	for ( size_t q = 0 ; q < 100 ; ++q )
+	{
+		const vec3 p( random_float()*12.f-1.f, random_float()*12.f-1.f, random_float()*4.f-1.f );
+		size_t out[k];
+		float dist[k];
+		TEST( tree.query_nearest( p, k, out, dist ) == k );
+		size_t closer = 0;
+		for ( size_t i = 0 ; i < n ; ++i )
+			if ( distance(pts[i],p) < dist[k-1] )
+				++closer;
+		TEST( closer < k );
+		for ( size_t i = 0 ; i < k ; ++i )
+		{
+			TEST( fabsf(distance(pts[out[i]],p) - dist[i]) < 1e-5f );
+			TEST( 0 == i || dist[i-1] <= dist[i] );
+		}
+
+		size_t found[n];
+		const size_t count = tree.query_radius( p, 1.f, found, n );
+		size_t expected = 0;
+		for ( size_t i = 0 ; i < n ; ++i )
+			if ( distance(pts[i],p) <= 1.f )
+				++expected;
+		TEST( count == expected );
+		for ( size_t i = 0 ; i < count ; ++i )
+			TEST( distance(pts[found[i]],p) <= 1.f );
+	}
+
+	// batch queries give the same results as single ones
+	const size_t nq = 50;
+	vec3 queries[nq];
+	for ( size_t i = 0 ; i < nq ; ++i )
+		queries[i] = vec3( random_float()*10.f, random_float()*10.f, random_float()*2.f );
+	size_t batchout[nq*k];
+	float batchdist[nq*k];
+	tree.query_nearest_batch( queries, 10, nq-10, k, batchout, batchdist );
+	size_t batchout2[nq*k];
+	tree.query_nearest_batch( queries, 10, nq-10, k, batchout2, 0 );
+	size_t radiusout[nq*16];
+	size_t radiuscount[nq];
+	tree.query_radius_batch( queries, 10, nq-10, .5f, 16, radiusout, radiuscount );
+	for ( size_t i = 10 ; i < nq ; ++i )
+	{
+		size_t out[k];
+		float dist[k];
+		tree.query_nearest( queries[i], k, out, dist );
+		for ( size_t j = 0 ; j < k ; ++j )
+			TEST( dist[j] == batchdist[i*k+j] && batchout[i*k+j] == batchout2[i*k+j] );
+		size_t out2[k];
+		TEST( tree.query_nearest( queries[i], k, out2, 0 ) == k && 0 == memcmp(out, out2, sizeof(out)) );
+		size_t found[16];
+		TEST( tree.query_radius( queries[i], .5f, found, 16 ) == radiuscount[i] );
+	}
+
+	// fewer points than requested
+	kd_tree small;
+	small.build( pts.begin(), 3 );
+	size_t out[k];
+	TEST( small.query_nearest( vec3(0.f), k, out, 0 ) == 3 );
+	small.build( pts.begin(), 0 );
+	TEST( small.query_nearest( vec3(0.f), k, out, 0 ) == 0 );
+	TEST( small.query_radius( vec3(0.f), 1.f, out, k ) == 0 );
+	return true;
+}
+
+bool test_gjk( char* testid )
+{
+	// spheres and capsules are points and segments with radius
+	const vec3 c0( 0.f );
+	const vec3 c1( 3.f, 4.f, 0.f );
+	gjk_result res;
+	TEST( gjk_distance( gjk_shape(gjk_support_point,&c0,1.f), gjk_shape(gjk_support_point,&c1,2.f), 0, &res ) );
+	TEST( fabsf(res.distance-2.f) < 1e-5f );
+	TEST( length(res.pointa - vec3(.6f,.8f,0.f)) < 1e-5f && length(res.pointb - vec3(1.8f,2.4f,0.f)) < 1e-5f );
+	TEST( length(res.normal - vec3(.6f,.8f,0.f)) < 1e-5f );
+
+	// radii overlap, penetration from the core distance
+	TEST( epa_penetration( gjk_shape(gjk_support_point,&c0,3.f), gjk_shape(gjk_support_point,&c1,3.f), 0, &res ) );
+	TEST( fabsf(res.distance+1.f) < 1e-5f );
+
+	// box against capsule above it
+	gjk_box box;
+	box.center = vec3( 0.f );
+	box.axis[0] = vec3( 1.f, 0.f, 0.f );
+	box.axis[1] = vec3( 0.f, 2.f, 0.f );
+	box.axis[2] = vec3( 0.f, 0.f, 3.f );
+	const vec3 seg[2] = { vec3(-5.f,4.f,1.f), vec3(5.f,4.f,1.f) };
+	const gjk_shape boxshape( gjk_support_box, &box );
+	gjk_simplex simplex;
+	TEST( gjk_distance( boxshape, gjk_shape(gjk_support_segment,seg,.5f), &simplex, &res ) );
+	TEST( fabsf(res.distance-1.5f) < 1e-4f );
+	TEST( fabsf(res.pointa.y-2.f) < 1e-4f && fabsf(res.pointb.y-3.5f) < 1e-4f );
+	TEST( length(res.normal - vec3(0.f,1.f,0.f)) < 1e-4f );
+
+	// warm start after a small movement converges faster
+	const size_t cold = res.iterations;
+	const vec3 seg2[2] = { vec3(-5.f,4.1f,1.1f), vec3(5.f,4.1f,1.1f) };
+	TEST( gjk_distance( boxshape, gjk_shape(gjk_support_segment,seg2,.5f), &simplex, &res ) );
+	TEST( fabsf(res.distance-1.6f) < 1e-4f );
+	TEST( res.iterations <= cold );
+
+	// point hull of box corners and random interior points, against a rotated box
+	float hx[27], hy[27], hz[27];
+	for ( size_t i = 0 ; i < 27 ; ++i )
+	{
+		const bool corner = (i < 8);
+		hx[i] = corner ? ((i&1) ? 1.f : -1.f) : random_float()*2.f-1.f;
+		hy[i] = corner ? ((i&2) ? 1.f : -1.f) : random_float()*2.f-1.f;
+		hz[i] = corner ? ((i&4) ? 1.f : -1.f) : random_float()*2.f-1.f;
+	}
+	gjk_point_hull hull;
+	hull.x = hx;
+	hull.y = hy;
+	hull.z = hz;
+	hull.n = 27;
+	TEST( gjk_support_point_hull( &hull, vec3(1.f,-1.f,1.f) ) == vec3(1.f,-1.f,1.f) );
+	gjk_box box2;
+	box2.center = vec3( 1.5f, 0.2f, 0.1f );
+	box2.axis[0] = vec3( 1.f, 0.f, 0.f );
+	box2.axis[1] = vec3( 0.f, 1.f, 0.f );
+	box2.axis[2] = vec3( 0.f, 0.f, 1.f );
+	const gjk_shape hullshape( gjk_support_point_hull, &hull );
+	TEST( !gjk_distance( hullshape, gjk_shape(gjk_support_box,&box2), 0, &res ) );
+	TEST( epa_penetration( hullshape, gjk_shape(gjk_support_box,&box2), 0, &res ) );
+	TEST( fabsf(res.distance+.5f) < 1e-3f );
+	TEST( length(res.normal - vec3(1.f,0.f,0.f)) < 1e-3f );
+	TEST( fabsf(res.pointa.x-1.f) < 1e-3f && fabsf(res.pointb.x-.5f) < 1e-3f );
+
+	// deep penetration of rotated boxes, moving B by the penetration separates them
+	box2.center = vec3( .3f, -.2f, .4f );
+	box2.axis[0] = vec3( .8f, .6f, 0.f );
+	box2.axis[1] = vec3( -.6f, .8f, 0.f );
+	box2.axis[2] = vec3( 0.f, 0.f, .5f );
+	TEST( epa_penetration( boxshape, gjk_shape(gjk_support_box,&box2), 0, &res ) );
+	TEST( res.distance < 0.f );
+	gjk_box moved = box2;
+	moved.center += res.normal * (-res.distance + 1e-3f);
+	TEST( gjk_distance( boxshape, gjk_shape(gjk_support_box,&moved), 0, &res ) && res.distance < 1e-2f );
+
+	// crossing capsules have a flat core difference, moving B along its normal separates them
+	const vec3 sega[2] = { vec3(-1.f,0.f,0.f), vec3(1.f,0.f,0.f) };
+	vec3 segb[2] = { vec3(0.f,-1.f,0.f), vec3(0.f,1.f,0.f) };
+	TEST( epa_penetration( gjk_shape(gjk_support_segment,sega,.5f), gjk_shape(gjk_support_segment,segb,.5f), 0, &res ) );
+	TEST( fabsf(res.distance+1.f) < 1e-4f && fabsf(fabsf(res.normal.z)-1.f) < 1e-4f );
+	for ( size_t i = 0 ; i < 2 ; ++i )
+		segb[i] += res.normal * (-res.distance + 1e-3f);
+	TEST( gjk_distance( gjk_shape(gjk_support_segment,sega,.5f), gjk_shape(gjk_support_segment,segb,.5f), 0, &res ) && res.distance < 1e-2f );
+
+	// sphere centered on capsule segment
+	vec3 center( .3f, 0.f, 0.f );
+	TEST( epa_penetration( gjk_shape(gjk_support_segment,sega,.5f), gjk_shape(gjk_support_point,&center,.25f), 0, &res ) );
+	TEST( fabsf(res.distance+.75f) < 1e-4f && fabsf(res.normal.x) < 1e-4f );
+	center += res.normal * (-res.distance + 1e-3f);
+	TEST( gjk_distance( gjk_shape(gjk_support_segment,sega,.5f), gjk_shape(gjk_support_point,&center,.25f), 0, &res ) && res.distance < 1e-2f );
+	return true;
+}
+
+bool test_affine( char* testid )
+{
+	TEST( sizeof(affine) == 48 );
+
+	for ( size_t k = 0 ; k < 20 ; ++k )
+	{
+		const quat qa( random_float()*6.f, normalize(vec3(random_float()-.5f, random_float()-.5f, random_float()+.1f)) );
+		const quat qb( random_float()*6.f, normalize(vec3(random_float()+.1f, random_float()-.5f, random_float()-.5f)) );
+		const vec3 ta( random_float()*10.f, random_float()*10.f, random_float()*10.f );
+		const vec3 tb( random_float()*10.f, random_float()*10.f, random_float()*10.f );
+		const mat4 ma = translation(ta) * mat4(qa) * scaling(vec3(1.f,2.f,.5f));
+		const mat4 mb = translation(tb) * mat4(qb);
+		const affine a( ma );
+		const affine b( qb, tb );
+		TEST( to_mat4(a) == ma );
+
+		// multiplication and composition with mat4 and quat match mat4 math
+		const mat4 mab = ma * mb;
+		const mat4 ab = to_mat4( a*b );
+		const mat4 ab2 = a*mb;
+		const mat4 ab3 = ma*b;
+		const mat4 ab4 = to_mat4( (a*qb) );
+		const mat4 mab4 = ma * mat4(qb);
+		for ( size_t i = 0 ; i < 4 ; ++i )
+		{
+			TEST( length(ab[i]-mab[i]) < 1e-4f );
+			TEST( length(ab2[i]-mab[i]) < 1e-4f );
+			TEST( length(ab3[i]-mab[i]) < 1e-4f );
+			TEST( length(ab4[i]-mab4[i]) < 1e-4f );
+		}
+
+		// points and directions
+		const vec3 p( random_float(), random_float(), random_float() );
+		TEST( length(transform_point(a,p) - (ma*vec4(p,1.f)).xyz()) < 1e-4f );
+		TEST( length(transform_direction(a,p) - (ma*vec4(p,0.f)).xyz()) < 1e-4f );
+		TEST( length((a*vec4(p,1.f)) - ma*vec4(p,1.f)) < 1e-4f );
+
+		// inverses
+		TEST( length(transform_point(inverse(a),transform_point(a,p)) - p) < 1e-4f );
+		TEST( length(transform_point(inverse_orthonormal(b),transform_point(b,p)) - p) < 1e-4f );
+		TEST( fabsf(det(a) - det(ma)) < 1e-4f );
+	}
+
+	affine id( 1.f );
+	id *= affine( quat(0.f,0.f,0.f,1.f) );
+	TEST( id == affine(1.f) );
+	return true;
+}
+
+bool test_mat3( char* testid )
+{
+	TEST( sizeof(mat3) == 48 );
+
+	for ( size_t k = 0 ; k < 20 ; ++k )
+	{
+		const quat q( random_float()*6.f, normalize(vec3(random_float()-.5f, random_float()-.5f, random_float()+.1f)) );
+		const vec3 s( random_float()+.5f, random_float()+.5f, random_float()+.5f );
+		const mat4 m4 = translation(vec3(1,2,3)) * mat4(q) * scaling(s);
+		const mat4 n4 = mat4(q) * mat4( random_float()*6.f, vec3(0,1,0) );
+		const mat3 m( m4 );
+		const mat3 n( n4 );
+		const vec3 v( random_float()-.5f, random_float()-.5f, random_float()-.5f );
+
+		// conversions and products match mat4
+		TEST( length((m*v) - (m4*vec4(v,0.f)).xyz()) < 1e-5f );
+		TEST( length((v*m) - (vec4(v,0.f)*m4).xyz()) < 1e-5f );
+		const mat3 mn = m * n;
+		const mat4 mn4 = m4 * n4;
+		for ( size_t i = 0 ; i < 3 ; ++i )
+			TEST( length(mn[i] - mat3(mn4)[i]) < 1e-5f );
+		const mat3 mq( q );
+		const mat4 q4( q );
+		const mat3 mq4( q4 );
+		for ( size_t i = 0 ; i < 3 ; ++i )
+			TEST( length(mq[i] - mq4[i]) < 1e-6f );
+		TEST( fabsf(det(m) - det(m4)) < 1e-4f );
+
+		// inverses and normal matrix
+		const mat3 im = inverse( m );
+		const mat3 id = m * im;
+		TEST( length(im*(m*v) - v) < 1e-5f );
+		for ( size_t i = 0 ; i < 3 ; ++i )
+			TEST( length(id[i] - mat3(1.f)[i]) < 1e-5f );
+		const mat3 nm = normal_matrix( m4 );
+		const mat4 nm4 = transpose( inverse(m4) );
+		for ( size_t i = 0 ; i < 3 ; ++i )
+			TEST( length(nm[i] - mat3(nm4)[i]) < 1e-4f );
+		// normal stays perpendicular to transformed tangent
+		const vec3 tangent = cross( v, vec3(0,0,1) );
+		TEST( fabsf(dot(m*tangent, nm*v)) < 1e-4f );
+
+		// padding stays zero
+		const mat3 sum = (mn + m) * 2.f - (-n);
+		TEST( sum.begin()[3] == 0.f && sum.begin()[7] == 0.f && sum.begin()[11] == 0.f );
+	}
+
+	TEST( transpose(mat3(vec3(1,2,3),vec3(4,5,6),vec3(7,8,9))) == mat3(vec3(1,4,7),vec3(2,5,8),vec3(3,6,9)) );
+	return true;
+}
+
+bool test_dualquat( char* testid )
+{
+	TEST( sizeof(dualquat) == 32 );
+
+	for ( size_t k = 0 ; k < 20 ; ++k )
+	{
+		const quat qa( random_float()*6.f, normalize(vec3(random_float()-.5f, random_float()-.5f, random_float()+.1f)) );
+		const quat qb( random_float()*6.f, normalize(vec3(random_float()+.1f, random_float()-.5f, random_float()-.5f)) );
+		const vec3 ta( random_float()*10.f, random_float()*10.f, random_float()*10.f );
+		const vec3 tb( random_float()*10.f, random_float()*10.f, random_float()*10.f );
+		const dualquat a( qa, ta );
+		const mat4 mb = translation(tb) * mat4(qb);
+		const dualquat b( mb );
+		const mat4 ma = to_mat4( a );
+		const vec3 p( random_float(), random_float(), random_float() );
+
+		// construction and transforms match mat4
+		TEST( length(translation(a) - ta) < 1e-4f );
+		TEST( length(transform_point(a,p) - (ma*vec4(p,1.f)).xyz()) < 1e-4f );
+		TEST( length(transform_point(b,p) - (mb*vec4(p,1.f)).xyz()) < 1e-4f );
+		TEST( length(transform_direction(a,p) - (ma*vec4(p,0.f)).xyz()) < 1e-4f );
+		TEST( length(transform_point(a*b,p) - (ma*mb*vec4(p,1.f)).xyz()) < 1e-3f );
+		TEST( length(transform_point(inverse(a),transform_point(a,p)) - p) < 1e-4f );
+
+		// blend of equal transforms is the transform itself, also when one is negated
+		const dualquat q2[2] = { a, a*-1.f };
+		const float w2[2] = { .3f, .7f };
+		TEST( length(transform_point(blend(q2,w2,2),p) - transform_point(a,p)) < 1e-4f );
+
+		// blend of rotations about the same axis and pivot stays rigid
+		const dualquat r0( quat(0.f,vec3(0,0,1)), vec3(0,0,0) );
+		const dualquat r1( quat(1.f,vec3(0,0,1)), vec3(0,0,0) );
+		const dualquat rq[2] = { r0, r1 };
+		const float rw[2] = { .5f, .5f };
+		const vec3 rp = transform_point( blend(rq,rw,2), vec3(1,0,0) );
+		TEST( fabsf(length(rp)-1.f) < 1e-5f );
+		TEST( fabsf(rp.y - sinf(.5f)) < 1e-5f );
+
+		// skinning kernel matches blend
+		const dualquat bones[3] = { a, b, dualquat(qb,ta) };
+		const unsigned int bi[8] = { 0,1,2,0, 2,0,0,0 };
+		const float bw[8] = { .25f,.25f,.5f,0.f, 1.f,0.f,0.f,0.f };
+		const vec3 pos[2] = { p, p*2.f };
+		const vec3 nrm[2] = { vec3(0,0,1), vec3(1,0,0) };
+		vec3 outpos[2];
+		vec3 outnrm[2];
+		skin_vertices( bones, pos, nrm, bi, bw, 2, outpos, outnrm );
+		const dualquat bq[3] = { bones[0], bones[1], bones[2] };
+		const dualquat b0 = blend( bq, bw, 3 );
+		TEST( length(outpos[0] - transform_point(b0,pos[0])) < 1e-4f );
+		TEST( length(outnrm[0] - transform_direction(b0,nrm[0])) < 1e-4f );
+		TEST( length(outpos[1] - transform_point(bones[2],pos[1])) < 1e-4f );
+		TEST( fabsf(length(outnrm[1])-1.f) < 1e-5f );
+	}
+	return true;
+}
+
+bool test_trs( char* testid )
+{
+	for ( size_t k = 0 ; k < 20 ; ++k )
+	{
+		const quat qa( random_float()*6.f, normalize(vec3(random_float()-.5f, random_float()-.5f, random_float()+.1f)) );
+		const quat qb( random_float()*6.f, normalize(vec3(random_float()+.1f, random_float()-.5f, random_float()-.5f)) );
+		const trs a( vec3(random_float()*10.f, random_float(), -3.f), qa, vec3(2.f,2.f,2.f) );
+		const trs b( vec3(1.f, random_float()*10.f, random_float()), qb, vec3(.5f,1.f,3.f) );
+		const mat4 ma = to_mat4( a );
+		const mat4 mb = to_mat4( b );
+		const vec3 p( random_float(), random_float(), random_float() );
+
+		// matches mat4 math
+		TEST( length(ma[3].xyz() - a.translation) < 1e-6f );
+		TEST( length(transform_point(a,p) - (ma*vec4(p,1.f)).xyz()) < 1e-4f );
+		TEST( length(transform_direction(b,p) - (mb*vec4(p,0.f)).xyz()) < 1e-4f );
+		TEST( length(rotate(qa,p) - (mat4(qa)*vec4(p,0.f)).xyz()) < 1e-5f );
+		const trs ab = a * b;
+		TEST( length(transform_point(ab,p) - (ma*mb*vec4(p,1.f)).xyz()) < 1e-3f );
+		TEST( length(transform_point(inverse(a),transform_point(a,p)) - p) < 1e-4f );
+
+		// batch conversion matches single
+		mat4 mm[2];
+		const trs x[2] = { a, b };
+		to_mat4( x, 2, mm );
+		for ( size_t i = 0 ; i < 4 ; ++i )
+			TEST( length(mm[0][i]-ma[i]) < 1e-5f && length(mm[1][i]-mb[i]) < 1e-5f );
+
+		// interpolation end points and shorter path
+		TEST( length(transform_point(mix(a,b,0.f),p) - transform_point(a,p)) < 1e-4f );
+		TEST( length(transform_point(mix(a,b,1.f),p) - transform_point(b,p)) < 1e-4f );
+		const trs bneg( b.translation, -b.rotation, b.scale );
+		const trs m0 = mix( a, b, .5f );
+		const trs m1 = mix( a, bneg, .5f );
+		TEST( length(transform_point(m0,p) - transform_point(m1,p)) < 1e-4f );
+
+		// hierarchy, exact since non-uniform scale is only at the leaf
+		const trs local[3] = { a, a, b };
+		const int parents[3] = { -1, 0, 1 };
+		trs world[3];
+		compose_hierarchy( local, parents, 3, world );
+		TEST( length(transform_point(world[2],p) - transform_point(a,transform_point(a,transform_point(b,p)))) < 1e-3f );
+	}
+	return true;
+}
+
+bool test_double_types( char* testid )
+{
+	TEST( sizeof(dvec3) == 24 && sizeof(dvec4) == 32 && sizeof(dmat4) == 128 && sizeof(dquat) == 32 );
+
+	// vectors
+	const dvec3 a( 1.0, 2.0, 3.0 );
+	const dvec3 b( -2.0, .5, 4.0 );
+	TEST( dot(a,b) == 11.0 );
+	TEST( cross(a,b) == dvec3(6.5,-10.0,4.5) );
+	TEST( fabs(length(normalize(b)) - 1.0) < 1e-15 );
+	TEST( dvec4(a,1.0) + dvec4(b,2.0) == dvec4(-1.0,2.5,7.0,3.0) );
+	TEST( (dvec4(a,1.0) * 2.0).xyz() == a*2.0 );
+	TEST( to_vec4(dvec4(a,1.0)) == vec4(1.f,2.f,3.f,1.f) );
+
+	for ( size_t k = 0 ; k < 20 ; ++k )
+	{
+		// matrices and quaternions match single precision versions
+		const quat qf( random_float()*6.f, normalize(vec3(random_float()-.5f, random_float()-.5f, random_float()+.1f)) );
+		const dquat q = normalize( dquat(qf) );
+		const mat4 mf = translation(vec3(1,2,3)) * mat4(qf);
+		const dmat4 m = translation(dvec3(1,2,3)) * dmat4(q);
+		const mat4 mc = to_mat4( m );
+		for ( size_t i = 0 ; i < 4 ; ++i )
+			TEST( length(mc[i]-mf[i]) < 1e-6f );
+		const dvec4 p( random_float(), random_float(), random_float(), 1.0 );
+		TEST( length(inverse(m)*(m*p) - p) < 1e-12 );
+		TEST( length((m*inverse(m))[2] - dvec4(0,0,1,0)) < 1e-12 );
+		TEST( fabs(det(m) - 1.0) < 1e-12 );
+		TEST( length(transpose(m)*p - p*m) < 1e-12 );
+		TEST( length(rotate(q,p.xyz()) - (dmat4(q)*dvec4(p.xyz(),0.0)).xyz()) < 1e-12 );
+		const dquat q2 = dquat( dmat4(q) );
+		TEST( fabs(fabs(dot(q2,q)) - 1.0) < 1e-12 );
+		TEST( fabs(norm(q*inverse(q)*q2) - 1.0) < 1e-12 );
+		const dquat half = slerp( q, q*dquat(.6,dvec3(0,0,1)), .5 );
+		TEST( fabs(dot(half, q*dquat(.3,dvec3(0,0,1))) - 1.0) < 1e-12 );
+	}
+
+	// camera-relative conversion keeps float precision far from origin
+	const dvec3 camera( 6.4e6, -1.2e7, 3.3e6 );
+	dvec3 points[7];
+	for ( size_t i = 0 ; i < 7 ; ++i )
+		points[i] = camera + dvec3( i*.001, -(double)i, i*.25 );
+	vec3 rel[7];
+	camera_relative( points, 7, camera, rel );
+	for ( size_t i = 0 ; i < 7 ; ++i )
+		TEST( length(rel[i] - vec3(i*.001f, -(float)i, i*.25f)) < 1e-6f );
+
+	const dmat4 world = translation(points[3]) * dmat4(dquat(.5, dvec3(0,0,1)));
+	const mat4 rm = camera_relative( world, camera );
+	const vec4 rp = rm * vec4( 0.f, 0.f, 0.f, 1.f );
+	TEST( length(rp.xyz() - rel[3]) < 1e-6f );
+	TEST( rm[0].w == 0.f && rm[3].w == 1.f );
+	return true;
+}
+
+bool test_half( char* testid )
+{
+	TEST( sizeof(vec2h) == 4 && sizeof(vec4h) == 8 );
+
+	// known values, rounding and special cases
+	TEST( float_to_half(1.f) == 0x3C00 );
+	TEST( float_to_half(-2.f) == 0xC000 );
+	TEST( float_to_half(0.f) == 0x0000 && float_to_half(-0.f) == 0x8000 );
+	TEST( float_to_half(65504.f) == 0x7BFF );
+	TEST( float_to_half(65520.f) == 0x7C00 );
+	TEST( float_to_half(1e10f) == 0x7C00 && float_to_half(-1e10f) == 0xFC00 );
+	TEST( float_to_half(5.9604645e-8f) == 0x0001 );
+	TEST( float_to_half(1e-10f) == 0x0000 );
+	TEST( float_to_half(1.f + 1.f/2048.f) == 0x3C00 ); // tie rounds to even
+	TEST( float_to_half(1.f + 3.f/2048.f) == 0x3C02 );
+	const int inan = 0x7FC00000;
+	float fnan;
+	memcpy( &fnan, &inan, sizeof(fnan) );
+	TEST( (float_to_half(fnan) & 0x7FFF) > 0x7C00 );
+	TEST( half_to_float(0x3555) == 0.333251953125f );
+	TEST( half_to_float(0x0001) == 5.9604645e-8f );
+	TEST( half_to_float(0x7C00) > FLT_MAX );
+
+	// every non-NaN half converts to float and back exactly
+	bool roundtrip = true;
+	for ( unsigned int h = 0 ; h < 0x10000 ; ++h )
+	{
+		if ( (h & 0x7C00) == 0x7C00 && (h & 0x3FF) != 0 )
+			continue;
+		if ( float_to_half(half_to_float((unsigned short)h)) != h )
+			roundtrip = false;
+	}
+	TEST( roundtrip );
+
+	// batch conversion matches scalar conversion, including tails
+	float in[19];
+	unsigned short h[19];
+	float out[19];
+	for ( size_t i = 0 ; i < 19 ; ++i )
+		in[i] = (random_float()-.5f) * 1000.f;
+	float_to_half( in, 19, h );
+	half_to_float( h, 19, out );
+	for ( size_t i = 0 ; i < 19 ; ++i )
+	{
+		TEST( h[i] == float_to_half(in[i]) );
+		TEST( out[i] == half_to_float(h[i]) );
+		TEST( fabsf(out[i]-in[i]) <= fabsf(in[i])*(1.f/2048.f) );
+	}
+
+	// vectors
+	const vec4 v[3] = { vec4(0.f,.5f,-1.f,2.f), vec4(.25f,3.f,-4.f,1.f), vec4(1.f,1.f,1.f,1.f) };
+	vec4h vh[3];
+	vec4 v2[3];
+	to_half( v, 3, vh );
+	to_float( vh, 3, v2 );
+	for ( size_t i = 0 ; i < 3 ; ++i )
+	{
+		TEST( v2[i] == v[i] );
+		TEST( vec4h(v[i]).to_vec4() == v[i] );
+	}
+	const vec2 t[2] = { vec2(.125f,-8.f), vec2(100.f,.75f) };
+	vec2h th[2];
+	vec2 t2[2];
+	to_half( t, 2, th );
+	to_float( th, 2, t2 );
+	TEST( t2[0] == t[0] && t2[1] == t[1] && vec2h(t[1]).to_vec2() == t[1] );
+	return true;
+}
+
+bool test_quat_pack( char* testid )
+{
+	TEST( sizeof(quat48) == 6 );
+
+	// identity and axis rotations, q and -q pack the same
+	TEST( rotation_error(unpack_quat32(pack_quat32(quat(0,0,0,1))),quat(0,0,0,1)) < 1e-5f );
+	TEST( rotation_error(unpack_quat48(pack_quat48(quat(1,0,0,0))),quat(1,0,0,0)) < 1e-5f );
+	const quat qa( .3f, vec3(0,1,0) );
+	TEST( pack_quat32(qa) == pack_quat32(-qa) );
+	const quat48 pa = pack_quat48( qa );
+	const quat48 pb = pack_quat48( -qa );
+	TEST( pa.v[0] == pb.v[0] && pa.v[1] == pb.v[1] && pa.v[2] == pb.v[2] );
+	TEST( rotation_error(qa,-qa) == 0.f );
+	TEST( fabsf(rotation_error(quat(0,0,0,1),qa)-.3f) < 1e-4f );
+
+	// round trip error stays within documented bounds, batch matches single, including tails
+	const size_t n = 1003;
+	static quat q[n];
+	for ( size_t i = 0 ; i < n ; ++i )
+		q[i] = normalize( quat(random_float()-.5f, random_float()-.5f, random_float()-.5f, random_float()-.5f) );
+	static unsigned int p32[n];
+	static quat48 p48[n];
+	static quat out[n];
+	float maxerr32 = -1.f;
+	float maxerr48 = -1.f;
+	pack_quat32( q, n, p32, &maxerr32 );
+	pack_quat48( q, n, p48, &maxerr48 );
+	TEST( maxerr32 > 0.f && maxerr32 < .0045f );
+	TEST( maxerr48 > 0.f && maxerr48 < .00014f );
+
+	bool same = true;
+	float err32 = 0.f;
+	unpack_quat32( p32, n, out );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		same = same && p32[i] == pack_quat32(q[i]);
+		same = same && out[i].x == unpack_quat32(p32[i]).x && out[i].w == unpack_quat32(p32[i]).w;
+		err32 = max( err32, rotation_error(q[i],out[i]) );
+	}
+	TEST( same );
+	TEST( err32 == maxerr32 );
+
+	float err48 = 0.f;
+	unpack_quat48( p48, n, out );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const quat48 s = pack_quat48( q[i] );
+		same = same && s.v[0] == p48[i].v[0] && s.v[1] == p48[i].v[1] && s.v[2] == p48[i].v[2];
+		err48 = max( err48, rotation_error(q[i],out[i]) );
+	}
+	TEST( same );
+	TEST( err48 == maxerr48 );
+	return true;
+}
+
+static float angle_error( const vec3& a, const vec3& b )
+{
+	const vec3 d = a - b;
+	const float h = .5f * length(d);
+	return 2.f * asinf( h < 1.f ? h : 1.f );
+}
+
+bool test_octahedral( char* testid )
+{
+	TEST( sizeof(oct24) == 3 );
+
+	// axis vectors are exact
+	const vec3 axes[6] = {vec3(1,0,0), vec3(-1,0,0), vec3(0,1,0), vec3(0,-1,0), vec3(0,0,1), vec3(0,0,-1)};
+	for ( size_t i = 0 ; i < 6 ; ++i )
+	{
+		TEST( angle_error(unpack_oct16(pack_oct16(axes[i])),axes[i]) < 1e-6f );
+		TEST( angle_error(unpack_oct24(pack_oct24(axes[i])),axes[i]) < 1e-6f );
+		TEST( angle_error(unpack_oct32(pack_oct32_precise(axes[i])),axes[i]) < 1e-6f );
+	}
+
+	// round trip error within documented bounds, precise never worse, batch matches single, including tails
+	const size_t n = 1003;
+	static vec3 v[n];
+	static unsigned short p16[n];
+	static oct24 p24[n];
+	static unsigned int p32[n];
+	static unsigned int p32p[n];
+	static vec3 out[n];
+	for ( size_t i = 0 ; i < n ; ++i )
+		v[i] = normalize( vec3(random_float()-.5f, random_float()-.5f, random_float()-.5f) );
+	pack_oct16( v, n, p16, false );
+	pack_oct24( v, n, p24, false );
+	pack_oct32( v, n, p32, false );
+	pack_oct32( v, n, p32p, true );
+
+	bool same = true;
+	bool precise = true;
+	float err16 = 0.f;
+	float err24 = 0.f;
+	float err32 = 0.f;
+	float err32p = 0.f;
+	unpack_oct16( p16, n, out );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		same = same && p16[i] == pack_oct16(v[i]) && out[i] == unpack_oct16(p16[i]);
+		err16 = max( err16, angle_error(v[i],out[i]) );
+		const vec3 d = v[i] - unpack_oct16(pack_oct16_precise(v[i]));
+		precise = precise && dot(d,d) <= dot(v[i]-out[i],v[i]-out[i]);
+	}
+	unpack_oct24( p24, n, out );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		const oct24 s = pack_oct24( v[i] );
+		same = same && s.v[0] == p24[i].v[0] && s.v[1] == p24[i].v[1] && s.v[2] == p24[i].v[2];
+		err24 = max( err24, angle_error(v[i],out[i]) );
+	}
+	unpack_oct32( p32, n, out );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		same = same && p32[i] == pack_oct32(v[i]) && p32p[i] == pack_oct32_precise(v[i]);
+		err32 = max( err32, angle_error(v[i],out[i]) );
+		err32p = max( err32p, angle_error(v[i],unpack_oct32(p32p[i])) );
+	}
+	TEST( same );
+	TEST( precise );
+	TEST( err16 < .017f );
+	TEST( err24 < .0011f );
+	TEST( err32 < .000065f );
+	TEST( err32p < .000045f );
+	return true;
+}
+
+bool test_fixed( char* testid )
+{
+	// arithmetic and rounding
+	TEST( fixed(1).raw == fixed::ONE && fixed(-2).raw == -2*fixed::ONE );
+	TEST( fixed(1.5f) * fixed(2) == fixed(3) );
+	TEST( fixed(3) / fixed(2) == fixed(1.5f) );
+	TEST( (fixed::from_raw(1) * fixed::from_raw(fixed::ONE/2)).raw == 1 );
+	TEST( (fixed::from_raw(-1) * fixed::from_raw(fixed::ONE/2)).raw == 0 );
+	TEST( (fixed(-1) / fixed(3)).raw == -21845 );
+	TEST( abs(fixed(-2)) == fixed(2) && min(fixed(1),fixed(2)) == fixed(1) && max(fixed(1),fixed(2)) == fixed(2) );
+
+	// sqrt, sin and cos
+	TEST( sqrt(fixed(4)) == fixed(2) );
+	TEST( sqrt(fixed(2)).raw == 92681 );
+	TEST( sin(fixed(0)).raw == 0 && cos(fixed(0)) == fixed(1) );
+	TEST( sin(fixed::from_raw(fixed::HALF_PI)) == fixed(1) );
+	float sinerr = 0.f;
+	float sqrterr = 0.f;
+	for ( int r = -800000 ; r < 800000 ; r += 97 )
+	{
+		const fixed a = fixed::from_raw( r );
+		sinerr = max( sinerr, fabsf(to_float(sin(a)) - sinf(to_float(a))) );
+		sinerr = max( sinerr, fabsf(to_float(cos(a)) - cosf(to_float(a))) );
+		if ( r >= 0 )
+			sqrterr = max( sqrterr, fabsf(to_float(sqrt(a)) - sqrtf(to_float(a))) );
+	}
+	TEST( sinerr < 3e-5f );
+	TEST( sqrterr < 2e-5f );
+
+	// large angles over the whole range, compared in double since float can't hold the angle exactly
+	float wideerr = 0.f;
+	for ( long long r = -2147483647LL-1 ; r <= 2147483647LL ; r += 1000003 )
+	{
+		const fixed a = fixed::from_raw( int(r) );
+		const double x = double(r) / fixed::ONE;
+		wideerr = max( wideerr, float(::fabs(to_float(sin(a)) - ::sin(x))) );
+		wideerr = max( wideerr, float(::fabs(to_float(cos(a)) - ::cos(x))) );
+	}
+	const fixed amax = fixed::from_raw( 2147483647 );
+	wideerr = max( wideerr, float(::fabs(to_float(cos(amax)) - ::cos(2147483647.0/fixed::ONE))) );
+	TEST( wideerr < 3e-5f );
+
+	// vectors
+	const fixed_vec3 a( fixed(1), fixed(2), fixed(3) );
+	const fixed_vec3 b( fixed(-2), fixed(1), fixed(1) );
+	TEST( dot(a,b) == fixed(3) );
+	TEST( cross(a,b) == fixed_vec3(fixed(-1),fixed(-7),fixed(5)) );
+	TEST( length(fixed_vec3(fixed(2),fixed(3),fixed(6))) == fixed(7) );
+	TEST( length(fixed_vec3(fixed(20000),fixed(20000),fixed(0))).raw > 0 );
+	TEST( fabsf(to_float(length(normalize(a))) - 1.f) < 1e-4f );
+	TEST( length(fixed_vec2(fixed(3),fixed(4))) == fixed(5) );
+	TEST( to_vec3(a) == vec3(1,2,3) && to_vec2(fixed_vec2(vec2(.5f,-.25f))) == vec2(.5f,-.25f) );
+
+	// rotations match float
+	const vec3 axis = normalize( vec3(1,2,3) );
+	const fixed_quat fq( fixed(1.2f), fixed_vec3(axis) );
+	const quat q( 1.2f, axis );
+	const vec3 p( 3.f, -1.f, 2.f );
+	TEST( rotation_error(to_quat(fq),q) < 1e-3f );
+	TEST( length(to_vec3(rotate(fq,fixed_vec3(p))) - rotate(q,p)) < 1e-3f );
+	TEST( length(to_vec3(rotate(fq*conjugate(fq),fixed_vec3(p))) - p) < 1e-3f );
+	const fixed_quat fq2( fixed(-.4f), fixed_vec3(fixed(0),fixed(1),fixed(0)) );
+	TEST( rotation_error(to_quat(fq*fq2),q*quat(-.4f,vec3(0,1,0))) < 1e-3f );
+
+	// matrices match float
+	const fixed_vec3 t( fixed(5), fixed(-6), fixed(7) );
+	const fixed_mat4 m( fq, t );
+	const mat4 fm = translation( to_vec3(t) ) * mat4( q );
+	TEST( err(to_mat4(m),fm) < 1e-3f );
+	TEST( length(to_vec3(transform_point(m,fixed_vec3(p))) - (fm*vec4(p,1.f)).xyz()) < 1e-3f );
+	TEST( length(to_vec3(transform_direction(m,fixed_vec3(p))) - rotate(q,p)) < 1e-3f );
+	TEST( translation(t) * fixed_mat4(fq,fixed_vec3(fixed(0),fixed(0),fixed(0))) == m );
+	TEST( transpose(transpose(m)) == m && fixed_mat4(fixed(1)) * m == m );
+	fixed_vec3 pts[3] = {fixed_vec3(p), a, b};
+	transform_points( m, pts, 3, pts );
+	TEST( pts[1] == transform_point(m,a) && pts[2] == transform_point(m,b) );
+
+	// simulation steps give the same bits on every machine
+	const fixed_quat dq( fixed::from_raw(655), normalize(a) );
+	const fixed_vec3 vel( fixed::from_raw(32768), fixed::from_raw(-16384), fixed::from_raw(8192) );
+	const fixed dt = fixed::from_raw( 1049 );
+	fixed_quat sq( fixed(0), fixed(0), fixed(0), fixed(1) );
+	fixed_vec3 sp( fixed(10), fixed(0), fixed(0) );
+	for ( int i = 0 ; i < 1000 ; ++i )
+	{
+		sq = normalize( sq * dq );
+		sp += rotate( sq, vel ) * dt;
+	}
+	TEST( sq.x.raw == -16761 && sq.y.raw == -33767 && sq.z.raw == -50562 && sq.w.raw == 17812 );
+	TEST( sp.x.raw == 708587 && sp.y.raw == 144283 && sp.z.raw == 16065 );
+	return true;
+}
+
+bool test_vec_expr( char* testid )
+{
+	// single vectors give the same results as the vector operators
+	const vec3 a( 1.f, 2.f, 3.f );
+	const vec3 b( -.5f, .25f, 4.f );
+	const vec3 c( 2.f, -1.f, .5f );
+	const float s = 1.5f;
+	const vec3 r = expr(a)*s + b - c;
+	TEST( r == a*s + b - c );
+	TEST( vec3(-expr(a)/2.f + s*expr(b)*c) == -a/2.f + s*b*c );
+	TEST( vec3(a - expr(b)/c) == a - b/c );
+	const vec2 r2 = expr(vec2(1,2)) * vec2(3,4) - vec2(1,1);
+	TEST( r2 == vec2(2,7) );
+	const vec4 r4 = (expr(vec4(1,2,3,4)) + vec4(1)) * 2.f;
+	TEST( r4 == vec4(4,6,8,10) );
+
+	// arrays evaluate in one pass, including in-place and vector_simd
+	const size_t n = 37;
+	vector_simd<vec3> pos;
+	vector_simd<vec3> vel;
+	vector_simd<vec3> out;
+	vec4 p4[n];
+	vec4 o4[n];
+	pos.resize( n );
+	vel.resize( n );
+	out.resize( n );
+	for ( size_t i = 0 ; i < n ; ++i )
+	{
+		pos[i] = vec3( random_float(), random_float(), random_float() );
+		vel[i] = vec3( random_float(), random_float(), random_float() ) - vec3(.5f);
+		p4[i] = vec4( pos[i], 1.f );
+	}
+	eval( expr(pos)*2.f - expr(vel)*s + a, &out );
+	bool same = true;
+	for ( size_t i = 0 ; i < n ; ++i )
+		same = same && out[i] == pos[i]*2.f - vel[i]*s + a;
+	TEST( same );
+
+	eval( expr(out) + expr(vel)*.1f, out.begin(), n );
+	for ( size_t i = 0 ; i < n ; ++i )
+		same = same && out[i] == (pos[i]*2.f - vel[i]*s + a) + vel[i]*.1f;
+	TEST( same );
+
+	eval( -expr(p4) / vec4(2.f), o4, n );
+	for ( size_t i = 0 ; i < n ; ++i )
+		same = same && o4[i] == -p4[i] / vec4(2.f);
+	TEST( same );
+	return true;
+}
+
 int main()
 {
 	TEST( test_vec2(testid) );
@@ -194,6 +1837,30 @@ int main()
 	TEST( test_quat(testid) );
 	TEST( test_rotations(testid) );
 	TEST( test_vector_sse(testid) );
+	TEST( test_intersect(testid) );
+	TEST( test_frustum(testid) );
+	TEST( test_ray_query(testid) );
+	TEST( test_spatial_hash(testid) );
+	TEST( test_sweep_and_prune(testid) );
+	TEST( test_bvh(testid) );
+	TEST( test_closest_point(testid) );
+	TEST( test_voxelize(testid) );
+	TEST( test_ray_primitives(testid) );
+	TEST( test_loose_octree(testid) );
+	TEST( test_morton(testid) );
+	TEST( test_intersect_stats(testid) );
+	TEST( test_kd_tree(testid) );
+	TEST( test_gjk(testid) );
+	TEST( test_affine(testid) );
+	TEST( test_mat3(testid) );
+	TEST( test_dualquat(testid) );
+	TEST( test_trs(testid) );
+	TEST( test_double_types(testid) );
+	TEST( test_half(testid) );
+	TEST( test_quat_pack(testid) );
+	TEST( test_octahedral(testid) );
+	TEST( test_fixed(testid) );
+	TEST( test_vec_expr(testid) );
 
     printf("Tests OK\n");
     return 0;